@@ -12,6 +12,7 @@
 
 #include "User.hpp"
 #include "Flight.hpp"
+#include "FlightRegistry.hpp"
 #include "Reservation.hpp"
 #include "Aircraft.hpp"
 #include "Maintenance.hpp"
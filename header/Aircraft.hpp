@@ -15,6 +15,7 @@
 #include <memory>
 #include <map>
 #include "Maintenance.hpp"
+#include "CabinLayout.hpp"
 #include "json.hpp"
 
 #define PATH_OF_AIR_CRAFT_DATA_BASE "data_base/aircraftDataBase.json"
@@ -32,6 +33,7 @@ private:
     string aircraftType;
     int capacity;
     shared_ptr<Maintenance> maintenance;
+    CabinLayout cabinLayout;        // Empty when the aircraft uses the standard layout
 
 public:
     /*
@@ -42,17 +44,17 @@ public:
     /*
     * Constructor: Initializes an aircraft object with specific values.
     */
-    Aircraft(const string& id, const string& type, int cap, shared_ptr<Maintenance> maint);
+    Aircraft(string id, string type, int cap, shared_ptr<Maintenance> maint);
 
     /*
     * Description: Gets the aircraft ID.
     */
-    string getAircraftID(void) const;
+    const string& getAircraftID(void) const;
 
     /*
     * Description: Gets the aircraft type.
     */
-    string getAircraftType(void) const;
+    const string& getAircraftType(void) const;
 
     /*
     * Description: Gets the capacity of the aircraft.
@@ -62,7 +64,12 @@ public:
     /*
     * Description: Returns the associated Maintenance object.
     */
-    shared_ptr<Maintenance> getMaintenance(void) const;
+    const shared_ptr<Maintenance>& getMaintenance(void) const;
+
+    /*
+    * Description: Returns the cabin layout (empty if none was configured).
+    */
+    const CabinLayout& getCabinLayout(void) const;
 
     /*
     * Description: Sets the aircraft ID.
@@ -84,6 +91,23 @@ public:
     */
     void setMaintenance(shared_ptr<Maintenance> maint);
 
+    /*
+    * Description: Sets the cabin layout of the aircraft.
+    */
+    void setCabinLayout(CabinLayout layout);
+
+    /*
+    * Description: Finds the cabin layout of an aircraft type in the aircraft data file.
+    * Returns     : True if an aircraft of that type has a configured layout.
+    */
+    static bool findCabinLayout(const string& aircraftType, CabinLayout& layout);
+
+    /*
+    * Description: Finds the cabin layout of an aircraft type in records already loaded.
+    */
+    static bool findCabinLayout(const map<string, Aircraft>& records, const string& aircraftType,
+                                CabinLayout& layout);
+
     /*
     * Description: Displays the aircraft's information in human-readable format.
     */
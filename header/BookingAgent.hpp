@@ -11,6 +11,7 @@
 
 #include "User.hpp"
 #include "Flight.hpp"
+#include "FlightRegistry.hpp"
 #include "Reservation.hpp"
 #include "Payment.hpp"
 #include "json.hpp"
@@ -21,6 +22,19 @@
 
 using namespace std;
 
+/* Largest party a single group booking accepts */
+#define MAX_GROUP_SIZE 500
+
+/******************************************************************************************
+* STRUCT NAME    : GroupBookingLeg
+* DESCRIPTION    : One flight of a group booking and the fare bucket the party flies in.
+******************************************************************************************/
+struct GroupBookingLeg
+{
+    string flightNumber;
+    string fareClass;
+};
+
 /******************************************************************************************
 * CLASS NAME     : BookingAgent
 * DESCRIPTION    : Inherits from User. Manages booking operations, check-ins, payments,
@@ -34,6 +48,11 @@ public:
     */
     BookingAgent(string username, string password);
 
+    /*
+    * Constructor: Same, starting from reservations already loaded from the main file.
+    */
+    BookingAgent(string username, string password, vector<shared_ptr<Reservation>> loaded);
+
     /*
     * Description: Displays the booking agent menu for operations.
     */
@@ -49,6 +68,24 @@ public:
     */
     void bookFlight(void);
 
+    /*
+    * Description: Books a party of passengers on one or more flights in one go.
+    */
+    void bookGroup(void);
+
+    /*
+    * Description: Takes fare inventory and seats for `passengers` travellers on every
+    *              leg and builds their reservations, unsaved. Either everything is taken
+    *              or nothing is, and false is returned with the reason printed.
+    */
+    bool reserveGroup(const vector<GroupBookingLeg>& legs, int passengers,
+                      vector<shared_ptr<Reservation>>& group);
+
+    /*
+    * Description: Gives back the inventory and seats of a group that was not saved.
+    */
+    static void releaseGroup(const vector<shared_ptr<Reservation>>& group);
+
     /*
     * Description: Displays all reservations made by the user.
     */
@@ -79,11 +116,6 @@ private:
     * Description: Stores reservations associated with the booking agent.
     */
     vector<shared_ptr<Reservation>> reservations;
-
-    /*
-    * Description: Generates a random reservation ID.
-    */
-    string generateRandomReservationID(void);
 };
 
 /******************************************************************************************
@@ -0,0 +1,106 @@
+/******************************************************************************************
+* MODULE NAME    : Cabin Layout Module
+* FILE           : CabinLayout.hpp
+* DESCRIPTION    : Declares the CabinLayout class, which describes the rows, seat letters,
+*                  aisles and cabin classes of an aircraft and maps seat labels such as
+*                  "14A" to bit positions.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "json.hpp"
+
+/* Widest row pattern, aisles included; one row must fit in a 64-bit mask */
+#define MAX_ROW_COLUMNS 64
+
+/* Seat pattern of the default all-economy layout; '-' marks an aisle */
+#define STANDARD_ROW_PATTERN "ABC-DEF"
+
+/******************************************************************************************
+* STRUCT NAME    : CabinSection
+* DESCRIPTION    : A run of identical rows in one cabin class.
+******************************************************************************************/
+struct CabinSection {
+    std::string cabinClass;   // e.g. "Business", "Economy"
+    int         rows;
+    std::string pattern;      // Seat letters left to right, '-' for an aisle
+};
+
+/******************************************************************************************
+* CLASS NAME     : CabinLayout
+* DESCRIPTION    : Every row is addressed as a 64-bit mask in which bit i is the i-th
+*                  column of the row pattern. Aisle columns are never set in a row's seat
+*                  mask, so a run of adjacent free bits never crosses an aisle.
+******************************************************************************************/
+class CabinLayout {
+public:
+    /*
+    * Description: Builds an empty layout.
+    */
+    CabinLayout(void);
+
+    /*
+    * Description: Returns an all-economy layout of STANDARD_ROW_PATTERN rows holding
+    *              exactly the given number of seats (the last row may be partial).
+    */
+    static CabinLayout standard(int seats);
+
+    /*
+    * Description: Parses "Class:ROWS:PATTERN,..." (e.g. "Business:4:AB-CD,Economy:30:ABC-DEF").
+    * Returns     : false, leaving layout untouched, if the text is malformed.
+    */
+    static bool parse(const std::string& text, CabinLayout& layout);
+
+    /*
+    * Description: Appends a section; returns false if its pattern or row count is invalid.
+    */
+    bool addSection(const CabinSection& section);
+
+    /*
+    * Description: Keeps only the first `seats` seats (row by row), so a flight sold with
+    *              fewer seats than the aircraft holds uses the front of the cabin.
+    */
+    void limitSeats(int seats);
+
+    /*
+    * Description: Parses a seat label ("14A") or a legacy seat ordinal ("14") into a
+    *              zero-based row and column.
+    * Returns     : false if the seat does not exist in this layout.
+    */
+    bool parseSeat(const std::string& text, int& row, int& column) const;
+
+    /*
+    * Description: Returns the label ("14A") of a seat.
+    */
+    std::string seatLabel(int row, int column) const;
+
+    // Layout queries
+    int  rowCount(void) const;
+    int  seatCount(void) const;
+    bool empty(void) const;
+    uint64_t seatMask(int row) const;      // Bits of the seats that exist in the row
+    uint64_t windowMask(int row) const;    // Bits of the window seats of the row
+    const std::string& cabinClassOf(int row) const;
+    const std::vector<CabinSection>& getSections(void) const;
+
+    /*
+    * Description: Converts the layout to and from its JSON array form.
+    */
+    nlohmann::json toJson(void) const;
+    static bool fromJson(const nlohmann::json& j, CabinLayout& layout);
+
+private:
+    std::vector<CabinSection> sections;
+    std::vector<int>          sectionOfRow;
+    std::vector<uint64_t>     seatMasks;
+    std::vector<uint64_t>     windowMasks;
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
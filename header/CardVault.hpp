@@ -0,0 +1,78 @@
+/******************************************************************************************
+* MODULE NAME    : Card Vault Module
+* FILE           : CardVault.hpp
+* DESCRIPTION    : Declares the CardVault class, which keeps saved payment cards encrypted
+*                  at rest and indexed in memory by username.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/* Append-only log of encrypted card records, one JSON object per line */
+#define PATH_OF_CARD_VAULT_DATA_BASE "data_base/card_vault.log"
+
+/* 256-bit vault key (hex); created on first use unless CARD_VAULT_KEY_ENV is set */
+#define PATH_OF_CARD_VAULT_KEY "data_base/card_vault.key"
+
+/* Environment variable that, when set, supplies the vault key instead of the key file */
+#define CARD_VAULT_KEY_ENV "CARD_VAULT_KEY"
+
+/* Format of the sealed records (3: ChaCha20-Poly1305); older ones are resealed on load */
+#define CARD_VAULT_RECORD_VERSION 3
+
+/******************************************************************************************
+* CLASS NAME     : CardVault
+* DESCRIPTION    : Each card is stored as one ChaCha20-Poly1305 record under a fresh
+*                  nonce and identified by a random token. The tag also covers the
+*                  user, token and masked number, and is checked before a record is
+*                  indexed. The log is read once into a
+*                  hash index; later saves append a record instead of rewriting the file,
+*                  and a lookup is one hash probe plus decrypting a few dozen bytes.
+*                  Cards found in the legacy plaintext user_cards.json are moved into
+*                  the vault on first use and the plaintext file is emptied.
+*                  The CVV is never stored: it is asked for at checkout and travels only
+*                  in the PaymentRequest handed to the gateway. Records from versions
+*                  that still sealed it are resealed without it when the vault loads.
+******************************************************************************************/
+class CardVault {
+public:
+    /*
+    * Description: Returns true if the user has a saved card.
+    */
+    static bool hasCard(const std::string& username);
+
+    /*
+    * Description: Saves (or replaces) the user's card and returns its token, or an
+    *              empty string if the record could not be written.
+    */
+    static std::string storeCard(const std::string& username, const std::string& cardNumber,
+                                 const std::string& expDate, const std::string& cardHolder);
+
+    /*
+    * Description: Returns the token of the user's saved card, or "" if there is none.
+    */
+    static std::string tokenOf(const std::string& username);
+
+    /*
+    * Description: Returns the masked number of the user's saved card ("**** 1234").
+    */
+    static std::string maskedCardOf(const std::string& username);
+
+    /*
+    * Description: Masks a card number down to its last four digits.
+    */
+    static std::string maskCardNumber(const std::string& cardNumber);
+
+    /*
+    * Description: Returns the number of saved cards.
+    */
+    static size_t cardCount(void);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -0,0 +1,64 @@
+/******************************************************************************************
+* MODULE NAME    : Command Runner Module
+* FILE           : CommandRunner.hpp
+* DESCRIPTION    : Declares the CommandRunner class, which runs scripted operations
+*                  (search, book, cancel, confirm, report, metrics) against the domain
+*                  layer without going through the interactive menus.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "StartupLoader.hpp"
+#include <iosfwd>
+#include <string>
+
+/* New bookings buffered before they are merged into the reservation file in one write */
+#ifndef COMMAND_WRITE_BATCH
+#define COMMAND_WRITE_BATCH 256
+#endif
+
+/* Exit codes of a command run */
+#define COMMAND_EXIT_OK          0   // Every command succeeded
+#define COMMAND_EXIT_FAILURES    1   // At least one command failed
+#define COMMAND_EXIT_BAD_INPUT   2   // The command file could not be read
+
+/******************************************************************************************
+* CLASS NAME     : CommandRunner
+* DESCRIPTION    : Reads one JSON command per line and writes one JSON result per line.
+*                  Commands:
+*                    {"op":"search","origin":"...","destination":"..."}
+*                    {"op":"book","user":"...","flight":"...","seat":"14A"|"W",
+*                     "fareClass":"...","payment":"cash"|"card"}
+*                    {"op":"cancel","reservationID":"..."}
+*                    {"op":"confirm","reservationID":"..."}   (cash payment at the airport)
+*                    {"op":"report","groupBy":"route"|"month"|"aircraft"|"channel"|"flight"}
+*                     (groupBy optional)
+*                    {"op":"metrics"}   (latency and I/O counters, see Metrics)
+*                  An optional "id" is echoed in the result. Reservations are loaded once
+*                  per run (or taken from the startup load) and new bookings are written in batches of COMMAND_WRITE_BATCH;
+*                  a cancel, confirm or report first flushes the pending batch so it sees
+*                  every booking before it. A booking whose save or card charge fails at
+*                  the flush gets a second record for its line with "ok": false, and is
+*                  counted as failed. Domain messages printed to cout are discarded.
+*                  Batch mode performs no login: the "user" of a booking is trusted.
+******************************************************************************************/
+class CommandRunner {
+public:
+    /*
+    * Description: Runs the commands of a file ("-" for standard input), writing the
+    *              results to standard output. Returns one of the COMMAND_EXIT_ codes.
+    *              Reservations the startup load already read are used instead of the files.
+    */
+    static int runFile(const std::string& path, const StartupData* preloaded = nullptr);
+
+    /*
+    * Description: Runs the commands read from in, writing the results to out.
+    */
+    static int run(std::istream& in, std::ostream& out, const StartupData* preloaded = nullptr);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -36,17 +36,17 @@ public:
     /*
     * Description: Returns the crew member's name.
     */
-    string getName(void) const;
+    const string& getName(void) const;
 
     /*
     * Description: Returns the role of the crew member (e.g., pilot, co-pilot, attendant).
     */
-    string getRole(void) const;
+    const string& getRole(void) const;
 
     /*
     * Description: Retrieves all flights assigned to the crew member.
     */
-    vector<shared_ptr<Flight>> getAssignedFlights(void) const;
+    const vector<shared_ptr<Flight>>& getAssignedFlights(void) const;
 
     /*
     * Description: Assigns a new flight to the crew member.
@@ -88,6 +88,11 @@ public:
     */
     static Crew* getCrewByName(const string& crewName);
 
+    /*
+    * Description: Returns the number of crew members loaded in memory.
+    */
+    static size_t crewCount(void);
+
 private:
     /*
     * Description: The name of the crew member.
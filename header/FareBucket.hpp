@@ -0,0 +1,69 @@
+/******************************************************************************************
+* MODULE NAME    : Fare Bucket Module
+* FILE           : FareBucket.hpp
+* DESCRIPTION    : Declares the FareBucket type and the helpers that parse, serialise and
+*                  offer a flight's fare buckets (its per-class price table).
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "json.hpp"
+
+/* Upper bound on fare buckets per flight; keeps nested availability checks O(1) */
+#define MAX_FARE_BUCKETS 8
+
+/* Code of the single bucket given to flights that define no fare table */
+#define DEFAULT_FARE_BUCKET "Y"
+
+class Flight;
+
+/******************************************************************************************
+* STRUCT NAME    : FareBucket
+* DESCRIPTION    : One fare class. Buckets are ordered from the highest fare down and
+*                  their booking limits are nested: a bucket's limit caps the seats sold
+*                  in it and every cheaper bucket together. The first bucket is always
+*                  limited by the flight's authorised capacity alone.
+******************************************************************************************/
+struct FareBucket {
+    std::string code;          // e.g. "Y", "M", "Q"
+    std::string price;         // Same format as Flight prices, e.g. "120$"
+    int         bookingLimit;  // Nested limit for this bucket and all below it
+};
+
+/*
+* Description: Returns the seats that may be sold once overbooking is allowed for.
+*/
+int authorizedCapacity(int totalSeats, int overbookingPercent);
+
+/*
+* Description: Checks bucket count, unique codes and non-increasing positive limits.
+*/
+bool validateFareBuckets(const std::vector<FareBucket>& buckets);
+
+/*
+* Description: Parses "CODE:PRICE:LIMIT,..." (e.g. "Y:300$:700,Q:120$:100").
+* Returns     : false, leaving buckets untouched, if the text is malformed or invalid.
+*/
+bool parseFareBuckets(const std::string& text, std::vector<FareBucket>& buckets);
+
+/*
+* Description: Converts a fare table to and from its JSON array form.
+*/
+nlohmann::json fareBucketsToJson(const std::vector<FareBucket>& buckets);
+std::vector<FareBucket> fareBucketsFromJson(const nlohmann::json& j);
+
+/*
+* Description: Lists the open buckets of a flight with their prices and availability and
+*              lets the user pick one; a flight with a single open bucket is picked
+*              without asking.
+* Returns     : false if nothing is available or the choice was invalid.
+*/
+bool selectFareBucket(const Flight& flight, std::string& fareClass);
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -12,7 +12,12 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include "json.hpp"
+#include "SymbolTable.hpp"
+#include "FlightStatus.hpp"
+#include "FareBucket.hpp"
+#include "LoadArena.hpp"
 
 #define PATH_OF_FLIGHTS_DATA_BASE "data_base/flights.json"
 
@@ -27,14 +32,16 @@ using namespace std;
 class Flight {
 private:
     string flightNumber;
-    string origin;
-    string destination;
+    SymbolTable::Symbol origin;         // Interned airport/city names
+    SymbolTable::Symbol destination;
     string departureTime;
     string arrivalTime;
-    string aircraftType;
+    SymbolTable::Symbol aircraftType;   // Interned aircraft type
     int totalSeats;
-    string status;
-    string flightPrice;
+    FlightStatus status;
+    string flightPrice;                 // Price of the first (highest) fare bucket
+    vector<FareBucket> fareBuckets;     // Per-class price table, highest fare first
+    int overbookingPercent;             // Seats sold beyond totalSeats, in percent
 
     // Private Setters
     void setFlightNumber(const string& flightNumber);
@@ -44,9 +51,13 @@ private:
     void setArrivalTime(const string& arrivalTime);
     void setAircraftType(const string& aircraftType);
     void setTotalSeats(int totalSeats);
-    void setStatus(const string& status);
+    bool setStatus(const string& status);
     void setflightPrice(const string& price);
 
+    // Shared body of both fromJson overloads
+    template <typename Json>
+    static Flight fromJsonOf(const Json& j);
+
 public:
     /*
     * Default Constructor: Initializes all attributes to default values.
@@ -56,9 +67,9 @@ public:
     /*
     * Parameterized Constructor: Initializes a flight object with full data.
     */
-    Flight(const string& flightNumber, const string& origin, const string& destination,
-           const string& departureTime, const string& arrivalTime,
-           const string& aircraftType, int totalSeats, const string& status, const string& price);
+    Flight(string flightNumber, const string& origin, const string& destination,
+           string departureTime, string arrivalTime,
+           const string& aircraftType, int totalSeats, const string& status, string price);
 
     /*
     * Description: Displays all information related to this flight.
@@ -75,6 +86,11 @@ public:
     */
     static Flight fromJson(const json& j);
 
+    /*
+    * Description: Creates a Flight from a record parsed into a load arena.
+    */
+    static Flight fromJson(const ArenaJson& j);
+
     /*
     * Description: Saves a vector of flights to a specified JSON file.
     */
@@ -100,16 +116,53 @@ public:
     */
     static void updateFlightInFile(const string& flightNumber, const string& fieldToUpdate, const string& newValue, const string& filename);
 
+    /*
+    * Description: Returns true if this flight flies from origin to destination.
+    *              Compares in place, so scans over many flights allocate nothing.
+    */
+    bool servesRoute(std::string_view origin, std::string_view destination) const;
+
+    /*
+    * Description: Integer-compare variant of servesRoute for callers that resolved the
+    *              route's symbols once up front.
+    */
+    bool servesRoute(SymbolTable::Symbol originID, SymbolTable::Symbol destinationID) const;
+
+    /*
+    * Description: Replaces the fare table; the first bucket's price becomes the flight
+    *              price. Returns false, changing nothing, if the table is invalid.
+    */
+    bool setFareBuckets(vector<FareBucket> buckets);
+
+    /*
+    * Description: Sets the overbooking allowance (0-100 percent of totalSeats).
+    */
+    bool setOverbookingPercent(int percent);
+
+    /*
+    * Description: Returns the bucket with the given code, or nullptr.
+    */
+    const FareBucket* findFareBucket(const string& code) const;
+
     // Getters
-    string getFlightNumber(void) const;
-    string getOrigin(void) const;
-    string getDestination(void) const;
-    string getDepartureTime(void) const;
-    string getArrivalTime(void) const;
-    string getAircraftType(void) const;
-    string getflightPrice(void) const;
+    const string& getFlightNumber(void) const;
+    const string& getOrigin(void) const;
+    const string& getDestination(void) const;
+    const string& getDepartureTime(void) const;
+    const string& getArrivalTime(void) const;
+    const string& getAircraftType(void) const;
+    const string& getflightPrice(void) const;
     int getTotalSeats(void) const;
-    string getStatus(void) const;
+    const string& getStatus(void) const;
+    FlightStatus getStatusCode(void) const;
+    const vector<FareBucket>& getFareBuckets(void) const;
+    int getOverbookingPercent(void) const;
+    int getAuthorizedCapacity(void) const;
+
+    // Interned IDs of the symbol fields
+    SymbolTable::Symbol getOriginID(void) const;
+    SymbolTable::Symbol getDestinationID(void) const;
+    SymbolTable::Symbol getAircraftTypeID(void) const;
 };
 
 /******************************************************************************************
@@ -0,0 +1,77 @@
+/******************************************************************************************
+* MODULE NAME    : Flight Registry Module
+* FILE           : FlightRegistry.hpp
+* DESCRIPTION    : Declares the FlightRegistry class, the in-memory view of the flight
+*                  schedule that is kept in step with the flights file and answers
+*                  aggregate questions (such as flights per status) in O(1).
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "Flight.hpp"
+#include "FlightStatus.hpp"
+#include "FlightTable.hpp"
+#include "RouteGraph.hpp"
+#include "SearchCache.hpp"
+#include <memory>
+
+/******************************************************************************************
+* CLASS NAME     : FlightRegistry
+* DESCRIPTION    : Seeds itself from PATH_OF_FLIGHTS_DATA_BASE on first use and is then
+*                  updated incrementally by the Flight file operations. Counters are
+*                  atomic so dashboards can read them from any thread; the columnar
+*                  table is published as immutable snapshots, so readers never lock
+*                  while they scan.
+******************************************************************************************/
+class FlightRegistry {
+public:
+    /*
+    * Description: Returns the number of flights currently in the given status.
+    */
+    static int statusCount(FlightStatus status);
+
+    /*
+    * Description: Returns the number of flights in the schedule.
+    */
+    static int totalFlights(void);
+
+    /*
+    * Description: Returns the current columnar snapshot of the schedule.
+    */
+    static std::shared_ptr<const FlightTable> table(void);
+
+    /*
+    * Description: Returns the route graph, kept in step with every schedule change.
+    */
+    static const RouteGraph& routes(void);
+
+    /*
+    * Description: Returns the direct flights of a route departing inside the window,
+    *              served from the SearchCache when the same query was seen before.
+    */
+    static SearchCache::Results findDirectFlights(const std::string& origin,
+                                                  const std::string& destination,
+                                                  int32_t fromMinute = INT32_MIN,
+                                                  int32_t toMinute   = INT32_MAX);
+
+    /*
+    * Description: Records a flight that was added to the schedule.
+    */
+    static void onFlightAdded(const Flight& flight);
+
+    /*
+    * Description: Records a flight that was removed from the schedule.
+    */
+    static void onFlightRemoved(const Flight& flight);
+
+    /*
+    * Description: Records an edit of an existing flight.
+    */
+    static void onFlightUpdated(const Flight& before, const Flight& after);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
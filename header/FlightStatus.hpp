@@ -0,0 +1,50 @@
+/******************************************************************************************
+* MODULE NAME    : Flight Status Module
+* FILE           : FlightStatus.hpp
+* DESCRIPTION    : Declares the FlightStatus enumeration together with its string
+*                  conversions and the state machine of allowed status transitions.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/******************************************************************************************
+* ENUM NAME      : FlightStatus
+* DESCRIPTION    : Operational status of a flight. Canceled and Completed are terminal.
+******************************************************************************************/
+enum class FlightStatus : std::uint8_t {
+    Scheduled = 0,
+    Delayed,
+    Canceled,
+    Completed
+};
+
+/* Number of FlightStatus values, used to size per-status counter arrays */
+constexpr std::size_t FLIGHT_STATUS_COUNT = 4;
+
+/*
+* Description: Returns the display/storage name of a status (e.g. "Delayed").
+*/
+const std::string& flightStatusToString(FlightStatus status);
+
+/*
+* Description: Parses a status name case-insensitively.
+* Returns     : True and sets status if the name is recognised, otherwise false.
+*/
+bool flightStatusFromString(std::string_view text, FlightStatus& status);
+
+/*
+* Description: Returns true if a flight may move from one status to another.
+*              Staying in the same status is always allowed.
+*/
+bool isValidStatusTransition(FlightStatus from, FlightStatus to);
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -0,0 +1,156 @@
+/******************************************************************************************
+* MODULE NAME    : Flight Table Module
+* FILE           : FlightTable.hpp
+* DESCRIPTION    : Declares the FlightTable class, a column-oriented (structure-of-arrays)
+*                  copy of the flight schedule used for full scans such as searches and
+*                  report generation. Flight objects remain available as row views.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Flight.hpp"
+#include "SymbolTable.hpp"
+
+/* Rows whose match flags the route filter computes per block, on the stack */
+#define FILTER_BLOCK_ROWS 1024
+
+/******************************************************************************************
+* CLASS NAME     : FlightTable
+* DESCRIPTION    : Keeps one contiguous array per flight attribute. Hot columns hold
+*                  integers only (interned IDs, epochs, cents, status codes) so the scan
+*                  kernels are branch-free loops the compiler can vectorise; the original
+*                  strings are kept in cold columns to rebuild Flight rows exactly.
+*                  Times are stored as 32-bit minutes since the Unix epoch so that date
+*                  comparisons fit baseline SSE2 lanes.
+******************************************************************************************/
+class FlightTable {
+public:
+    /*
+    * Description: Builds a table from a list of flights, preserving their order.
+    */
+    static FlightTable fromFlights(const vector<Flight>& flights);
+
+    /*
+    * Description: Number of rows (flights) in the table.
+    */
+    size_t size(void) const;
+
+    /*
+    * Description: Returns the row of a flight number, or -1 if it is not in the table.
+    *              O(1) through a hash index kept by append, update and erase.
+    */
+    long findRow(const string& flightNumber) const;
+
+    /*
+    * Description: Materialises one row as a Flight object.
+    */
+    Flight row(size_t index) const;
+
+    /*
+    * Description: Appends a flight as a new row.
+    */
+    void append(const Flight& flight);
+
+    /*
+    * Description: Overwrites an existing row with new flight data.
+    */
+    void update(size_t index, const Flight& flight);
+
+    /*
+    * Description: Removes a row, keeping the remaining rows in order.
+    */
+    void erase(size_t index);
+
+    /*
+    * Description: Collects the rows flying originID -> destinationID whose departure
+    *              (in epoch minutes) lies in [fromMinute, toMinute]. Pass
+    *              INT32_MIN/INT32_MAX for an open date window.
+    */
+    void filterByRouteAndDate(SymbolTable::Symbol originID, SymbolTable::Symbol destinationID,
+                              int32_t fromMinute, int32_t toMinute,
+                              vector<uint32_t>& rows) const;
+
+    /*
+    * Description: Sums fare * bookings over every fare bucket of every row, in cents.
+    *              bookings is indexed [row * MAX_FARE_BUCKETS + bucket].
+    */
+    int64_t sumRevenueCents(const vector<int32_t>& bookings) const;
+
+    /*
+    * Description: Returns a row's bucket index for a fare class code; unknown or empty
+    *              codes (legacy bookings) map to the first bucket.
+    */
+    size_t fareBucketIndex(size_t index, const string& code) const;
+
+    // Column accessors
+    const string& getFlightNumber(size_t index) const;
+    SymbolTable::Symbol getOriginID(size_t index) const;
+    SymbolTable::Symbol getDestinationID(size_t index) const;
+    int32_t getDepartureMinute(size_t index) const;
+    int32_t getArrivalMinute(size_t index) const;
+    int32_t getTotalSeats(size_t index) const;
+    FlightStatus getStatus(size_t index) const;
+    int64_t getPriceCents(size_t index) const;
+    int64_t getFareCents(size_t index, size_t bucket) const;
+    const vector<FareBucket>& getFareBuckets(size_t index) const;
+
+    /*
+    * Description: Parses "YYYY-MM-DD HH:MM" (UTC) into minutes since the Unix epoch.
+    * Returns     : -1 if the text is not in that format.
+    */
+    static int32_t parseDateTime(const string& text);
+
+    /*
+    * Description: Returns the current time in the minutes parseDateTime produces.
+    */
+    static int32_t currentMinute(void);
+
+    /*
+    * Description: Parses a price such as "70$", "$70.50" or "70" into cents.
+    * Returns     : 0 if no amount can be read.
+    */
+    static int64_t parsePriceCents(const string& text);
+
+private:
+    // Hot columns
+    vector<SymbolTable::Symbol> originIDs;
+    vector<SymbolTable::Symbol> destinationIDs;
+    vector<SymbolTable::Symbol> aircraftTypeIDs;
+    vector<int32_t>             departureMinutes;
+    vector<int32_t>             arrivalMinutes;
+    vector<int32_t>             totalSeats;
+    vector<uint8_t>             statuses;
+    vector<int32_t>             overbookingPercents;
+    vector<int64_t>             fareCents;      // MAX_FARE_BUCKETS per row, 0 past the last bucket
+
+    // Cold columns, only read when a row is materialised
+    vector<string> flightNumbers;
+    vector<string> departureTimes;
+    vector<string> arrivalTimes;
+    vector<vector<FareBucket>> fareBuckets;
+
+    // Flight number -> row of its first occurrence
+    unordered_map<string, size_t> rowByNumber;
+
+    /*
+    * Description: Adds a row's flight number to the index, or removes it; a number
+    *              that occurs again further down is then indexed at that row.
+    */
+    void indexRow(size_t index);
+    void unindexRow(size_t index);
+
+    /*
+    * Description: Writes the fare columns of one row from a flight.
+    */
+    void storeFares(size_t index, const Flight& flight);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
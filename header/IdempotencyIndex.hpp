@@ -0,0 +1,79 @@
+/******************************************************************************************
+* MODULE NAME    : Idempotency Index Module
+* FILE           : IdempotencyIndex.hpp
+* DESCRIPTION    : Declares the IdempotencyIndex class, which remembers which payment
+*                  operations have already run so that retries become no-ops.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/* Append-only log of completed operations, one JSON object per line */
+#define PATH_OF_IDEMPOTENCY_DATA_BASE "data_base/idempotency.log"
+
+/* Completed keys kept in memory (and on disk after compaction); oldest are evicted first */
+#ifndef IDEMPOTENCY_CAPACITY
+#define IDEMPOTENCY_CAPACITY 65536
+#endif
+
+/******************************************************************************************
+* ENUM NAME      : IdempotencyState
+* DESCRIPTION    : What begin() found for a key.
+******************************************************************************************/
+enum class IdempotencyState {
+    New,         // The caller now owns the operation and must complete or abandon it
+    InProgress,  // Another caller is running the operation right now
+    Completed    // The operation already ran; its recorded outcome is returned
+};
+
+/******************************************************************************************
+* STRUCT NAME    : IdempotencyStats
+* DESCRIPTION    : Counters of the index since start.
+******************************************************************************************/
+struct IdempotencyStats {
+    size_t   entries    = 0;   // Keys in memory, in progress or completed
+    uint64_t duplicates = 0;   // begin() calls answered InProgress or Completed
+    uint64_t evictions  = 0;
+};
+
+/******************************************************************************************
+* CLASS NAME     : IdempotencyIndex
+* DESCRIPTION    : A hash index from operation key to outcome, bounded to the most recent
+*                  IDEMPOTENCY_CAPACITY completions. begin() claims a key atomically, so
+*                  of any number of concurrent retries exactly one runs the operation.
+*                  Completions are appended to a log that is replayed on first use, so a
+*                  retry after a restart is still recognised.
+******************************************************************************************/
+class IdempotencyIndex {
+public:
+    /*
+    * Description: Claims the key if it is unknown. Otherwise reports whether it is in
+    *              progress or completed, and in the latter case sets outcome.
+    */
+    static IdempotencyState begin(const std::string& key, std::string& outcome);
+
+    /*
+    * Description: Records the outcome of a claimed key and persists it.
+    */
+    static void complete(const std::string& key, const std::string& outcome);
+
+    /*
+    * Description: Releases a claimed key without an outcome so the operation may be
+    *              retried (e.g. the reservation was not found).
+    */
+    static void abandon(const std::string& key);
+
+    /*
+    * Description: Returns the index counters.
+    */
+    static IdempotencyStats stats(void);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
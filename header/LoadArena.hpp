@@ -0,0 +1,160 @@
+/******************************************************************************************
+* MODULE NAME    : Load Arena Module
+* FILE           : LoadArena.hpp
+* DESCRIPTION    : Declares the load-scoped arena used by the bulk loaders: a monotonic
+*                  memory resource that holds a data file, its parse tree and the objects
+*                  built from it, and is released in one step when the load is done with.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "json.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* Arena bytes reserved up front per byte of the file being parsed; covers the text and
+   its parse tree, so a load needs a single chunk */
+#ifndef LOAD_ARENA_BYTES_PER_FILE_BYTE
+#define LOAD_ARENA_BYTES_PER_FILE_BYTE 4
+#endif
+
+/* Smallest first chunk */
+#define LOAD_ARENA_MIN_BYTES 4096
+
+/******************************************************************************************
+* CLASS NAME     : LoadArena
+* DESCRIPTION    : A std::pmr::monotonic_buffer_resource over a few large chunks. Nothing
+*                  allocated from it is freed individually; every chunk is returned when the
+*                  arena is destroyed. An arena is filled by one thread; objects it holds
+*                  may be released from any thread.
+******************************************************************************************/
+class LoadArena {
+public:
+    explicit LoadArena(size_t initialBytes);
+
+    LoadArena(const LoadArena&) = delete;
+    LoadArena& operator=(const LoadArena&) = delete;
+
+    /*
+    * Description: Creates an arena sized for loading the given file.
+    */
+    static std::shared_ptr<LoadArena> forFile(const std::string& path);
+
+    /*
+    * Description: Returns the memory resource that allocates from this arena.
+    */
+    std::pmr::memory_resource* resource(void) { return &arena; }
+
+    /*
+    * Description: Reads a whole file into the arena. Returns false if it cannot be opened.
+    */
+    bool readFile(const std::string& path, std::string_view& contents);
+
+    /*
+    * Description: Returns the resource ArenaAllocator uses on the calling thread: the
+    *              arena of the innermost LoadArenaScope, or the global heap outside one.
+    */
+    static std::pmr::memory_resource* current(void);
+
+private:
+    std::pmr::monotonic_buffer_resource arena;
+};
+
+/******************************************************************************************
+* CLASS NAME     : LoadArenaScope
+* DESCRIPTION    : Makes an arena the calling thread's current one for its lifetime.
+******************************************************************************************/
+class LoadArenaScope {
+public:
+    explicit LoadArenaScope(LoadArena& arena);
+    ~LoadArenaScope(void);
+
+    LoadArenaScope(const LoadArenaScope&) = delete;
+    LoadArenaScope& operator=(const LoadArenaScope&) = delete;
+
+private:
+    std::pmr::memory_resource* previous;
+};
+
+/******************************************************************************************
+* CLASS NAME     : ArenaAllocator
+* DESCRIPTION    : Stateless allocator drawing from the current thread's arena, so it can
+*                  be plugged into nlohmann::basic_json as a template argument. Whatever it
+*                  allocates must be destroyed inside the same LoadArenaScope.
+******************************************************************************************/
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator(void) = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(LoadArena::current()->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        LoadArena::current()->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const { return false; }
+};
+
+/* Parse tree whose nodes live in the current arena; keys and string values are plain
+   std::string so they convert like nlohmann::json's */
+using ArenaJson = nlohmann::basic_json<std::map, std::vector, std::string, bool, std::int64_t,
+                                       std::uint64_t, double, ArenaAllocator>;
+
+/******************************************************************************************
+* CLASS NAME     : SharedArenaAllocator
+* DESCRIPTION    : Allocator for std::allocate_shared that keeps its arena alive: each
+*                  object's control block holds a reference, so the arena is released with
+*                  the last object loaded into it, wherever that object ends up.
+******************************************************************************************/
+template <typename T>
+class SharedArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit SharedArenaAllocator(std::shared_ptr<LoadArena> owner) : arena(std::move(owner)) {}
+    template <typename U>
+    SharedArenaAllocator(const SharedArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(arena->resource()->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        arena->resource()->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    template <typename U>
+    bool operator==(const SharedArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const SharedArenaAllocator<U>& other) const { return arena != other.arena; }
+
+private:
+    template <typename U> friend class SharedArenaAllocator;
+    std::shared_ptr<LoadArena> arena;
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -37,11 +37,11 @@ public:
     /*
     * Constructor: Initializes a maintenance record with aircraft ID and details.
     */
-    Maintenance(const string& id, const string& details);
+    Maintenance(string id, string details);
 
     // Getters
-    string getAircraftID(void) const;
-    string getMaintenanceDetails(void) const;
+    const string& getAircraftID(void) const;
+    const string& getMaintenanceDetails(void) const;
 
     // Setters
     void setAircraftID(const string& id);
@@ -0,0 +1,120 @@
+/******************************************************************************************
+* MODULE NAME    : Memory Accounting Module
+* FILE           : MemoryAccounting.hpp
+* DESCRIPTION    : Declares the allocation profiler: a counting global allocator whose
+*                  allocations are attributed to the subsystem tagged on the calling
+*                  thread, and a report of what each data set costs once loaded.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "json.hpp"
+#include <cstddef>
+#include <cstdint>
+
+/* Build with -DAIRLINE_MEMORY_ACCOUNTING=1 (make MEMORY_ACCOUNTING=1) to replace the
+   global allocator with the counting one */
+#ifndef AIRLINE_MEMORY_ACCOUNTING
+#define AIRLINE_MEMORY_ACCOUNTING 0
+#endif
+
+/******************************************************************************************
+* ENUM NAME      : MemorySubsystem
+* DESCRIPTION    : Owner an allocation is charged to.
+******************************************************************************************/
+enum class MemorySubsystem : uint8_t {
+    Other,          // Untagged code
+    Flights,
+    Reservations,
+    Crew,
+    Aircraft,
+    Json,           // Parse trees and serialisation buffers
+    Count
+};
+
+/******************************************************************************************
+* STRUCT NAME    : MemoryUsage
+* DESCRIPTION    : Counters of one subsystem since start.
+******************************************************************************************/
+struct MemoryUsage {
+    uint64_t allocations    = 0;
+    uint64_t frees          = 0;
+    uint64_t bytesAllocated = 0;   // Total ever requested
+    int64_t  liveBytes      = 0;   // Requested and not yet freed
+    int64_t  peakBytes      = 0;   // Highest liveBytes seen
+};
+
+/******************************************************************************************
+* CLASS NAME     : MemoryAccounting
+* DESCRIPTION    : With accounting compiled in, every operator new is prefixed by a small
+*                  header recording its size and subsystem, so a free is credited to the
+*                  subsystem that allocated it even when another one releases it. The
+*                  subsystem is the innermost MemoryTag on the calling thread. Without
+*                  accounting the allocator is untouched and the counters stay zero.
+******************************************************************************************/
+class MemoryAccounting {
+public:
+    /*
+    * Description: Returns whether the counting allocator is compiled in.
+    */
+    static constexpr bool enabled(void) { return AIRLINE_MEMORY_ACCOUNTING != 0; }
+
+    /*
+    * Description: Returns the counters of one subsystem.
+    */
+    static MemoryUsage usage(MemorySubsystem subsystem);
+
+    /*
+    * Description: Returns the name of a subsystem ("flights", "json", ...).
+    */
+    static const char* name(MemorySubsystem subsystem);
+
+    /*
+    * Description: Returns every subsystem's counters as JSON.
+    */
+    static nlohmann::json snapshot(void);
+
+    /*
+    * Description: Loads flights, reservations, crew and aircraft one at a time and
+    *              reports, for each, the allocations made while loading and the bytes
+    *              still held once loaded, in total and per record, plus the
+    *              steady-state allocations of a pooled booking, the allocations
+    *              per record of the menus' search and filter scans, and the
+    *              allocations and time of loading a large aircraft file with the
+    *              moving loader against a copying baseline.
+    */
+    static nlohmann::json profileLoads(void);
+};
+
+/******************************************************************************************
+* CLASS NAME     : MemoryTag
+* DESCRIPTION    : Charges the calling thread's allocations to a subsystem for its lifetime.
+******************************************************************************************/
+class MemoryTag {
+public:
+    explicit MemoryTag(MemorySubsystem subsystem);
+    ~MemoryTag(void);
+
+    MemoryTag(const MemoryTag&) = delete;
+    MemoryTag& operator=(const MemoryTag&) = delete;
+
+private:
+    MemorySubsystem previous;
+};
+
+/*
+* Description: Charges the rest of the enclosing scope's allocations to a subsystem.
+*/
+#if AIRLINE_MEMORY_ACCOUNTING
+#define MEMORY_CONCAT_INNER(a, b) a##b
+#define MEMORY_CONCAT(a, b) MEMORY_CONCAT_INNER(a, b)
+#define MEMORY_TAG(subsystem) MemoryTag MEMORY_CONCAT(memoryTag_, __LINE__)(MemorySubsystem::subsystem)
+#else
+#define MEMORY_TAG(subsystem) ((void)0)
+#endif
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -0,0 +1,163 @@
+/******************************************************************************************
+* MODULE NAME    : Metrics Module
+* FILE           : Metrics.hpp
+* DESCRIPTION    : Declares the latency instrumentation layer: scoped timers feeding
+*                  per-operation HDR-style histograms, plus byte and record counters,
+*                  dumpable as JSON.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "json.hpp"
+#include "Tracer.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/* Build with -DAIRLINE_METRICS=0 to compile every timer and counter out */
+#ifndef AIRLINE_METRICS
+#define AIRLINE_METRICS 1
+#endif
+
+/* Distinct operations that can be timed; further registrations share the last slot */
+#define MAX_METRIC_OPERATIONS 64
+
+/* Environment variable naming the file the metrics are dumped to at exit ("-" = stderr) */
+#define METRICS_ENVIRONMENT_VARIABLE "AIRLINE_METRICS"
+
+/*
+* Description: Handle of a registered operation.
+*/
+using MetricId = uint32_t;
+
+/******************************************************************************************
+* CLASS NAME     : Metrics
+* DESCRIPTION    : Process-wide instrumentation. Recording is off until setEnabled(true);
+*                  while off, a timer costs one relaxed atomic load. Each operation owns a
+*                  log-linear histogram of nanosecond latencies (16 sub-buckets per power
+*                  of two, so every value is within about 6%) and counters for the bytes
+*                  read and written and the records parsed while it was the innermost
+*                  running timer on its thread. All updates are lock-free.
+******************************************************************************************/
+class Metrics {
+public:
+    /*
+    * Description: Turns recording on or off at run time.
+    */
+    static void setEnabled(bool on);
+
+    /*
+    * Description: Returns whether recording is on.
+    */
+    static bool enabled(void) { return recording.load(std::memory_order_relaxed); }
+
+    /*
+    * Description: Returns the handle of a named operation, registering it on first use.
+    */
+    static MetricId operation(const char* name);
+
+    /*
+    * Description: Adds one latency sample to an operation.
+    */
+    static void record(MetricId id, uint64_t nanoseconds);
+
+    /*
+    * Description: Charge I/O and parsing work to the innermost running timer of the
+    *              calling thread (and to the process totals).
+    */
+    static void addBytesRead(uint64_t bytes);
+    static void addBytesWritten(uint64_t bytes);
+    static void addRecordsParsed(uint64_t records);
+
+    /*
+    * Description: Returns every operation that has samples or counts, with count, mean,
+    *              min, max and p50/p90/p99/p99.9 in microseconds, plus the totals.
+    */
+    static nlohmann::json snapshot(void);
+
+    /*
+    * Description: Writes snapshot() to a file ("-" for stderr). Returns false on I/O error.
+    */
+    static bool dump(const std::string& path);
+
+    /*
+    * Description: Enables recording if METRICS_ENVIRONMENT_VARIABLE is set and dumps to
+    *              the file it names when the process exits.
+    */
+    static void configureFromEnvironment(void);
+
+    /*
+    * Description: Clears every sample and counter; registrations are kept.
+    */
+    static void reset(void);
+
+private:
+    static std::atomic<bool> recording;
+};
+
+/******************************************************************************************
+* CLASS NAME     : ScopedTimer
+* DESCRIPTION    : Times its own lifetime into an operation and, while alive, is the
+*                  operation the byte and record counters of its thread are charged to.
+******************************************************************************************/
+class ScopedTimer {
+public:
+    explicit ScopedTimer(MetricId operationId)
+        : id(operationId), active(Metrics::enabled()), parent(nullptr)
+    {
+        if (active)
+            start();
+    }
+
+    ~ScopedTimer(void)
+    {
+        if (active)
+            stop();
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    /*
+    * Description: Returns the innermost running timer of the calling thread, or null.
+    */
+    static ScopedTimer* current(void);
+
+    MetricId id;
+
+private:
+    void start(void);
+    void stop(void);
+
+    bool                                  active;
+    ScopedTimer*                          parent;
+    std::chrono::steady_clock::time_point started;
+};
+
+/*
+* Description: Times the rest of the enclosing scope as the named operation, and traces
+*              it as a span of the same name. The name is looked up once per call site.
+*/
+#if AIRLINE_METRICS
+#define METRIC_CONCAT_INNER(a, b) a##b
+#define METRIC_CONCAT(a, b) METRIC_CONCAT_INNER(a, b)
+#define METRIC_SCOPE(name)                                                              \
+    static const MetricId METRIC_CONCAT(metricId_, __LINE__) = Metrics::operation(name); \
+    ScopedTimer METRIC_CONCAT(metricTimer_, __LINE__)(METRIC_CONCAT(metricId_, __LINE__)); \
+    TRACE_SPAN(name)
+#define METRIC_BYTES_READ(n)     do { if (Metrics::enabled()) Metrics::addBytesRead(n); } while (0)
+#define METRIC_BYTES_WRITTEN(n)  do { if (Metrics::enabled()) Metrics::addBytesWritten(n); } while (0)
+#define METRIC_RECORDS(n)        do { if (Metrics::enabled()) Metrics::addRecordsParsed(n); } while (0)
+#else
+#define METRIC_SCOPE(name)       TRACE_SPAN(name)
+#define METRIC_BYTES_READ(n)     ((void)0)
+#define METRIC_BYTES_WRITTEN(n)  ((void)0)
+#define METRIC_RECORDS(n)        ((void)0)
+#endif
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
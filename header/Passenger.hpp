@@ -11,6 +11,7 @@
 
 #include "User.hpp"
 #include "Flight.hpp"
+#include "FlightRegistry.hpp"
 #include "Reservation.hpp"
 #include "Payment.hpp"
 #include <vector>
@@ -29,6 +30,12 @@ public:
     */
     Passenger(std::string username, std::string password);
 
+    /*
+    * Constructor: Same, starting from reservations already loaded from the main file.
+    */
+    Passenger(std::string username, std::string password,
+              std::vector<std::shared_ptr<Reservation>> loaded);
+
     /*
     * Displays the passenger's interactive menu options.
     */
@@ -11,10 +11,17 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 #include "Reservation.hpp" 
 
+/* Legacy plaintext card file; read once to migrate its cards into the CardVault */
 #define PATH_OF_USER_CARD_DATA_BASE "data_base/user_cards.json"
 
+/* Card payment outcomes kept for the menu to print; the oldest are dropped past this */
+#ifndef PAYMENT_NOTICE_LIMIT
+#define PAYMENT_NOTICE_LIMIT 64
+#endif
+
 /******************************************************************************************
 * CLASS NAME     : Payment
 * DESCRIPTION    : Handles payment operations including card and cash payments for
@@ -28,16 +35,32 @@ public:
     static bool processPayment(std::shared_ptr<Reservation>& reservation);
 
     /*
-    * Handles card-based payment method.
+    * Handles card-based payment method. The card is saved in the vault (or the saved one
+    * reused) and the reservation left pending; the charge itself is made by
+    * submitCardPayment. The CVV entered here is held in memory until that charge takes it.
     */
     static bool processCardPayment(std::shared_ptr<Reservation>& reservation);
 
     /*
-    * Saves card information securely for a user.
+    * Queues one charge covering the given (already saved) pending reservations. The
+    * pipeline confirms them when the gateway approves and cancels them if it declines.
+    * If the charge cannot be queued the reservations are canceled at once, freeing
+    * their seats and holds, and false is returned.
+    */
+    static bool submitCardPayment(const std::vector<std::shared_ptr<Reservation>>& reservations);
+
+    /*
+    * Prints the card payment outcomes reported since the last call. Outcomes arrive on
+    * pipeline workers and are queued, so only the calling (menu) thread writes them.
+    */
+    static void printNotices(void);
+
+    /*
+    * Saves card information for a user in the encrypted card vault. The CVV is not part
+    * of it.
     */
-    static void saveCardInfo(const std::string& cardNumber, const std::string& cvv,
-                             const std::string& expDate, const std::string& cardHolder,
-                             const std::string& username);
+    static void saveCardInfo(const std::string& cardNumber, const std::string& expDate,
+                             const std::string& cardHolder, const std::string& username);
 };
 
 /******************************************************************************************
@@ -0,0 +1,113 @@
+/******************************************************************************************
+* MODULE NAME    : Payment Gateway Module
+* FILE           : PaymentGateway.hpp
+* DESCRIPTION    : Declares the card payment gateway interface and a local mock gateway
+*                  with configurable latency and decline rate.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+/******************************************************************************************
+* STRUCT NAME    : PaymentRequest
+* DESCRIPTION    : One card charge. A group booking is charged once for all its
+*                  reservations.
+******************************************************************************************/
+struct PaymentRequest {
+    std::string              reference;       // Unique per charge attempt
+    std::string              idempotencyKey;  // Same for every retry of one charge
+    std::string              username;        // Card owner in the CardVault
+    std::string              cardToken;       // Vault token; the gateway never sees the number
+    std::string              cardCvv;         // Entered at checkout for this charge; never stored
+    std::string              amount;          // Same format as Flight prices, e.g. "120$"
+    std::vector<std::string> reservationIDs;  // Reservations settled by this charge
+    std::vector<int64_t>     reservationCents;// Share of each reservation, in the same order
+};
+
+/******************************************************************************************
+* STRUCT NAME    : PaymentResult
+* DESCRIPTION    : The gateway's answer to a PaymentRequest.
+******************************************************************************************/
+struct PaymentResult {
+    bool        approved = false;
+    std::string authorizationCode;  // Set when approved
+    std::string declineReason;      // Set when declined
+};
+
+/******************************************************************************************
+* CLASS NAME     : PaymentGateway
+* DESCRIPTION    : A card processor. charge() may block for as long as the processor
+*                  takes; it is only ever called from the payment pipeline's workers.
+******************************************************************************************/
+class PaymentGateway {
+public:
+    virtual ~PaymentGateway(void) = default;
+
+    /*
+    * Description: Charges the card behind the request's token.
+    */
+    virtual PaymentResult charge(const PaymentRequest& request) = 0;
+
+    /*
+    * Description: Returns amount (same format as PaymentRequest::amount) of an approved
+    *              charge to its card; approved is set if the money went back.
+    */
+    virtual PaymentResult refund(const PaymentRequest& request, const std::string& authorizationCode,
+                                 const std::string& amount) = 0;
+
+    /*
+    * Description: Returns a short name for logs and reports.
+    */
+    virtual std::string name(void) const = 0;
+};
+
+/******************************************************************************************
+* CLASS NAME     : MockPaymentGateway
+* DESCRIPTION    : Local stand-in for a real processor. Every charge sleeps for the
+*                  configured latency and is declined with the configured probability.
+*                  The draw is seeded from the gateway's seed and the charge's
+*                  idempotency key, so the same seed declines the same charges however
+*                  the workers happen to interleave.
+******************************************************************************************/
+class MockPaymentGateway : public PaymentGateway {
+public:
+    /*
+    * Constructor: latency in milliseconds, decline rate in [0, 1], generator seed.
+    */
+    MockPaymentGateway(int latencyMs, double declineRate, unsigned seed);
+
+    /*
+    * Description: Simulates the round trip and approves or declines the charge.
+    */
+    PaymentResult charge(const PaymentRequest& request) override;
+
+    /*
+    * Description: Simulates the round trip and refunds any charge it approved.
+    */
+    PaymentResult refund(const PaymentRequest& request, const std::string& authorizationCode,
+                         const std::string& amount) override;
+
+    /*
+    * Description: Returns "mock".
+    */
+    std::string name(void) const override;
+
+private:
+    int        latencyMs;
+    double     declineRate;
+    unsigned   declineSeed;
+    std::mutex approvalMutex;
+    unsigned   approvals;
+    unsigned   refunds;
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
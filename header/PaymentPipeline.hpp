@@ -0,0 +1,125 @@
+/******************************************************************************************
+* MODULE NAME    : Payment Pipeline Module
+* FILE           : PaymentPipeline.hpp
+* DESCRIPTION    : Declares the PaymentPipeline class, which settles card payments in the
+*                  background so a booking never waits on the card processor.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "PaymentGateway.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+/* Worker threads talking to the gateway (overridable at build time) */
+#ifndef PAYMENT_WORKERS
+#define PAYMENT_WORKERS 4
+#endif
+
+/* Round-trip time of the default mock gateway, in milliseconds */
+#ifndef MOCK_GATEWAY_LATENCY_MS
+#define MOCK_GATEWAY_LATENCY_MS 200
+#endif
+
+/* Fraction of charges the default mock gateway declines */
+#ifndef MOCK_GATEWAY_DECLINE_RATE
+#define MOCK_GATEWAY_DECLINE_RATE 0.0
+#endif
+
+/* Seed of the default mock gateway's declines; the environment variable overrides it */
+#ifndef MOCK_GATEWAY_SEED
+#define MOCK_GATEWAY_SEED 1
+#endif
+
+#define GATEWAY_SEED_ENVIRONMENT_VARIABLE "AIRLINE_GATEWAY_SEED"
+
+/*
+* Description: Invoked on a pipeline worker once the gateway has answered.
+*/
+using PaymentCallback = std::function<void(const PaymentRequest&, const PaymentResult&)>;
+
+/******************************************************************************************
+* STRUCT NAME    : PaymentPipelineStats
+* DESCRIPTION    : Counters of the pipeline since start.
+******************************************************************************************/
+struct PaymentPipelineStats {
+    uint64_t    submitted    = 0;
+    uint64_t    approved     = 0;
+    uint64_t    declined     = 0;
+    uint64_t    deduplicated = 0;   // Retries dropped by the idempotency index
+    uint64_t    refunded     = 0;   // Approved charges returned, in whole or in part
+    size_t      inFlight     = 0;   // Queued or being charged
+    size_t      workers      = 0;
+    std::string gateway;
+};
+
+/******************************************************************************************
+* CLASS NAME     : PaymentPipeline
+* DESCRIPTION    : Queues charges to a ThreadPool whose workers call the gateway and then
+*                  the submitter's callback. Submitting is a queue push, so booking
+*                  throughput does not depend on gateway latency. If start() was never
+*                  called, the first submit starts the pipeline on the default mock gateway.
+******************************************************************************************/
+class PaymentPipeline {
+public:
+    /*
+    * Description: Starts the workers on the given gateway; a running pipeline is
+    *              drained and restarted.
+    */
+    static void start(std::shared_ptr<PaymentGateway> gateway, size_t workers = PAYMENT_WORKERS);
+
+    /*
+    * Description: Settles every queued charge, then stops the workers.
+    */
+    static void stop(void);
+
+    /*
+    * Description: Queues a charge; onResult runs on a worker thread with the outcome.
+    *              A charge whose idempotency key is already in progress or completed
+    *              is dropped (returning true) without reaching the gateway. If onResult
+    *              throws, an approved charge is refunded and the key abandoned, so the
+    *              payment can be retried.
+    */
+    static bool submit(const PaymentRequest& request, PaymentCallback onResult);
+
+    /*
+    * Description: Refunds cents of an approved charge through the current gateway, on
+    *              the calling thread; meant for onResult callbacks.
+    */
+    static PaymentResult refund(const PaymentRequest& request, const PaymentResult& charged, int64_t cents);
+
+    /*
+    * Description: Formats cents like PaymentRequest::amount, e.g. "120.50$".
+    */
+    static std::string formatAmount(int64_t cents);
+
+    /*
+    * Description: Blocks until every queued charge has been settled.
+    */
+    static void drain(void);
+
+    /*
+    * Description: Returns a unique charge reference.
+    */
+    static std::string newReference(void);
+
+    /*
+    * Description: Returns the pipeline counters.
+    */
+    static PaymentPipelineStats stats(void);
+
+    /*
+    * Description: Returns the seed for the default mock gateway: the number in
+    *              GATEWAY_SEED_ENVIRONMENT_VARIABLE if it holds one, else MOCK_GATEWAY_SEED.
+    */
+    static unsigned mockGatewaySeed(void);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -0,0 +1,61 @@
+/******************************************************************************************
+* MODULE NAME    : Payment Stress Module
+* FILE           : PaymentStress.hpp
+* DESCRIPTION    : Declares the PaymentStress class, a self-check that races retried cash
+*                  confirmations and card charges against each other and verifies that
+*                  every reservation is settled exactly once.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "json.hpp"
+#include <cstddef>
+
+/* Default size of a run: reservations per payment method, racing threads, and how many
+   times each thread retries every reservation */
+#ifndef PAYMENT_STRESS_RESERVATIONS
+#define PAYMENT_STRESS_RESERVATIONS 200
+#endif
+
+#ifndef PAYMENT_STRESS_THREADS
+#define PAYMENT_STRESS_THREADS 8
+#endif
+
+#ifndef PAYMENT_STRESS_RETRIES
+#define PAYMENT_STRESS_RETRIES 5
+#endif
+
+/* Gateway round trip during the run, long enough for retries to overlap a charge */
+#define PAYMENT_STRESS_LATENCY_MS 2
+
+/* Passenger the stress reservations are booked for */
+#define PAYMENT_STRESS_USER "stress-test"
+
+/******************************************************************************************
+* CLASS NAME     : PaymentStress
+* DESCRIPTION    : Works on a scratch copy of data_base in the system temp directory, so
+*                  the real files are never touched. Reservation IDs are drawn from every
+*                  thread at once; half the reservations are cash holds whose "cash:<id>"
+*                  confirmations are retried from every thread, the other half card
+*                  bookings whose charges are resubmitted from every thread. A run passes
+*                  if the IDs are distinct, each confirmation key was claimed once, each
+*                  card was charged once, and every reservation ended up paid.
+******************************************************************************************/
+class PaymentStress {
+public:
+    /*
+    * Description: Runs the check and returns its counters and verdict ("passed").
+    *              The working directory is restored and the scratch copy removed on
+    *              every return, but data the domain layer cached from the copy stays
+    *              loaded, so the process should exit once this returns.
+    */
+    static nlohmann::json run(size_t reservations = PAYMENT_STRESS_RESERVATIONS,
+                              size_t threads      = PAYMENT_STRESS_THREADS,
+                              size_t retries      = PAYMENT_STRESS_RETRIES);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
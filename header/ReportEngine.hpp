@@ -0,0 +1,155 @@
+/******************************************************************************************
+* MODULE NAME    : Report Engine Module
+* FILE           : ReportEngine.hpp
+* DESCRIPTION    : Declares the ReportEngine class, which aggregates bookings and revenue
+*                  over the reservations in parallel and groups them by flight, route,
+*                  month, aircraft type or sales channel.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "FlightTable.hpp"
+#include "Reservation.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Worker threads of a report; 0 starts one per hardware thread */
+#ifndef REPORT_WORKERS
+#define REPORT_WORKERS 0
+#endif
+
+/* Fewest reservations worth a chunk of their own; smaller reports run on the caller */
+#ifndef REPORT_CHUNK_RESERVATIONS
+#define REPORT_CHUNK_RESERVATIONS 8192
+#endif
+
+/******************************************************************************************
+* ENUM NAME      : ReportGrouping
+* DESCRIPTION    : What the report lines are keyed by.
+******************************************************************************************/
+enum class ReportGrouping {
+    Flight,        // Flight number
+    Route,         // "origin-destination"
+    Month,         // Departure month, "YYYY-MM"
+    AircraftType,
+    Channel        // "direct" or "agent", by which file holds the booking
+};
+
+/******************************************************************************************
+* ENUM NAME      : ReportFormat
+* DESCRIPTION    : How report lines are written.
+******************************************************************************************/
+enum class ReportFormat {
+    Console,
+    Csv,
+    Json
+};
+
+/******************************************************************************************
+* STRUCT NAME    : SoldFlight
+* DESCRIPTION    : Bookings of one flight departure, as the reservations describe it.
+******************************************************************************************/
+struct SoldFlight {
+    Flight  flight;                 // Embedded in the reservations: route, departure, fares
+    long    row               = -1; // In ReportTotals::table, or -1 if no longer scheduled
+    int64_t bookings          = 0;
+    int64_t agentBookings     = 0;  // The subset booked through an agent
+    int64_t revenueCents      = 0;
+    int64_t agentRevenueCents = 0;
+};
+
+/******************************************************************************************
+* STRUCT NAME    : ReportTotals
+* DESCRIPTION    : Every live reservation counted under the flight it carries. Bookings
+*                  on a scheduled flight are valued at its current fares, those on a
+*                  flight no longer scheduled at the fares they were sold with; the
+*                  schedule is kept for the flights nobody has booked.
+******************************************************************************************/
+struct ReportTotals {
+    std::shared_ptr<const FlightTable> table;
+    std::vector<SoldFlight> flights;
+    int     reservations = 0;
+    int     unpaid       = 0;
+    int64_t revenueCents = 0;
+};
+
+/******************************************************************************************
+* STRUCT NAME    : ReportLine
+* DESCRIPTION    : One group of a report.
+******************************************************************************************/
+struct ReportLine {
+    std::string group;
+    int     flights      = 0;   // Flights sold or scheduled in the group (with a booking, per channel)
+    int64_t bookings     = 0;
+    int64_t revenueCents = 0;
+};
+
+/******************************************************************************************
+* CLASS NAME     : ReportEngine
+* DESCRIPTION    : Splits the reservations into chunks of at least REPORT_CHUNK_RESERVATIONS
+*                  and counts each chunk on a worker into a hash map of its own, keyed by
+*                  the flight number and departure each reservation carries, so workers
+*                  never share a counter and a flight dropped from the schedule still
+*                  counts; the maps are then merged into ReportTotals. The live schedule
+*                  only supplies current fares and the flights without bookings.
+*                  Grouping reads only the totals, once per flight, so any grouping costs
+*                  O(flights) after the single pass over the reservations.
+******************************************************************************************/
+class ReportEngine {
+public:
+    /*
+    * Description: Aggregates the reservations on file against the current schedule.
+    */
+    static ReportTotals aggregate(size_t workers = REPORT_WORKERS);
+
+    /*
+    * Description: Aggregates the given reservations; agentIDs lists the reservation IDs
+    *              booked through an agent.
+    */
+    static ReportTotals aggregate(const std::vector<std::shared_ptr<Reservation>>& reservations,
+                                  const std::vector<std::string>& agentIDs,
+                                  size_t workers = REPORT_WORKERS);
+
+    /*
+    * Description: Sums the totals into one line per group, sorted by group.
+    */
+    static std::vector<ReportLine> group(const ReportTotals& totals, ReportGrouping grouping);
+
+    /*
+    * Description: Writes report lines to out; the grouping names the key column.
+    */
+    static void write(const std::vector<ReportLine>& lines, ReportGrouping grouping,
+                      ReportFormat format, std::ostream& out);
+
+    /*
+    * Description: Returns the report lines as a JSON array of objects.
+    */
+    static nlohmann::json toJson(const std::vector<ReportLine>& lines, ReportGrouping grouping);
+
+    /*
+    * Description: Parses "flight", "route", "month", "aircraft" or "channel".
+    * Returns     : false if the name is unknown.
+    */
+    static bool parseGrouping(const std::string& name, ReportGrouping& grouping);
+
+    /*
+    * Description: Parses "console", "csv" or "json".
+    * Returns     : false if the name is unknown.
+    */
+    static bool parseFormat(const std::string& name, ReportFormat& format);
+
+    /*
+    * Description: Returns the name parseGrouping accepts for a grouping.
+    */
+    static const char* name(ReportGrouping grouping);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -10,14 +10,31 @@
 #pragma once
 
 #include "Flight.hpp"
+#include "LoadArena.hpp"
+#include "ThreadPool.hpp"
 #include "json.hpp"
 #include <string>
 #include <vector>
 #include <memory>  // For shared_ptr
+#include <cstdint>
 
 #define PATH_OF_RESERVATION_DATA_BASE "data_base/reservation.json"
 #define PATH_OF_BOOKING_AGENT_RESERVATION_DATA_BASE "data_base/bookingAgentReservation.json"
 
+/* Seat number of an overbooked reservation; the real seat is assigned at check-in */
+#define OVERBOOKED_SEAT "TBA"
+
+/* Next reservation number to hand out; numbers are never reused, canceled or not */
+#define PATH_OF_RESERVATION_SEQUENCE_DATA_BASE "data_base/reservationSequence.json"
+
+/* Reservation numbers claimed from the sequence file per write (overridable at build time) */
+#ifndef RESERVATION_ID_BLOCK
+#define RESERVATION_ID_BLOCK 64
+#endif
+
+/* Fraction of tombstoned records in a reservation file that triggers a background compaction */
+#define RESERVATION_COMPACTION_THRESHOLD 0.25
+
 /***********************************************************************************************************************
  * CLASS NAME : Reservation
  * DESCRIPTION : Represents a flight reservation made by a passenger, containing flight details, payment info,
@@ -36,37 +53,45 @@ public:
      */
     Reservation(void);
 
+    /*
+     * Overwrites every field as the full constructor would, reusing the existing string
+     * buffers; lets pooled reservations be recycled without reallocating.
+     */
+    void assign(const std::string& reservationID, const std::string& passengerName,
+                std::shared_ptr<Flight> flight, const std::string& seatNumber,
+                const std::string& paymentMethod, const std::string& paymentDetails);
+
     /*
      * Gets the unique reservation ID.
 
      */
-    std::string getReservationID(void) const;
+    const std::string& getReservationID(void) const;
 
     /*
      * Gets the passenger's name.
      */
-    std::string getPassengerName(void) const;
+    const std::string& getPassengerName(void) const;
 
     /*
      * Gets the flight associated with this reservation.
      */
-    std::shared_ptr<Flight> getFlight(void) const;
+    const std::shared_ptr<Flight>& getFlight(void) const;
 
     /*
      * Gets the assigned seat number.
      */
-    std::string getSeatNumber(void) const;
+    const std::string& getSeatNumber(void) const;
 
     /*
      * Gets the payment method used.
      */
-    std::string getPaymentMethod(void) const;
+    const std::string& getPaymentMethod(void) const;
 
     /*
      * Gets additional payment details.
 
      */
-    std::string getPaymentDetails(void) const;
+    const std::string& getPaymentDetails(void) const;
 
     /*
      * Converts this reservation object to JSON format.
@@ -78,6 +103,12 @@ public:
      */
     static Reservation fromJson(const nlohmann::json& j);
 
+    /*
+     * Creates a Reservation from a record parsed into a load arena; its flight is
+     * allocated from the same arena.
+     */
+    static Reservation fromJson(const ArenaJson& j, const SharedArenaAllocator<Flight>& allocator);
+
     /*
      * Displays reservation details on the console.
      */
@@ -94,15 +125,23 @@ public:
     void displayHoldingReservation(void) const;
 
     /*
-     * Saves a list of reservations to the JSON file.
+     * Upserts the given reservations into the JSON file by ID; pass only the records
+     * created or changed, never a whole list loaded earlier. Returns false, writing
+     * nothing, if an ID is canceled or another passenger's, or if the write fails.
      */
-    static void saveReservations(const std::vector<std::shared_ptr<Reservation>>& reservations);
+    static bool saveReservations(const std::vector<std::shared_ptr<Reservation>>& reservations);
 
     /*
      * Loads all reservations from the JSON file.
      */
     static std::vector<std::shared_ptr<Reservation>> loadReservations(void);
 
+    /*
+     * Loads all reservations from the JSON file, splitting the file by user across the
+     * pool's workers. Returns the same list, in the same order, as loadReservations().
+     */
+    static std::vector<std::shared_ptr<Reservation>> loadReservations(ThreadPool& pool);
+
     /*
      * Adds a new reservation to the storage.
      */
@@ -114,9 +153,56 @@ public:
     static void removeReservation(const std::string& reservationID);
 
     /*
-     * Saves booking agent reservations to the JSON file.
+     * Tombstones a reservation in every reservation file, releasing its seat immediately.
+     * Returns true if a live reservation with this ID was found.
+     */
+    static bool cancelReservation(const std::string& reservationID);
+
+    /*
+     * Cancels an unpaid reservation whose hold lapsed; a paid one is left untouched.
+     * Returns true if the reservation was cancelled.
+     */
+    static bool expireHold(const std::string& reservationID);
+
+    /*
+     * Cancels every still-unpaid reservation of a batch (e.g. a declined group payment)
+     * with one rewrite per file. Returns the number cancelled.
+     */
+    static size_t expireHolds(const std::vector<std::string>& reservationIDs);
+
+    /*
+     * Marks unpaid reservations as paid in both files and disarms their holds; ones that
+     * were canceled meanwhile stay canceled. A non-empty paymentMethod settles only
+     * reservations paid that way. Returns the number settled; settledIDs, if given,
+     * receives their IDs.
+     */
+    static size_t confirmPayments(const std::vector<std::string>& reservationIDs,
+                                  const std::string& paymentMethod = "",
+                                  std::vector<std::string>* settledIDs = nullptr);
+
+    /*
+     * Returns a reservation ID never handed out before: "R" and a zero-padded number
+     * from the sequence in PATH_OF_RESERVATION_SEQUENCE_DATA_BASE, which is advanced a
+     * block of RESERVATION_ID_BLOCK numbers at a time. Canceled and compacted IDs are
+     * never reissued, so keys built from an ID name one reservation for good. Returns
+     * an empty string if the sequence file cannot be written. Safe from any thread.
+     */
+    static std::string nextReservationID(void);
+
+    /*
+     * Rewrites both reservation files without their tombstoned records.
+     */
+    static void compactReservations(void);
+
+    /*
+     * Blocks until any background compaction in progress has finished.
+     */
+    static void waitForCompaction(void);
+
+    /*
+     * Upserts booking agent reservations into the JSON file, as saveReservations does.
      */
-    static void saveBookingAgentReservations(const std::vector<std::shared_ptr<Reservation>>& reservations);
+    static bool saveBookingAgentReservations(const std::vector<std::shared_ptr<Reservation>>& reservations);
 
     /*
      * Adds a new booking agent reservation to storage.
@@ -138,6 +224,36 @@ public:
      */
     bool getIsPaid(void) const;
 
+    /*
+     * Returns true while a card charge for this reservation is still with the gateway.
+     */
+    bool isPaymentPending(void) const;
+
+    /*
+     * Sets when the unpaid hold lapses, in epoch seconds (0 for no hold).
+     */
+    void setHoldExpiresAt(int64_t epochSeconds);
+
+    /*
+     * Gets when the unpaid hold lapses, in epoch seconds (0 for no hold).
+     */
+    int64_t getHoldExpiresAt(void) const;
+
+    /*
+     * Sets the seat number.
+     */
+    void setSeatNumber(const std::string& seat);
+
+    /*
+     * Sets the fare class (fare bucket code) the seat was sold in.
+     */
+    void setFareClass(const std::string& code);
+
+    /*
+     * Gets the fare class; empty for bookings made before fare buckets existed.
+     */
+    const std::string& getFareClass(void) const;
+
     /*
      * Sets the payment method.
      */
@@ -156,4 +272,18 @@ private:
     std::string paymentMethod;
     std::string paymentDetails;
     bool isPaid;
+    int64_t holdExpiresAt;
+    std::string fareClass;
+
+    /*
+     * Tombstones reservations in both files, optionally only while still unpaid.
+     * Returns the number canceled.
+     */
+    static size_t cancelInFiles(const std::vector<std::string>& reservationIDs, bool onlyIfUnpaid);
+
+    /*
+     * Shared body of both fromJson overloads, given the already-built flight.
+     */
+    template <typename Json>
+    static Reservation fromJsonOf(const Json& j, std::shared_ptr<Flight> flight);
 };
@@ -0,0 +1,75 @@
+/******************************************************************************************
+* MODULE NAME    : Reservation Pool Module
+* FILE           : ReservationPool.hpp
+* DESCRIPTION    : Declares the pool that recycles the Reservation and Flight objects
+*                  created on the booking path, together with their reference counts.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "Flight.hpp"
+#include "Reservation.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/* Idle objects kept per type; objects released beyond this are freed */
+#ifndef RESERVATION_POOL_CAPACITY
+#define RESERVATION_POOL_CAPACITY 1024
+#endif
+
+/******************************************************************************************
+* STRUCT NAME    : ReservationPoolStats
+* DESCRIPTION    : How often the pool served a request from idle objects.
+******************************************************************************************/
+struct ReservationPoolStats {
+    size_t hits   = 0;      // Served from an idle object
+    size_t misses = 0;      // Had to construct a new one
+    size_t idleReservations = 0;
+    size_t idleFlights      = 0;
+};
+
+/******************************************************************************************
+* CLASS NAME     : ReservationPool
+* DESCRIPTION    : Hands out ordinary shared_ptrs whose deleter puts the object back on
+*                  an idle list instead of destroying it, and whose reference counts live
+*                  in control blocks drawn from fixed-size free lists. A recycled object
+*                  is overwritten field by field, so its strings and fare table keep their
+*                  capacity: once warm, creating a booking's reservation and flight copy
+*                  allocates nothing. Safe to use and release from any thread.
+******************************************************************************************/
+class ReservationPool {
+public:
+    /*
+    * Description: Returns a pooled copy of a flight.
+    */
+    static std::shared_ptr<Flight> makeFlight(const Flight& source);
+
+    /*
+    * Description: Returns a pooled, unpaid reservation with no hold and no fare class,
+    *              like the Reservation constructor with the same arguments.
+    */
+    static std::shared_ptr<Reservation> makeReservation(const std::string& reservationID,
+                                                        const std::string& passengerName,
+                                                        std::shared_ptr<Flight> flight,
+                                                        const std::string& seatNumber,
+                                                        const std::string& paymentMethod,
+                                                        const std::string& paymentDetails);
+
+    /*
+    * Description: Pre-builds idle objects and control blocks for the given number of
+    *              bookings (up to RESERVATION_POOL_CAPACITY).
+    */
+    static void reserve(size_t bookings);
+
+    /*
+    * Description: Returns the hit and miss counts and the current idle list sizes.
+    */
+    static ReservationPoolStats stats(void);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
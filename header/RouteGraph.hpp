@@ -0,0 +1,110 @@
+/******************************************************************************************
+* MODULE NAME    : Route Graph Module
+* FILE           : RouteGraph.hpp
+* DESCRIPTION    : Declares the RouteGraph class, a time-expanded view of the schedule
+*                  (every flight leg as a timed connection between two airports) and the
+*                  connection-scan search that finds multi-leg itineraries over it.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <shared_mutex>
+#include "SymbolTable.hpp"
+#include "FlightTable.hpp"
+
+/* Default minimum time between arriving on one leg and departing on the next */
+#define MIN_CONNECT_MINUTES 45
+
+/* Default maximum number of connections (intermediate stops) in an itinerary */
+#define MAX_CONNECTIONS 2
+
+/* Says whether a leg, by flight number, may be used; an empty filter allows every leg */
+using LegFilter = std::function<bool(const std::string& flightNumber)>;
+
+/******************************************************************************************
+* STRUCT NAME    : Itinerary
+* DESCRIPTION    : One journey found by the connection search, as an ordered list of legs.
+******************************************************************************************/
+struct Itinerary {
+    std::vector<std::string> flightNumbers;    // Legs in travel order
+    int32_t departureMinute;                   // Epoch minutes of the first departure
+    int32_t arrivalMinute;                     // Epoch minutes of the final arrival
+};
+
+/******************************************************************************************
+* CLASS NAME     : RouteGraph
+* DESCRIPTION    : Keeps all bookable legs sorted by departure time. Queries run the
+*                  Connection Scan Algorithm with one round per leg count, so each
+*                  query is a single forward pass over the time window it needs.
+*                  Legs can be added and removed in place as the schedule changes.
+*                  Queries take a shared lock and edits an exclusive one.
+******************************************************************************************/
+class RouteGraph {
+public:
+    /*
+    * Description: Replaces the whole graph with the legs of a flight table.
+    */
+    void build(const FlightTable& table);
+
+    /*
+    * Description: Adds (or replaces) the leg of one table row. Canceled flights and
+    *              flights without parseable times are not bookable and are skipped.
+    */
+    void addLeg(const FlightTable& table, size_t row);
+
+    /*
+    * Description: Removes the leg with this flight number, if present.
+    */
+    void removeLeg(const std::string& flightNumber);
+
+    /*
+    * Description: Number of legs currently in the graph.
+    */
+    size_t legCount(void) const;
+
+    /*
+    * Description: Finds the Pareto-best itineraries from origin to destination that
+    *              leave no earlier than earliestDeparture: the earliest arrival with one
+    *              leg, then with each extra connection only if it arrives sooner. Legs
+    *              the filter rejects are skipped; it runs under the graph's read lock,
+    *              so it must not edit the schedule.
+    */
+    std::vector<Itinerary> findItineraries(SymbolTable::Symbol originID,
+                                           SymbolTable::Symbol destinationID,
+                                           int32_t earliestDeparture,
+                                           const LegFilter& usable = LegFilter(),
+                                           int maxConnections = MAX_CONNECTIONS,
+                                           int32_t minConnectMinutes = MIN_CONNECT_MINUTES) const;
+
+private:
+    /*
+    * Description: A timed leg between two airports; ordered by departure minute.
+    */
+    struct Connection {
+        SymbolTable::Symbol departureStop;
+        SymbolTable::Symbol arrivalStop;
+        int32_t departureMinute;
+        int32_t arrivalMinute;
+        uint32_t legID;
+    };
+
+    void insertConnection(const Connection& connection);
+    void eraseLeg(const std::string& flightNumber);
+
+    std::vector<Connection>                   connections;   // Sorted by departureMinute
+    std::vector<std::string>                  legNumbers;    // legID -> flight number
+    std::vector<uint32_t>                     freeLegIDs;
+    std::unordered_map<std::string, uint32_t> legOf;         // flight number -> legID
+    mutable std::shared_mutex                 mutex;
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -0,0 +1,124 @@
+/******************************************************************************************
+* MODULE NAME    : Sales Ledger Module
+* FILE           : SalesLedger.hpp
+* DESCRIPTION    : Declares the SalesLedger class, which keeps running booking counts per
+*                  flight and fare class, so reports read them instead of scanning the
+*                  reservations.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "Reservation.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Where the counts are kept between runs: a snapshot, and the changes made since it,
+   one JSON object per line */
+#define PATH_OF_SALES_LEDGER_DATA_BASE     "data_base/salesLedger.json"
+#define PATH_OF_SALES_LEDGER_LOG_DATA_BASE "data_base/salesLedger.log"
+
+/* Changes appended to the log before it is folded into the snapshot */
+#ifndef SALES_LEDGER_COMPACTION_LINES
+#define SALES_LEDGER_COMPACTION_LINES 1024
+#endif
+
+/******************************************************************************************
+* STRUCT NAME    : SalesCounters
+* DESCRIPTION    : Live bookings and their value, and the part of them already paid.
+*                  Revenue is counted like ReportEngine counts it: each booking at the
+*                  current fare of its class's bucket on the flight as scheduled now.
+******************************************************************************************/
+struct SalesCounters {
+    int64_t bookings         = 0;
+    int64_t revenueCents     = 0;
+    int64_t paidBookings     = 0;
+    int64_t paidRevenueCents = 0;
+
+    bool operator==(const SalesCounters& other) const;
+};
+
+/******************************************************************************************
+* STRUCT NAME    : FlightSales
+* DESCRIPTION    : Totals of one scheduled flight, its route and month, and a breakdown
+*                  by fare bucket code.
+******************************************************************************************/
+struct FlightSales {
+    std::string   route;    // "origin-destination"
+    std::string   month;    // Departure month, "YYYY-MM"
+    SalesCounters total;
+    std::map<std::string, SalesCounters> fareClasses;
+
+    bool operator==(const FlightSales& other) const;
+};
+
+/******************************************************************************************
+* CLASS NAME     : SalesLedger
+* DESCRIPTION    : Materialized aggregates of the main reservation file. Every change the
+*                  reservation module makes to that file (a booking written, a reservation
+*                  canceled or its hold expired, a payment settled) is applied here as an
+*                  increment to the booked and paid counts of its flight and fare class,
+*                  and appended as one line to PATH_OF_SALES_LEDGER_LOG_DATA_BASE; every
+*                  SALES_LEDGER_COMPACTION_LINES lines, and on a load that replayed any,
+*                  the counts are rewritten to PATH_OF_SALES_LEDGER_DATA_BASE and the log
+*                  emptied. Lines carry a sequence number the snapshot records, so a log
+*                  left behind by an interrupted compaction is not applied twice. Only
+*                  counts are kept: totals are valued and grouped against the current
+*                  schedule when read, one visit per scheduled flight, so a scheduled
+*                  flight is valued at the same fares as in ReportEngine (which also
+*                  counts bookings on flights no longer scheduled), and a rescheduled or
+*                  repriced flight needs no bookkeeping. At startup the stored counts are
+*                  checked against the reservations and rebuilt from them if they
+*                  disagree. Safe to use from any thread.
+******************************************************************************************/
+class SalesLedger {
+public:
+    /*
+    * Description: Applies a change to the main reservation file: every record in removed
+    *              is uncounted as it stood before, every record in added counted as it
+    *              stands now. A booking is only added, a cancellation only removed, and a
+    *              rewrite (a payment settled, say) is both.
+    */
+    static void recordChanges(const std::vector<std::shared_ptr<Reservation>>& removed,
+                              const std::vector<std::shared_ptr<Reservation>>& added);
+
+    /*
+    * Description: Copies a flight's totals into sales.
+    * Returns     : false if the flight is not scheduled or has never been booked.
+    */
+    static bool flightSales(const std::string& flightNumber, FlightSales& sales);
+
+    /*
+    * Description: Returns the totals of one route ("origin-destination") or one
+    *              departure month ("YYYY-MM") over the scheduled flights.
+    */
+    static SalesCounters routeSales(const std::string& route);
+    static SalesCounters monthSales(const std::string& month);
+
+    /*
+    * Description: Returns the totals of every route or every departure month.
+    */
+    static std::map<std::string, SalesCounters> routes(void);
+    static std::map<std::string, SalesCounters> months(void);
+
+    /*
+    * Description: Loads the stored totals, checking them against reservations already
+    *              loaded from the main file. No-op once loaded.
+    */
+    static void seed(const std::vector<std::shared_ptr<Reservation>>& reservations);
+
+    /*
+    * Description: Loads the stored totals if that has not happened yet, rebuilding them
+    *              from the reservation file if there are none. Must not be called while
+    *              the reservation files are locked.
+    */
+    static void load(void);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -0,0 +1,102 @@
+/******************************************************************************************
+* MODULE NAME    : Search Cache Module
+* FILE           : SearchCache.hpp
+* DESCRIPTION    : Declares the SearchCache class, an LRU cache of direct-flight search
+*                  results keyed by the normalised query and invalidated precisely by the
+*                  flights touched when the schedule changes.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Flight.hpp"
+
+/* Maximum number of distinct queries kept in the cache */
+#define SEARCH_CACHE_CAPACITY 1024
+
+/******************************************************************************************
+* STRUCT NAME    : SearchQuery
+* DESCRIPTION    : A direct-flight search: route plus departure window in epoch minutes.
+******************************************************************************************/
+struct SearchQuery {
+    std::string origin;
+    std::string destination;
+    int32_t fromMinute = INT32_MIN;
+    int32_t toMinute   = INT32_MAX;
+
+    /*
+    * Description: Trims surrounding whitespace from the route names in place.
+    */
+    void normalize(void);
+
+    /*
+    * Description: Returns the cache key of a normalised query.
+    */
+    std::string key(void) const;
+};
+
+/******************************************************************************************
+* STRUCT NAME    : SearchCacheStats
+* DESCRIPTION    : Counters exposed for monitoring the cache.
+******************************************************************************************/
+struct SearchCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t invalidations;
+    size_t   entries;
+    size_t   memoryBytes;     // Approximate bytes held by keys and cached results
+};
+
+/******************************************************************************************
+* CLASS NAME     : SearchCache
+* DESCRIPTION    : Thread-safe LRU cache. Besides the LRU list it keeps two reverse
+*                  indexes: flight number -> queries whose result contains it, and route
+*                  -> queries on that route. A schedule change to a flight drops exactly
+*                  the queries that contained it or whose route and window now match it.
+******************************************************************************************/
+class SearchCache {
+public:
+    using Results = std::shared_ptr<const std::vector<Flight>>;
+
+    /*
+    * Description: Returns the cached results for a query, or nullptr on a miss.
+    */
+    static Results lookup(const SearchQuery& query);
+
+    /*
+    * Description: Returns the invalidation generation; read it before computing a
+    *              result and pass it to store() so a result computed from a schedule
+    *              that changed mid-way is never cached.
+    */
+    static uint64_t generation(void);
+
+    /*
+    * Description: Caches the results of a query computed at the given generation.
+    */
+    static void store(const SearchQuery& query, Results results, uint64_t computedAt);
+
+    /*
+    * Description: Drops every cached query a change to this flight could affect.
+    */
+    static void invalidateFlight(const Flight& flight);
+
+    /*
+    * Description: Empties the cache (counters are kept).
+    */
+    static void clear(void);
+
+    /*
+    * Description: Returns a snapshot of the cache counters.
+    */
+    static SearchCacheStats stats(void);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -0,0 +1,85 @@
+/******************************************************************************************
+* MODULE NAME    : Seat Hold Module
+* FILE           : SeatHold.hpp
+* DESCRIPTION    : Declares the SeatHold class, which expires unpaid (cash) reservations
+*                  after a time-to-live so their seats return to the inventory.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "Reservation.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/* How long an unpaid reservation keeps its seat, in seconds (overridable at build time) */
+#ifndef SEAT_HOLD_TTL_SECONDS
+#define SEAT_HOLD_TTL_SECONDS (24 * 60 * 60)
+#endif
+
+/* Levels of the timing wheel and slots per level, as a power of two: a slot of level k
+   spans 64^k seconds, so the three levels cover a minute, an hour and three days */
+#define SEAT_HOLD_WHEEL_LEVELS 3
+#define SEAT_HOLD_WHEEL_BITS   6
+#define SEAT_HOLD_WHEEL_SLOTS  (1 << SEAT_HOLD_WHEEL_BITS)
+
+/******************************************************************************************
+* CLASS NAME     : SeatHold
+* DESCRIPTION    : Keeps outstanding holds in a hierarchical timing wheel (seconds,
+*                  minutes, hours) driven by a background ticker. A hold is linked into
+*                  the coarsest slot it needs and moved to finer ones as its expiry
+*                  nears, so each tick does O(1) work however far out the holds are;
+*                  placing and clearing a hold are O(1). Holds that lapse together are
+*                  cancelled in one batch, which releases their seats.
+******************************************************************************************/
+class SeatHold {
+public:
+    /*
+    * Description: Loads the unpaid reservations on file into the wheel and starts the
+    *              ticker. Legacy holds without an expiry get a fresh TTL from now.
+    */
+    static void start(void);
+
+    /*
+    * Description: Starts as above from reservations already loaded from the main file.
+    */
+    static void start(const std::vector<std::shared_ptr<Reservation>>& reservations);
+
+    /*
+    * Description: Stops the ticker and waits for it to exit.
+    */
+    static void stop(void);
+
+    /*
+    * Description: Returns the expiry (epoch seconds) for a hold placed now.
+    */
+    static int64_t expiryFromNow(void);
+
+    /*
+    * Description: Says whether a hold due at expiresAt has run out; a reservation
+    *              without a hold (0) never has.
+    */
+    static bool hasLapsed(int64_t expiresAt);
+
+    /*
+    * Description: Arms the expiry of an unpaid reservation.
+    */
+    static void placeHold(const std::string& reservationID, int64_t expiresAt);
+
+    /*
+    * Description: Disarms a hold after payment or cancellation. Returns false if no
+    *              hold was pending for this reservation.
+    */
+    static bool clearHold(const std::string& reservationID);
+
+    /*
+    * Description: Returns the number of holds still pending.
+    */
+    static size_t pendingHolds(void);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
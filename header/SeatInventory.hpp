@@ -0,0 +1,91 @@
+/******************************************************************************************
+* MODULE NAME    : Seat Inventory Module
+* FILE           : SeatInventory.hpp
+* DESCRIPTION    : Declares the SeatInventory class, which keeps a live count of the seats
+*                  still available on every scheduled flight and in each of its fare
+*                  buckets.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "Flight.hpp"
+#include "Reservation.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+/******************************************************************************************
+* CLASS NAME     : SeatInventory
+* DESCRIPTION    : Holds per-flight counters of seats sold in each fare bucket, seeded once
+*                  from the schedule and the live reservations, then adjusted on booking,
+*                  cancellation, hold expiry and schedule edits. Readers never touch the
+*                  reservation files. Sales may exceed the physical seats up to the
+*                  flight's overbooking allowance, and bucket limits are nested.
+******************************************************************************************/
+class SeatInventory {
+public:
+    /*
+    * Description: Returns the physical seats still unsold on a flight (0 once it is
+    *              full or overbooked), or -1 if the flight is unknown.
+    */
+    static int seatsAvailable(const std::string& flightNumber);
+
+    /*
+    * Description: Returns how many more seats may be sold in a fare bucket, honouring
+    *              the nested limits above it and the overbooking allowance.
+    */
+    static int fareAvailability(const std::string& flightNumber, const std::string& fareClass);
+
+    /*
+    * Description: Sells `count` seats in a fare bucket if that many are open; returns
+    *              false, selling none, otherwise. An empty or unknown fare class means
+    *              the flight's first bucket.
+    */
+    static bool reserveSeat(const std::string& flightNumber, const std::string& fareClass, int count = 1);
+
+    /*
+    * Description: Gives back `count` seats of a fare bucket after a cancellation, expiry
+    *              or failed payment.
+    */
+    static void releaseSeat(const std::string& flightNumber, const std::string& fareClass, int count = 1);
+
+    /*
+    * Description: Drops flights that can sell fewer than minSeats and orders the rest
+    *              by sellable seats, most first (ties keep schedule order).
+    */
+    static void rankByAvailability(std::vector<Flight>& flights, int minSeats = 1);
+
+    /*
+    * Description: Says whether a flight can still sell minSeats, by the same count
+    *              rankByAvailability ranks on; unknown flights cannot.
+    */
+    static bool isBookable(const std::string& flightNumber, int minSeats = 1);
+
+    /*
+    * Description: Opens the inventory of a newly scheduled flight.
+    */
+    static void onFlightAdded(const Flight& flight);
+
+    /*
+    * Description: Closes the inventory of a removed flight.
+    */
+    static void onFlightRemoved(const Flight& flight);
+
+    /*
+    * Description: Applies a change in capacity, overbooking or fare table, keeping the
+    *              seats already sold in each bucket.
+    */
+    static void onFlightUpdated(const Flight& before, const Flight& after);
+
+    /*
+    * Description: Builds the counters now, from reservations already loaded from the main
+    *              file, instead of loading them on first use. No-op once seeded.
+    */
+    static void seed(const std::vector<std::shared_ptr<Reservation>>& reservations);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
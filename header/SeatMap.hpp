@@ -0,0 +1,93 @@
+/******************************************************************************************
+* MODULE NAME    : Seat Map Module
+* FILE           : SeatMap.hpp
+* DESCRIPTION    : Declares the SeatMap class, which tracks which seats of each flight are
+*                  taken and finds free seats with bit operations on per-row masks.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "Aircraft.hpp"
+#include "Flight.hpp"
+#include "Reservation.hpp"
+#include "ThreadPool.hpp"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Seat request that asks for the first free window seat */
+#define WINDOW_SEAT_REQUEST "W"
+
+/******************************************************************************************
+* CLASS NAME     : SeatMap
+* DESCRIPTION    : Keeps one 64-bit occupancy mask per row of every flight, laid out by the
+*                  CabinLayout of the flight's aircraft type (or the standard layout). A
+*                  flight's map is built on first use from its live reservations; every
+*                  claim and release afterwards is a bit flip under the flight's lock.
+*                  A map dropped for a schedule or layout change hands its taken seats to
+*                  the next build of that flight.
+******************************************************************************************/
+class SeatMap {
+public:
+    /*
+    * Description: Claims the requested seat: a label ("14A"), a legacy ordinal ("14") or
+    *              WINDOW_SEAT_REQUEST. On success seatLabel holds the canonical label.
+    * Returns     : false, with the reason printed, if the seat is invalid or taken.
+    */
+    static bool claimSeat(const Flight& flight, const std::string& request, std::string& seatLabel);
+
+    /*
+    * Description: Claims `count` side-by-side seats in one row (never across an aisle),
+    *              front rows first. Nothing is claimed unless the whole block is free.
+    */
+    static bool claimAdjacentSeats(const Flight& flight, int count, std::vector<std::string>& seatLabels);
+
+    /*
+    * Description: Seats a party of `count`, keeping it in as few side-by-side blocks as
+    *              possible (largest blocks first). All seats are claimed or none are.
+    */
+    static bool claimGroupSeats(const Flight& flight, int count, std::vector<std::string>& seatLabels);
+
+    /*
+    * Description: Frees a seat; unknown flights or labels are ignored.
+    */
+    static void releaseSeat(const std::string& flightNumber, const std::string& seatLabel);
+
+    /*
+    * Description: Finds, without claiming, the first run of `count` adjacent free seats.
+    */
+    static bool findAdjacentSeats(const Flight& flight, int count, std::vector<std::string>& seatLabels);
+
+    /*
+    * Description: Finds, without claiming, the first free window seat.
+    */
+    static bool firstFreeWindowSeat(const Flight& flight, std::string& seatLabel);
+
+    /*
+    * Description: Forgets a flight's map so it is rebuilt from the files on next use;
+    *              called when the flight or its aircraft layout changes. Seats it held
+    *              stay taken in the rebuilt map (where the new layout has them), so a
+    *              seat claimed for a booking not yet saved cannot be sold twice.
+    */
+    static void invalidate(const std::string& flightNumber);
+
+    /*
+    * Description: Forgets every flight's map, keeping their seats like invalidate().
+    */
+    static void reset(void);
+
+    /*
+    * Description: Builds the map of every scheduled flight up front from reservations
+    *              and aircraft already loaded, spreading the flights over the pool. Maps
+    *              that already exist are kept.
+    */
+    static void prebuild(const std::vector<std::shared_ptr<Reservation>>& reservations,
+                         const std::map<std::string, Aircraft>& fleet, ThreadPool& pool);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -0,0 +1,59 @@
+/******************************************************************************************
+* MODULE NAME    : Startup Loader Module
+* FILE           : StartupLoader.hpp
+* DESCRIPTION    : Declares the StartupLoader class, which reads the data files and builds
+*                  the in-memory indexes on a thread pool before the first request.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include "Reservation.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/* Worker threads of the startup load; 0 starts one per hardware thread */
+#ifndef STARTUP_LOADER_WORKERS
+#define STARTUP_LOADER_WORKERS 0
+#endif
+
+/******************************************************************************************
+* STRUCT NAME    : StartupData
+* DESCRIPTION    : What the startup load read, for callers that would otherwise read the
+*                  same files again, and how long each phase took.
+******************************************************************************************/
+struct StartupData {
+    std::vector<std::shared_ptr<Reservation>> reservations;       // Main reservation file
+    size_t  workers = 0;
+    int64_t loadMs  = 0;    // Every data file parsed
+    int64_t indexMs = 0;    // Seat inventory, sales ledger, seat maps and hold wheel built
+};
+
+/******************************************************************************************
+* CLASS NAME     : StartupLoader
+* DESCRIPTION    : Loads in two phases on a pool that lives only for the load. First the
+*                  flight schedule and route graph and the aircraft are parsed side by
+*                  side while the reservation file, the largest, is split by user across
+*                  the same workers. Then the seat inventory is seeded, the sales ledger
+*                  is checked and every flight's seat map is built, again in parallel,
+*                  from the reservations already in memory. Only once all of them are
+*                  published is the hold wheel seeded and its ticker started, so a hold
+*                  that lapses is released into indexes that can record it. The user,
+*                  crew and booking agent files stay with the login, the crew menu and
+*                  the reports, which read them on demand.
+******************************************************************************************/
+class StartupLoader {
+public:
+    /*
+    * Description: Runs the load with the given number of workers (0 for one per
+    *              hardware thread) and starts the hold ticker. Call once, before serving.
+    */
+    static StartupData run(size_t workers = STARTUP_LOADER_WORKERS);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -0,0 +1,56 @@
+/******************************************************************************************
+* MODULE NAME    : Symbol Table Module
+* FILE           : SymbolTable.hpp
+* DESCRIPTION    : Declares the SymbolTable class, a process-wide string interner that maps
+*                  low-cardinality strings (airport codes, aircraft types, statuses) to
+*                  small integer IDs so records can store and compare integers.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/******************************************************************************************
+* CLASS NAME     : SymbolTable
+* DESCRIPTION    : Interns strings into dense IDs. Interned strings are never released, so
+*                  references returned by name() stay valid for the life of the program.
+*                  All methods are thread-safe.
+******************************************************************************************/
+class SymbolTable {
+public:
+    using Symbol = std::uint32_t;
+
+    /*
+    * ID returned by find() for strings that were never interned.
+    */
+    static constexpr Symbol INVALID_SYMBOL = UINT32_MAX;
+
+    /*
+    * Description: Returns the ID of a string, interning it on first use.
+    */
+    static Symbol intern(std::string_view text);
+
+    /*
+    * Description: Returns the ID of an already interned string, or INVALID_SYMBOL.
+    *              Never inserts, so lookups of user input cannot grow the table.
+    */
+    static Symbol find(std::string_view text);
+
+    /*
+    * Description: Returns the string an ID was interned from.
+    */
+    static const std::string& name(Symbol id);
+
+    /*
+    * Description: Returns the number of distinct strings interned so far.
+    */
+    static std::size_t size(void);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
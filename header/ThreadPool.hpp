@@ -0,0 +1,84 @@
+/******************************************************************************************
+* MODULE NAME    : Thread Pool Module
+* FILE           : ThreadPool.hpp
+* DESCRIPTION    : Declares the ThreadPool class, a fixed set of worker threads fed from a
+*                  shared FIFO task queue.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/******************************************************************************************
+* CLASS NAME     : ThreadPool
+* DESCRIPTION    : Runs submitted tasks on a fixed number of workers in submission order.
+*                  Destroying the pool finishes every queued task before joining.
+******************************************************************************************/
+class ThreadPool {
+public:
+    /*
+    * Constructor: Starts `workers` threads (at least one).
+    */
+    explicit ThreadPool(size_t workers);
+
+    /*
+    * Destructor: Runs the remaining tasks, then joins the workers.
+    */
+    ~ThreadPool(void);
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /*
+    * Description: Queues a task; returns false once the pool is shutting down.
+    */
+    bool submit(std::function<void()> task);
+
+    /*
+    * Description: Blocks until the queue is empty and no task is running.
+    */
+    void wait(void);
+
+    /*
+    * Description: Runs a batch of tasks on the workers and blocks until every one of
+    *              them has finished, leaving other queued work alone; the first exception
+    *              a task throws is rethrown here. Must not be called from a worker.
+    */
+    void runAll(std::vector<std::function<void()>> batch);
+
+    /*
+    * Description: Returns the number of worker threads.
+    */
+    size_t size(void) const;
+
+    /*
+    * Description: Returns the number of tasks queued or running.
+    */
+    size_t pending(void) const;
+
+private:
+    std::vector<std::thread>          workers;
+    std::deque<std::function<void()>> tasks;
+    mutable std::mutex                queueMutex;
+    std::condition_variable           taskReady;
+    std::condition_variable           allIdle;
+    size_t                            running;
+    bool                              stopping;
+
+    /*
+    * Description: Body of each worker: pop and run tasks until stopped and drained.
+    */
+    void workerLoop(void);
+};
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -0,0 +1,123 @@
+/******************************************************************************************
+* MODULE NAME    : Tracer Module
+* FILE           : Tracer.hpp
+* DESCRIPTION    : Declares the span tracer, which records nested timed spans into
+*                  per-thread ring buffers and writes them as Chrome trace-event JSON.
+* AUTHOR         : Hassan Darwish
+* DATE CREATED   : May 2025
+******************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/* Build with -DAIRLINE_TRACING=0 to compile every span out */
+#ifndef AIRLINE_TRACING
+#define AIRLINE_TRACING 1
+#endif
+
+/* Spans kept per thread; once full, the oldest are overwritten */
+#ifndef TRACE_RING_CAPACITY
+#define TRACE_RING_CAPACITY 65536
+#endif
+
+/* Environment variable naming the trace file written at exit */
+#define TRACE_ENVIRONMENT_VARIABLE "AIRLINE_TRACE"
+
+/******************************************************************************************
+* STRUCT NAME    : TraceEvent
+* DESCRIPTION    : One finished span. The name must outlive the tracer (a string literal).
+******************************************************************************************/
+struct TraceEvent {
+    const char* name;
+    uint64_t    startNs;      // Since the tracer's epoch
+    uint64_t    durationNs;
+};
+
+/******************************************************************************************
+* CLASS NAME     : Tracer
+* DESCRIPTION    : Each thread appends to its own ring buffer, so recording a span takes
+*                  no lock and no allocation; a thread's ring is allocated the first time
+*                  it records and outlives the thread, so spans of finished workers still
+*                  reach the trace. flush() writes every ring as "X" (complete) events
+*                  that a trace viewer (chrome://tracing, Perfetto) nests by time.
+******************************************************************************************/
+class Tracer {
+public:
+    /*
+    * Description: Turns recording on or off at run time.
+    */
+    static void setEnabled(bool on);
+
+    /*
+    * Description: Returns whether recording is on.
+    */
+    static bool enabled(void) { return recording.load(std::memory_order_relaxed); }
+
+    /*
+    * Description: Returns nanoseconds since the tracer's epoch.
+    */
+    static uint64_t now(void);
+
+    /*
+    * Description: Appends a finished span to the calling thread's ring.
+    */
+    static void record(const char* name, uint64_t startNs, uint64_t durationNs);
+
+    /*
+    * Description: Writes every recorded span as Chrome trace-event JSON. Returns false
+    *              on I/O error. Spans recorded while flushing may be missed.
+    */
+    static bool flush(const std::string& path);
+
+    /*
+    * Description: Enables recording if TRACE_ENVIRONMENT_VARIABLE is set and flushes to
+    *              the file it names when the process exits.
+    */
+    static void configureFromEnvironment(void);
+
+private:
+    static std::atomic<bool> recording;
+};
+
+/******************************************************************************************
+* CLASS NAME     : TraceSpan
+* DESCRIPTION    : Records its own lifetime as a span when tracing is on.
+******************************************************************************************/
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* spanName)
+        : name(spanName), startNs(Tracer::enabled() ? Tracer::now() : 0)
+    {
+    }
+
+    ~TraceSpan(void)
+    {
+        if (startNs)
+            Tracer::record(name, startNs, Tracer::now() - startNs);
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    uint64_t    startNs;
+};
+
+/*
+* Description: Traces the rest of the enclosing scope under the given name.
+*/
+#if AIRLINE_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SPAN(name) TraceSpan TRACE_CONCAT(traceSpan_, __LINE__)(name)
+#else
+#define TRACE_SPAN(name) ((void)0)
+#endif
+
+/******************************************************************************************
+* END OF FILE
+******************************************************************************************/
@@ -35,12 +35,12 @@ public:
     /*
      * Gets the username of the user.
      */
-    std::string getUsername(void) const;
+    const std::string& getUsername(void) const;
 
     /*
      * Gets the role of the user.
      */
-    std::string getRole(void) const;
+    const std::string& getRole(void) const;
 
     /*
      * Validates the login credentials.
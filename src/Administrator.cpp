@@ -8,6 +8,9 @@
  ******************************************************************************************/
 
 #include "../header/Administrator.hpp"
+#include "../header/SeatMap.hpp"
+#include "../header/Metrics.hpp"
+#include "../header/SalesLedger.hpp"
 #include <iostream>
 #include <vector>
 #include <fstream>
@@ -22,7 +25,7 @@ std::vector<Flight> flights;  // Store flights in memory (can later sync with fi
  * Constructor: Initializes Administrator and loads existing flights.
  */
 Administrator::Administrator(std::string username, std::string password)
-    : User(username, password, "Administrator")
+    : User(std::move(username), std::move(password), "Administrator")
 {
     flights = Flight::loadFlights(PATH_OF_FLIGHTS_DATA_BASE);
 }
@@ -219,9 +222,10 @@ void Administrator::updateFlight(void)
     std::cout << "\nEnter the flight number to update: ";
     std::cin >> flightNumberToUpdate;
 
-    std::cout << "\nWhich field to update? (1-8)\n"
+    std::cout << "\nWhich field to update? (1-10)\n"
               << "1.Departure Time 2.Arrival Time 3.Status 4.Origin\n"
               << "5.Destination    6.Aircraft Type   7.Total Seats 8.Flight Price\n"
+              << "9.Fare Buckets   10.Overbooking %\n"
               << "Enter choice: ";
     int fieldChoice;
     std::cin >> fieldChoice;
@@ -237,6 +241,8 @@ void Administrator::updateFlight(void)
         case 6: fieldName = "aircraftType";  break;
         case 7: fieldName = "totalSeats";    break;
         case 8: fieldName = "flightPrice";   break;
+        case 9: fieldName = "fareBuckets";   break;
+        case 10: fieldName = "overbookingPercent"; break;
         default:
             std::cout << "Invalid selection!\n";
             return;
@@ -250,6 +256,12 @@ void Administrator::updateFlight(void)
         std::cin >> seats;
         newValue = std::to_string(seats);
     }
+    else if (fieldName == "fareBuckets")
+    {
+        std::cout << "Enter fare buckets, highest fare first (CODE:PRICE:LIMIT,...\n"
+                  << "e.g. Y:300$:700,M:200$:400,Q:120$:150): ";
+        std::cin >> newValue;
+    }
     else
     {
         std::cout << "Enter new value for " << fieldName << ": ";
@@ -297,7 +309,8 @@ void Administrator::removeFlight(void)
 }
 
 /**
- * Generates an operational report for a given month-year.
+ * Generates an operational report for a given month-year. Every sales figure comes
+ * from the sales ledger, one lookup per scheduled flight; no reservation is read.
  */
 void Administrator::generateOperationalReport(void)
 {
@@ -310,64 +323,97 @@ void Administrator::generateOperationalReport(void)
     std::getline(ss, month, '-');
     std::getline(ss, year);
 
-    int totalFlightsScheduled = 0,
-        flightsCompleted      = 0,
-        flightsDelayed        = 0,
-        flightsCanceled       = 0,
-        totalReservationsMade = 0;
-    double totalRevenue = 0.0;
-
-    std::map<std::string, double> flightRevenue;
-    std::map<std::string, int>    flightReservations;
-
-    for (auto const& fl : flights)
-    {
-        ++totalFlightsScheduled;
+    METRIC_SCOPE("Administrator::generateOperationalReport");
 
-        auto status = fl.getStatus();
-        if      (status == "Scheduled") ++flightsCompleted;
-        else if (status == "Delayed")   ++flightsDelayed;
-        else if (status == "Canceled")  ++flightsCanceled;
+    // Status totals come straight from the registry's live counters
+    int totalFlightsScheduled = FlightRegistry::totalFlights(),
+        flightsCompleted      = FlightRegistry::statusCount(FlightStatus::Completed),
+        flightsDelayed        = FlightRegistry::statusCount(FlightStatus::Delayed),
+        flightsCanceled       = FlightRegistry::statusCount(FlightStatus::Canceled);
 
-        auto reservations = Reservation::loadReservations();
-        int countForFlight = 0;
+    SalesCounters totals;
+    std::map<std::string, SalesCounters> flightTotals, bucketTotals;
 
-        for (auto const& resptr : reservations)
+    auto table = FlightRegistry::table();
+    for (size_t row = 0; row < table->size(); ++row)
+    {
+        const auto& number = table->getFlightNumber(row);
+        SalesCounters& flight = flightTotals[number];
+
+        FlightSales sales;
+        if (!SalesLedger::flightSales(number, sales))
+            continue;
+
+        flight = sales.total;
+        totals.bookings         += sales.total.bookings;
+        totals.revenueCents     += sales.total.revenueCents;
+        totals.paidBookings     += sales.total.paidBookings;
+        totals.paidRevenueCents += sales.total.paidRevenueCents;
+        for (auto const& fareClass : sales.fareClasses)
         {
-            if (resptr->getFlight()->getFlightNumber() == fl.getFlightNumber())
-            {
-                ++countForFlight;
-            }
+            bucketTotals[fareClass.first].bookings     += fareClass.second.bookings;
+            bucketTotals[fareClass.first].revenueCents += fareClass.second.revenueCents;
         }
-
-        double price   = std::stod(fl.getflightPrice());
-        double revenue = countForFlight * price;
-
-        totalRevenue += revenue;
-        flightRevenue[fl.getFlightNumber()]   = revenue;
-        flightReservations[fl.getFlightNumber()] = countForFlight;
-        totalReservationsMade += countForFlight;
     }
 
+    SalesCounters departing = SalesLedger::monthSales(year + "-" + month);
+
     std::cout << "\nGenerating Operational Report for " << monthYear << "...\n\n"
               << "Report Summary:\n"
               << "- Total Flights Scheduled: " << totalFlightsScheduled << '\n'
               << "- Flights Completed:        " << flightsCompleted      << '\n'
               << "- Flights Delayed:          " << flightsDelayed        << '\n'
               << "- Flights Canceled:         " << flightsCanceled       << '\n'
-              << "- Total Reservations Made:  " << totalReservationsMade << '\n'
+              << "- Total Reservations Made:  " << totals.bookings       << '\n'
               << "- Total Revenue: $"
-              << std::fixed << std::setprecision(2) << totalRevenue << "\n\n"
+              << std::fixed << std::setprecision(2) << totals.revenueCents / 100.0 << '\n'
+              << "- Revenue Collected: $"      << totals.paidRevenueCents / 100.0
+              << " (" << totals.paidBookings << " paid)\n"
+              << "- Departing " << monthYear << ": " << departing.bookings
+              << " reservations, $" << departing.revenueCents / 100.0 << "\n\n"
               << "Detailed Flight Performance:\n";
 
     int idx = 1;
-    for (auto const& entry : flightRevenue)
+    for (auto const& entry : flightTotals)
     {
         std::cout << idx++ << ". Flight " << entry.first
-                  << ": Reservations: " << flightReservations[entry.first]
-                  << ", Revenue: $"    << entry.second << '\n';
+                  << ": Reservations: " << entry.second.bookings
+                  << ", Revenue: $"    << entry.second.revenueCents / 100.0 << '\n';
+    }
+
+    std::cout << "\nRevenue by Fare Bucket:\n";
+    for (auto const& entry : bucketTotals)
+    {
+        std::cout << "- " << entry.first
+                  << ": Reservations: " << entry.second.bookings
+                  << ", Revenue: $"    << entry.second.revenueCents / 100.0 << '\n';
+    }
+
+    std::cout << "\nBookings by route:\n";
+    for (auto const& entry : SalesLedger::routes())
+    {
+        std::cout << "- " << entry.first
+                  << ": Reservations: " << entry.second.bookings
+                  << ", Revenue: $"    << entry.second.revenueCents / 100.0 << '\n';
     }
 
+    std::cout << "\nBookings by departure month:\n";
+    for (auto const& entry : SalesLedger::months())
+    {
+        std::cout << "- " << entry.first
+                  << ": Reservations: " << entry.second.bookings
+                  << ", Revenue: $"    << entry.second.revenueCents / 100.0 << '\n';
+    }
+
+    SearchCacheStats cache = SearchCache::stats();
+    uint64_t lookups = cache.hits + cache.misses;
+    std::cout << "\nSearch Cache:\n"
+              << "- Entries: " << cache.entries << " (~" << cache.memoryBytes << " bytes)\n"
+              << "- Hits / Misses: " << cache.hits << " / " << cache.misses
+              << " (hit rate " << (lookups ? 100.0 * cache.hits / lookups : 0.0) << "%)\n"
+              << "- Evictions: " << cache.evictions
+              << ", Invalidations: " << cache.invalidations << '\n';
+
     std::cout << "\nReport generated successfully!\n";
 }
 
@@ -583,7 +629,7 @@ void Administrator::editAircraft(void)
     std::string aircraftID;
     std::cin >> aircraftID;
 
-    std::cout << "Enter the field to update (aircraftType, capacity, maintenanceDetails): ";
+    std::cout << "Enter the field to update (aircraftType, capacity, maintenanceDetails, cabinLayout): ";
     std::string field, newValue;
     std::cin >> field;
 
@@ -599,7 +645,11 @@ void Administrator::editAircraft(void)
     );
 
     if (ok)
+    {
+        // Flights of this type pick the new layout up when their seat maps are rebuilt
+        SeatMap::reset();
         std::cout << "Aircraft (" << aircraftID << ") updated successfully.\n";
+    }
     else
         std::cout << "Failed to update aircraft " << aircraftID << ".\n";
 }
@@ -8,6 +8,8 @@
  ******************************************************************************************/
 
 #include "../header/Aircraft.hpp"
+#include "../header/Metrics.hpp"
+#include "../header/MemoryAccounting.hpp"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -20,20 +22,20 @@ using json = nlohmann::json;
 /**
  * Constructor: Initializes an Aircraft with ID, type, capacity, and maintenance info.
  */
-Aircraft::Aircraft(const string& id,
-                   const string& type,
+Aircraft::Aircraft(string id,
+                   string type,
                    int cap,
                    shared_ptr<Maintenance> maint)
-    : aircraftID(id),
-      aircraftType(type),
+    : aircraftID(move(id)),
+      aircraftType(move(type)),
       capacity(cap),
-      maintenance(maint)
+      maintenance(move(maint))
 {}
 
 /**
  * Getter: Returns the aircraft’s unique ID.
  */
-string Aircraft::getAircraftID(void) const
+const string& Aircraft::getAircraftID(void) const
 {
     return aircraftID;
 }
@@ -41,7 +43,7 @@ string Aircraft::getAircraftID(void) const
 /**
  * Getter: Returns the aircraft’s type/model.
  */
-string Aircraft::getAircraftType(void) const
+const string& Aircraft::getAircraftType(void) const
 {
     return aircraftType;
 }
@@ -57,7 +59,7 @@ int Aircraft::getCapacity(void) const
 /**
  * Getter: Returns the associated Maintenance object (if any).
  */
-shared_ptr<Maintenance> Aircraft::getMaintenance(void) const
+const shared_ptr<Maintenance>& Aircraft::getMaintenance(void) const
 {
     return maintenance;
 }
@@ -103,6 +105,11 @@ void Aircraft::displayAircraftInfo(void) const
          << "Aircraft Type:  " << aircraftType << endl
          << "Capacity:       " << capacity     << endl;
 
+    for (auto const& section : cabinLayout.getSections()) {
+        cout << "Cabin:          " << section.cabinClass << ", "
+             << section.rows << " rows of " << section.pattern << endl;
+    }
+
     if (maintenance) {
         maintenance->logMaintenance();
     }
@@ -111,6 +118,47 @@ void Aircraft::displayAircraftInfo(void) const
     }
 }
 
+/**
+ * Getter: Returns the configured cabin layout.
+ */
+const CabinLayout& Aircraft::getCabinLayout(void) const
+{
+    return cabinLayout;
+}
+
+/**
+ * Setter: Replaces the cabin layout.
+ */
+void Aircraft::setCabinLayout(CabinLayout layout)
+{
+    cabinLayout = move(layout);
+}
+
+/**
+ * Looks up the first aircraft of the given type that has a layout.
+ */
+bool Aircraft::findCabinLayout(const string& aircraftType, CabinLayout& layout)
+{
+    map<string, Aircraft> records;
+    loadAircraftData(PATH_OF_AIR_CRAFT_DATA_BASE, records);
+    return findCabinLayout(records, aircraftType, layout);
+}
+
+/**
+ * The first aircraft of the type that has a layout configured supplies it.
+ */
+bool Aircraft::findCabinLayout(const map<string, Aircraft>& records, const string& aircraftType,
+                               CabinLayout& layout)
+{
+    for (auto const& entry : records) {
+        if (entry.second.getAircraftType() == aircraftType && !entry.second.getCabinLayout().empty()) {
+            layout = entry.second.getCabinLayout();
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * Converts this Aircraft object into a JSON representation.
  */
@@ -121,12 +169,16 @@ json Aircraft::toJson(void) const
         maintJson = maintenance->toJson();
     }
 
-    return json{
+    json j{
         {"aircraftID",   aircraftID},
         {"aircraftType", aircraftType},
         {"capacity",     capacity},
         {"maintenance",  maintJson}
     };
+    if (!cabinLayout.empty()) {
+        j["cabinLayout"] = cabinLayout.toJson();
+    }
+    return j;
 }
 
 /**
@@ -135,6 +187,8 @@ json Aircraft::toJson(void) const
 void Aircraft::loadAircraftData(const string& filename,
                                 map<string, Aircraft>& aircraftRecords)
 {
+    METRIC_SCOPE("Aircraft::loadAircraftData");
+    MEMORY_TAG(Aircraft);
     ifstream file(filename);
     if (!file.is_open()) {
         cerr << "Error: Unable to open aircraft data file.\n";
@@ -143,6 +197,7 @@ void Aircraft::loadAircraftData(const string& filename,
 
     json aircraftJson;
     try {
+        MEMORY_TAG(Json);
         file >> aircraftJson;
     }
     catch (const json::parse_error& e) {
@@ -150,18 +205,19 @@ void Aircraft::loadAircraftData(const string& filename,
         return;
     }
     file.close();
+    METRIC_RECORDS(aircraftJson.size());
 
     for (auto& item : aircraftJson.items()) {
-        string id           = item.key();
-        auto   data         = item.value();
+        const string& id   = item.key();
+        auto const&   data = item.value();
         shared_ptr<Maintenance> maintPtr;
 
-        if (data.contains("maintenance") && !data["maintenance"].is_null()) {
-            auto m = data["maintenance"];
-            if (m.contains("maintenanceDetails") && !m["maintenanceDetails"].is_null()) {
+        if (data.contains("maintenance") && !data.at("maintenance").is_null()) {
+            auto const& m = data.at("maintenance");
+            if (m.contains("maintenanceDetails") && !m.at("maintenanceDetails").is_null()) {
                 maintPtr = make_shared<Maintenance>(
-                    m["aircraftID"].get<string>(),
-                    m["maintenanceDetails"].get<string>()
+                    m.at("aircraftID").get<string>(),
+                    m.at("maintenanceDetails").get<string>()
                 );
             }
             else {
@@ -172,12 +228,22 @@ void Aircraft::loadAircraftData(const string& filename,
 
         Aircraft aircraft(
             id,
-            data["aircraftType"].get<string>(),
-            data["capacity"].get<int>(),
-            maintPtr
+            data.at("aircraftType").get<string>(),
+            data.at("capacity").get<int>(),
+            move(maintPtr)
         );
 
-        aircraftRecords[id] = aircraft;
+        if (data.contains("cabinLayout")) {
+            CabinLayout layout;
+            if (CabinLayout::fromJson(data.at("cabinLayout"), layout)) {
+                aircraft.setCabinLayout(move(layout));
+            }
+            else {
+                cerr << "Warning: Invalid cabin layout for aircraft " << id << ".\n";
+            }
+        }
+
+        aircraftRecords.insert_or_assign(id, move(aircraft));
     }
 }
 
@@ -235,6 +301,14 @@ bool Aircraft::editAircraft(const string& filename,
             return false;
         }
     }
+    else if (fieldToUpdate == "cabinLayout") {
+        CabinLayout layout;
+        if (!CabinLayout::parse(newValue, layout)) {
+            cout << "Error: Invalid cabin layout (expected Class:ROWS:PATTERN,...).\n";
+            return false;
+        }
+        ac.setCabinLayout(layout);
+    }
     else if (fieldToUpdate == "maintenanceStatus") {
         auto maintPtr = ac.getMaintenance();
         if (maintPtr) {
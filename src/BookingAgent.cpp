@@ -9,11 +9,18 @@
  ******************************************************************************************/
 
 #include "../header/BookingAgent.hpp"
+#include "../header/SeatInventory.hpp"
+#include "../header/SeatHold.hpp"
+#include "../header/SeatMap.hpp"
+#include "../header/IdempotencyIndex.hpp"
+#include "../header/ReservationPool.hpp"
+#include "../header/Tracer.hpp"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <cstdlib>
 #include <ctime>
+#include <limits>
 
 using namespace std;
 using json = nlohmann::json;
@@ -22,11 +29,19 @@ using json = nlohmann::json;
  * Constructor: Initializes BookingAgent and loads existing reservations.
  */
 BookingAgent::BookingAgent(string username, string password)
-    : User(username, password, "BookingAgent")
+    : User(move(username), move(password), "BookingAgent")
 {
     reservations = Reservation::loadReservations();
 }
 
+/**
+ * Constructor: Initializes BookingAgent with reservations the caller already loaded.
+ */
+BookingAgent::BookingAgent(string username, string password, vector<shared_ptr<Reservation>> loaded)
+    : User(move(username), move(password), "BookingAgent"), reservations(move(loaded))
+{
+}
+
 /**
  * Displays the main menu and dispatches user choices.
  */
@@ -35,13 +50,17 @@ void BookingAgent::displayMenu(void)
     int choice;
     do
     {
+        // Outcomes of card charges settled since the last prompt
+        Payment::printNotices();
+
         cout << "\n--- Booking Agent Menu ---\n"
              << "1. Search Flights\n"
              << "2. Book a Flight\n"
              << "3. View My Reservations\n"
              << "4. Modify Reservation\n"
              << "5. Cancel Reservation\n"
-             << "6. Logout\n"
+             << "6. Group Booking\n"
+             << "7. Logout\n"
              << "Enter choice: ";
         cin >> choice;
 
@@ -51,11 +70,12 @@ void BookingAgent::displayMenu(void)
             case 2: bookFlight();               break;
             case 3: viewSpecificReservations(); break;
             case 5: cancelReservation();        break;
-            case 6: cout << "Logging out...\n"; break;
+            case 6: bookGroup();                break;
+            case 7: cout << "Logging out...\n"; break;
             default: cout << "Invalid choice! Please try again.\n"; break;
         }
     }
-    while (choice != 6);
+    while (choice != 7);
 }
 
 /**
@@ -72,18 +92,42 @@ void BookingAgent::searchFlights(void)
     cout << "Enter Destination: ";
     getline(cin, destination);
 
-    auto flights = Flight::loadFlights(PATH_OF_FLIGHTS_DATA_BASE);
-    vector<Flight> matches;
-
-    for (auto const& fl : flights)
-    {
-        if (fl.getOrigin() == origin && fl.getDestination() == destination)
-            matches.push_back(fl);
-    }
+    // Direct flights come from the search cache; sold-out ones are hidden and the rest
+    // listed with the most seats left first. The snapshot serves connections.
+    vector<Flight> matches = *FlightRegistry::findDirectFlights(origin, destination);
+    SeatInventory::rankByAvailability(matches);
+    auto table          = FlightRegistry::table();
+    auto originID       = SymbolTable::find(origin);
+    auto destinationID  = SymbolTable::find(destination);
 
     if (matches.empty())
     {
-        cout << "No flights found for the given criteria.\n";
+        // No direct flight: fall back to itineraries with up to MAX_CONNECTIONS stops that
+        // have not left yet, over legs with a seat to sell
+        auto itineraries = FlightRegistry::routes().findItineraries(
+            originID, destinationID, FlightTable::currentMinute(),
+            [](const string& number) { return SeatInventory::isBookable(number); });
+        if (itineraries.empty())
+        {
+            cout << "No flights found for the given criteria.\n";
+            return;
+        }
+
+        cout << "\nNo direct flights. Connecting itineraries:\n";
+        for (size_t i = 0; i < itineraries.size(); ++i)
+        {
+            auto const& legs = itineraries[i].flightNumbers;
+            cout << i + 1 << ". " << legs.size() - 1 << " connection(s): ";
+            for (size_t l = 0; l < legs.size(); ++l)
+                cout << legs[l] << (l + 1 < legs.size() ? " -> " : "\n");
+
+            for (auto const& number : legs)
+            {
+                long row = table->findRow(number);
+                if (row >= 0)
+                    table->row(static_cast<size_t>(row)).displayFlightInfo();
+            }
+        }
         return;
     }
 
@@ -97,13 +141,15 @@ void BookingAgent::searchFlights(void)
 }
 
 /**
- * Generates a random reservation ID: Letter + 3-digit number.
+ * Upserts reservations into the main file and, if that took, the agent's file. The main
+ * file holds every booking, so its outcome decides whether the booking stands.
  */
-string BookingAgent::generateRandomReservationID(void)
+static bool saveToBothFiles(const vector<shared_ptr<Reservation>>& changed)
 {
-    char letter = 'A' + rand() % 26;
-    int  num    = rand() % 900 + 100;
-    return string(1, letter) + to_string(num);
+    if (!Reservation::saveReservations(changed))
+        return false;
+    Reservation::saveBookingAgentReservations(changed);
+    return true;
 }
 
 /**
@@ -116,12 +162,15 @@ void BookingAgent::bookFlight(void)
     cin >> flightNumber;
     if (flightNumber == "0") return;
 
-    auto flightsVec = Flight::loadFlights(PATH_OF_FLIGHTS_DATA_BASE);
+    // Covers seat claim, inventory, payment and save as child spans
+    TRACE_SPAN("BookingAgent::bookFlight");
+
+    auto table = FlightRegistry::table();
+    long row   = table->findRow(flightNumber);
     shared_ptr<Flight> selected;
 
-    for (auto const& fl : flightsVec)
-        if (fl.getFlightNumber() == flightNumber)
-            selected = make_shared<Flight>(fl);
+    if (row >= 0)
+        selected = ReservationPool::makeFlight(table->row(static_cast<size_t>(row)));
 
     if (!selected)
     {
@@ -129,61 +178,272 @@ void BookingAgent::bookFlight(void)
         return;
     }
 
-    cout << "Enter Seat Number (e.g., 14): ";
-    string seat;
-    cin >> seat;
+    string fareClass;
+    if (!selectFareBucket(*selected, fareClass))
+        return;
 
-    if (stoi(seat) > selected->getTotalSeats())
+    string resID = Reservation::nextReservationID();
+    if (resID.empty())
     {
-        cout << "Invalid seat number. Must be ≤ "
-             << selected->getTotalSeats() << ".\n";
+        cout << "No reservation number could be issued. Booking cancelled.\n";
         return;
     }
 
-    bool occupied = false;
-    auto agentRes = Reservation::loadBookingAgentReservations();
-    for (auto const& res : agentRes)
+    string seat = OVERBOOKED_SEAT;
+    if (SeatInventory::seatsAvailable(flightNumber) > 0)
     {
-        if (res->getFlight()->getFlightNumber() == flightNumber &&
-            res->getSeatNumber() == seat)
-        {
-            occupied = true;
-            break;
-        }
+        cout << "Enter Seat (e.g., 14A, or " << WINDOW_SEAT_REQUEST << " for a window seat): ";
+        string request;
+        cin >> request;
+
+        if (!SeatMap::claimSeat(*selected, request, seat))
+            return;
+    }
+    else
+    {
+        // Every physical seat is sold; the overbooking allowance still lets this fare sell
+        cout << "All seats are taken; a seat will be assigned at check-in.\n";
     }
 
-    if (occupied)
+    if (!SeatInventory::reserveSeat(flightNumber, fareClass))
     {
-        cout << "Seat " << seat << " already reserved. Choose another.\n";
+        SeatMap::releaseSeat(flightNumber, seat);
+        cout << "Fare class " << fareClass << " on flight " << flightNumber << " is sold out.\n";
         return;
     }
 
-    srand(time(nullptr));
-    string resID = generateRandomReservationID();
-    auto newRes  = make_shared<Reservation>(
+    auto newRes = ReservationPool::makeReservation(
         resID, username, selected, seat, "", ""
     );
+    newRes->setFareClass(fareClass);
+
+    if (!Payment::processPayment(newRes))
+    {
+        cout << "Payment failed. Booking aborted.\n";
+        SeatInventory::releaseSeat(flightNumber, fareClass);
+        SeatMap::releaseSeat(flightNumber, seat);
+        return;
+    }
 
-    bool paid = Payment::processPayment(newRes);
-    if (paid && newRes->getIsPaid())
+    // Only the new record is written, so settlements made meanwhile are left alone
+    if (!newRes->getIsPaid())
+        newRes->setHoldExpiresAt(SeatHold::expiryFromNow());
+    if (!saveToBothFiles({ newRes }))
+    {
+        cout << "Reservation could not be saved. Booking aborted.\n";
+        SeatInventory::releaseSeat(flightNumber, fareClass);
+        SeatMap::releaseSeat(flightNumber, seat);
+        return;
+    }
+
+    if (newRes->getIsPaid())
     {
-        agentRes.push_back(newRes);
-        Reservation::saveReservations(agentRes);
-        Reservation::saveBookingAgentReservations(agentRes);
         cout << "Reservation successful!\n";
         newRes->displayReservation();
     }
-    else if (!newRes->getIsPaid())
+    else if (newRes->isPaymentPending())
+    {
+        // Saved (and held) before the charge is queued, so the result always finds it
+        SeatHold::placeHold(resID, newRes->getHoldExpiresAt());
+        if (Payment::submitCardPayment({ newRes }))
+        {
+            cout << "Reservation saved; you will be notified once the card payment clears.\n";
+            newRes->displayReservation();
+        }
+        else
+        {
+            cout << "The card payment could not be started; the reservation was released. "
+                 << "Please try again.\n";
+        }
+    }
+    else
     {
         cout << "Reservation on hold. Confirm payment at airport.\n";
-        agentRes.push_back(newRes);
-        Reservation::saveReservations(agentRes);
-        Reservation::saveBookingAgentReservations(agentRes);
+        SeatHold::placeHold(resID, newRes->getHoldExpiresAt());
         newRes->displayHoldingReservation();
     }
+}
+
+/**
+ * Prompts for a party size and its flights, takes everything up front, runs a single
+ * payment for the party and saves the whole group with one write per reservation file.
+ */
+void BookingAgent::bookGroup(void)
+{
+    int passengers;
+    cout << "\n--- Group Booking ---\n"
+         << "Enter number of passengers (1-" << MAX_GROUP_SIZE << "): ";
+    cin >> passengers;
+    if (!cin || passengers < 1 || passengers > MAX_GROUP_SIZE)
+    {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Invalid party size. Booking cancelled.\n";
+        return;
+    }
+
+    vector<GroupBookingLeg> legs;
+    auto table = FlightRegistry::table();
+    while (true)
+    {
+        string flightNumber;
+        cout << "Enter Flight Number for leg " << legs.size() + 1 << " (or '0' to finish): ";
+        cin >> flightNumber;
+        if (flightNumber == "0")
+            break;
+
+        long row = table->findRow(flightNumber);
+        if (row < 0)
+        {
+            cout << "Invalid flight number.\n";
+            continue;
+        }
+
+        GroupBookingLeg leg;
+        leg.flightNumber = flightNumber;
+        if (selectFareBucket(table->row(static_cast<size_t>(row)), leg.fareClass))
+            legs.push_back(leg);
+    }
+
+    if (legs.empty())
+    {
+        cout << "No flights selected. Booking cancelled.\n";
+        return;
+    }
+
+    vector<shared_ptr<Reservation>> group;
+    if (!reserveGroup(legs, passengers, group))
+        return;
+
+    // One payment covers the party; its outcome is copied to every reservation
+    shared_ptr<Reservation> lead = group.front();
+    if (!Payment::processPayment(lead))
+    {
+        cout << "Payment failed. Group booking aborted.\n";
+        releaseGroup(group);
+        return;
+    }
+
+    int64_t expiresAt = lead->getIsPaid() ? 0 : SeatHold::expiryFromNow();
+    for (auto const& res : group)
+    {
+        res->setPaymentMethod(lead->getPaymentMethod());
+        res->setPaymentDetails(lead->getPaymentDetails());
+        res->setIsPaid(lead->getIsPaid());
+        res->setHoldExpiresAt(expiresAt);
+    }
+
+    if (!saveToBothFiles(group))
+    {
+        cout << "Group booking could not be saved. Booking aborted.\n";
+        releaseGroup(group);
+        return;
+    }
+
+    if (expiresAt > 0)
+    {
+        for (auto const& res : group)
+            SeatHold::placeHold(res->getReservationID(), expiresAt);
+    }
+
+    if (lead->isPaymentPending())
+    {
+        // One charge for the whole party; the result confirms or cancels every seat
+        if (!Payment::submitCardPayment(group))
+        {
+            cout << "The card payment could not be started; the group booking was released. "
+                 << "Please try again.\n";
+            return;
+        }
+        cout << "Group of " << passengers << " saved; you will be notified once the card payment clears.\n";
+    }
+    else if (expiresAt > 0)
+    {
+        cout << "Group of " << passengers << " on hold. Confirm payment at airport.\n";
+    }
     else
     {
-        cout << "Payment failed. Booking aborted.\n";
+        cout << "Group booking successful!\n";
+    }
+    reservations.insert(reservations.end(), group.begin(), group.end());
+
+    for (auto const& res : group)
+        cout << res->getReservationID() << "  " << res->getFlight()->getFlightNumber()
+             << "  seat " << res->getSeatNumber() << "\n";
+}
+
+/**
+ * Leg by leg, sells the fare inventory for the whole party in one step and then seats
+ * it as a block; a leg that cannot take the party unwinds every leg before it.
+ */
+bool BookingAgent::reserveGroup(const vector<GroupBookingLeg>& legs, int passengers,
+                                vector<shared_ptr<Reservation>>& group)
+{
+    TRACE_SPAN("BookingAgent::reserveGroup");
+    group.clear();
+    auto table = FlightRegistry::table();
+
+    // Every ID is drawn before any seat is taken, so running out unwinds nothing
+    vector<string> ids(legs.size() * static_cast<size_t>(passengers));
+    for (auto& id : ids)
+    {
+        id = Reservation::nextReservationID();
+        if (id.empty())
+        {
+            cout << "No reservation numbers could be issued for this group.\n";
+            return false;
+        }
+    }
+
+    for (auto const& leg : legs)
+    {
+        long row = table->findRow(leg.flightNumber);
+        if (row < 0)
+        {
+            cout << "Invalid flight number " << leg.flightNumber << ".\n";
+            releaseGroup(group);
+            return false;
+        }
+        auto flight = ReservationPool::makeFlight(table->row(static_cast<size_t>(row)));
+
+        if (!SeatInventory::reserveSeat(leg.flightNumber, leg.fareClass, passengers))
+        {
+            cout << "Fare class " << leg.fareClass << " on flight " << leg.flightNumber
+                 << " cannot take " << passengers << " passengers.\n";
+            releaseGroup(group);
+            return false;
+        }
+
+        vector<string> seats;
+        if (!SeatMap::claimGroupSeats(*flight, passengers, seats))
+        {
+            cout << "Flight " << leg.flightNumber << " has fewer than " << passengers
+                 << " free seats.\n";
+            SeatInventory::releaseSeat(leg.flightNumber, leg.fareClass, passengers);
+            releaseGroup(group);
+            return false;
+        }
+
+        for (auto const& seat : seats)
+        {
+            auto res = ReservationPool::makeReservation(ids[group.size()], username, flight, seat, "", "");
+            res->setFareClass(leg.fareClass);
+            group.push_back(res);
+        }
+    }
+    return true;
+}
+
+/**
+ * Releases one inventory unit and one seat per reservation of the group.
+ */
+void BookingAgent::releaseGroup(const vector<shared_ptr<Reservation>>& group)
+{
+    for (auto const& res : group)
+    {
+        const string& flightNumber = res->getFlight()->getFlightNumber();
+        SeatInventory::releaseSeat(flightNumber, res->getFareClass());
+        SeatMap::releaseSeat(flightNumber, res->getSeatNumber());
     }
 }
 
@@ -242,6 +502,25 @@ void BookingAgent::checkIn(void)
     {
         if (res->getReservationID() == resID)
         {
+            if (res->getIsPaid() && res->getSeatNumber() == OVERBOOKED_SEAT)
+            {
+                // Overbooked passenger: seat them if a seat has been freed since booking
+                vector<string> freed;
+                if (!SeatMap::claimAdjacentSeats(*res->getFlight(), 1, freed))
+                {
+                    cout << "No seat is free yet; you are on standby for this flight.\n";
+                    return;
+                }
+                res->setSeatNumber(freed.front());
+                if (!saveToBothFiles({ res }))
+                {
+                    SeatMap::releaseSeat(res->getFlight()->getFlightNumber(), freed.front());
+                    res->setSeatNumber(OVERBOOKED_SEAT);
+                    cout << "Check-in could not be saved; please try again.\n";
+                    return;
+                }
+            }
+
             if (res->getIsPaid())
             {
                 cout << "\n✅ Check-In Successful!\n";
@@ -280,19 +559,48 @@ void BookingAgent::confirmCashPayment(void)
     string resID;
     cin >> resID;
 
+    // A repeated confirmation is answered from the idempotency index without file I/O
+    string key = "cash:" + resID, outcome;
+    IdempotencyState state = IdempotencyIndex::begin(key, outcome);
+    if (state == IdempotencyState::Completed)
+    {
+        cout << "Payment for reservation " << resID << " was already " << outcome << ".\n";
+        return;
+    }
+    if (state == IdempotencyState::InProgress)
+    {
+        cout << "Payment for reservation " << resID << " is already being confirmed.\n";
+        return;
+    }
+
+    // Reload so a hold that lapsed while the menu was open is no longer offered
+    reservations = Reservation::loadReservations();
     for (auto& res : reservations)
     {
-        if (res->getReservationID() == resID && !res->getIsPaid())
+        if (res->getReservationID() == resID && !res->getIsPaid() && !res->isPaymentPending())
         {
+            if (SeatHold::hasLapsed(res->getHoldExpiresAt()))
+            {
+                cout << "Hold on reservation " << resID << " has expired.\n";
+                IdempotencyIndex::complete(key, "expired");
+                return;
+            }
+
+            // The hold stays armed until the payment is on file; confirmPayments clears it
+            if (Reservation::confirmPayments({ resID }) == 0)
+                break;
+
             cout << "Payment confirmed at airport!\n";
             res->setIsPaid(true);
-            Reservation::saveReservations(reservations);
-            Reservation::saveBookingAgentReservations(reservations);
+            res->setHoldExpiresAt(0);
+            IdempotencyIndex::complete(key, "confirmed");
             cout << "Reservation confirmed.\n";
             res->printBoardingPass();
             return;
         }
     }
+
+    IdempotencyIndex::abandon(key);
     cout << "Reservation ID not found or already paid.\n";
 }
 
@@ -0,0 +1,252 @@
+/******************************************************************************************
+ * MODULE NAME    : Cabin Layout Module
+ * FILE           : CabinLayout.cpp
+ * DESCRIPTION    : Implements cabin layouts: section parsing, seat label conversion and
+ *                  the per-row seat and window masks.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/CabinLayout.hpp"
+#include <cctype>
+#include <sstream>
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * Returns the number of set bits.
+ */
+static int bitCount(uint64_t mask)
+{
+    int count = 0;
+    for (; mask; mask &= mask - 1)
+        ++count;
+    return count;
+}
+
+/**
+ * Constructor: Initializes a layout with no rows.
+ */
+CabinLayout::CabinLayout(void)
+{}
+
+/**
+ * Full rows of the standard pattern followed by one partial row if needed.
+ */
+CabinLayout CabinLayout::standard(int seats)
+{
+    CabinLayout layout;
+    const string pattern = STANDARD_ROW_PATTERN;
+    int perRow = 0;
+    for (char c : pattern)
+        perRow += c != '-';
+
+    if (seats > 0)
+    {
+        layout.addSection(CabinSection{ "Economy", (seats + perRow - 1) / perRow, pattern });
+        layout.limitSeats(seats);
+    }
+    return layout;
+}
+
+/**
+ * Splits on ',' then ':'.
+ */
+bool CabinLayout::parse(const string& text, CabinLayout& layout)
+{
+    CabinLayout parsed;
+    stringstream entries(text);
+    string entry;
+
+    while (getline(entries, entry, ','))
+    {
+        size_t first  = entry.find(':');
+        size_t second = first == string::npos ? string::npos : entry.find(':', first + 1);
+        if (second == string::npos)
+            return false;
+
+        CabinSection section;
+        section.cabinClass = entry.substr(0, first);
+        section.pattern    = entry.substr(second + 1);
+        try
+        {
+            section.rows = stoi(entry.substr(first + 1, second - first - 1));
+        }
+        catch (const exception&)
+        {
+            return false;
+        }
+        if (!parsed.addSection(section))
+            return false;
+    }
+
+    if (parsed.empty())
+        return false;
+    layout = move(parsed);
+    return true;
+}
+
+/**
+ * Validates the pattern (letters and aisles, no duplicate letters, aisles between seats)
+ * and precomputes the masks of the new rows.
+ */
+bool CabinLayout::addSection(const CabinSection& section)
+{
+    const string& p = section.pattern;
+    if (section.rows <= 0 || p.empty() || p.size() > MAX_ROW_COLUMNS ||
+        p.front() == '-' || p.back() == '-')
+    {
+        return false;
+    }
+
+    uint64_t seatsInRow = 0;
+    for (size_t c = 0; c < p.size(); ++c)
+    {
+        if (p[c] == '-')
+            continue;
+        if (!isalpha(static_cast<unsigned char>(p[c])) || p.find(p[c]) != c)
+            return false;
+        seatsInRow |= uint64_t(1) << c;
+    }
+
+    uint64_t windows = (uint64_t(1) << 0) | (uint64_t(1) << (p.size() - 1));
+    int sectionIndex = static_cast<int>(sections.size());
+    sections.push_back(section);
+    for (int r = 0; r < section.rows; ++r)
+    {
+        sectionOfRow.push_back(sectionIndex);
+        seatMasks.push_back(seatsInRow);
+        windowMasks.push_back(windows);
+    }
+    return true;
+}
+
+/**
+ * Clears the seat bits past the given count, walking rows front to back.
+ */
+void CabinLayout::limitSeats(int seats)
+{
+    int remaining = seats;
+    for (size_t r = 0; r < seatMasks.size(); ++r)
+    {
+        uint64_t kept = 0;
+        for (uint64_t mask = seatMasks[r]; mask && remaining > 0; mask &= mask - 1, --remaining)
+            kept |= mask & (~mask + 1);
+        seatMasks[r]    = kept;
+        windowMasks[r] &= kept;
+    }
+}
+
+/**
+ * Accepts "<row><letter>" or a plain ordinal counted row by row from the front.
+ */
+bool CabinLayout::parseSeat(const string& text, int& row, int& column) const
+{
+    size_t digits = 0;
+    while (digits < text.size() && isdigit(static_cast<unsigned char>(text[digits])))
+        ++digits;
+    if (digits == 0 || digits > 6)
+        return false;
+
+    int number = stoi(text.substr(0, digits));
+
+    if (digits == text.size())
+    {
+        // Legacy ordinal: the n-th existing seat of the cabin
+        int ordinal = number - 1;
+        if (ordinal < 0)
+            return false;
+        for (int r = 0; r < rowCount(); ++r)
+        {
+            int inRow = bitCount(seatMasks[r]);
+            if (ordinal < inRow)
+            {
+                uint64_t mask = seatMasks[r];
+                for (int skip = 0; skip < ordinal; ++skip)
+                    mask &= mask - 1;
+                row    = r;
+                column = __builtin_ctzll(mask);
+                return true;
+            }
+            ordinal -= inRow;
+        }
+        return false;
+    }
+
+    if (digits + 1 != text.size() || number < 1 || number > rowCount())
+        return false;
+
+    int r = number - 1;
+    const string& pattern = sections[sectionOfRow[r]].pattern;
+    size_t c = pattern.find(static_cast<char>(toupper(static_cast<unsigned char>(text[digits]))));
+    if (c == string::npos || !(seatMasks[r] >> c & 1))
+        return false;
+
+    row    = r;
+    column = static_cast<int>(c);
+    return true;
+}
+
+/**
+ * Row number (1-based) followed by the column's letter.
+ */
+string CabinLayout::seatLabel(int row, int column) const
+{
+    return to_string(row + 1) + sections[sectionOfRow[row]].pattern[column];
+}
+
+int      CabinLayout::rowCount(void) const          { return static_cast<int>(seatMasks.size()); }
+bool     CabinLayout::empty(void) const             { return seatMasks.empty(); }
+uint64_t CabinLayout::seatMask(int row) const       { return seatMasks[row]; }
+uint64_t CabinLayout::windowMask(int row) const     { return windowMasks[row]; }
+const string& CabinLayout::cabinClassOf(int row) const { return sections[sectionOfRow[row]].cabinClass; }
+const vector<CabinSection>& CabinLayout::getSections(void) const { return sections; }
+
+/**
+ * Total number of seats that exist after any limitSeats() call.
+ */
+int CabinLayout::seatCount(void) const
+{
+    int count = 0;
+    for (auto mask : seatMasks)
+        count += bitCount(mask);
+    return count;
+}
+
+/**
+ * Serialises the sections; seat limits are re-applied from the flight's seat count.
+ */
+json CabinLayout::toJson(void) const
+{
+    json j = json::array();
+    for (auto const& s : sections)
+        j.push_back({ {"cabinClass", s.cabinClass}, {"rows", s.rows}, {"pattern", s.pattern} });
+    return j;
+}
+
+/**
+ * Rebuilds a layout from its sections.
+ */
+bool CabinLayout::fromJson(const json& j, CabinLayout& layout)
+{
+    if (!j.is_array())
+        return false;
+
+    CabinLayout parsed;
+    for (auto const& s : j)
+    {
+        if (!s.contains("cabinClass") || !s.contains("rows") || !s.contains("pattern") ||
+            !parsed.addSection({ s.at("cabinClass").get<string>(), s.at("rows").get<int>(),
+                                 s.at("pattern").get<string>() }))
+        {
+            return false;
+        }
+    }
+    layout = move(parsed);
+    return true;
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
@@ -0,0 +1,672 @@
+/******************************************************************************************
+ * MODULE NAME    : Card Vault Module
+ * FILE           : CardVault.cpp
+ * DESCRIPTION    : Implements the encrypted card log, its in-memory index and the
+ *                  migration of the legacy plaintext card file.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/CardVault.hpp"
+#include "../header/Payment.hpp"
+#include "../header/json.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <unordered_map>
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * One saved card: the sealed record and the fields that may be shown in the clear.
+ */
+struct VaultEntry
+{
+    string              token;
+    string              masked;
+    array<uint8_t, 12>  nonce;
+    string              sealed;
+    array<uint8_t, 16>  tag;
+    int                 version = CARD_VAULT_RECORD_VERSION;
+};
+
+static unordered_map<string, VaultEntry> vaultCards;
+static shared_mutex                      vaultMutex;
+static once_flag                         vaultLoadOnce;
+static array<uint32_t, 8>                vaultKey;
+static bool                              vaultKeyReady = false;
+
+/**
+ * Fills a buffer from the system's random source.
+ */
+static void randomBytes(uint8_t* out, size_t count)
+{
+    random_device source;
+    for (size_t i = 0; i < count; ++i)
+        out[i] = static_cast<uint8_t>(source());
+}
+
+/**
+ * Lower-case hex encoding of raw bytes.
+ */
+static string toHex(const uint8_t* data, size_t count)
+{
+    static const char digits[] = "0123456789abcdef";
+    string hex;
+    hex.reserve(count * 2);
+    for (size_t i = 0; i < count; ++i)
+    {
+        hex += digits[data[i] >> 4];
+        hex += digits[data[i] & 0x0F];
+    }
+    return hex;
+}
+
+/**
+ * Decodes hex into raw bytes; returns false on odd length or a non-hex digit.
+ */
+static bool fromHex(const string& hex, string& out)
+{
+    if (hex.size() % 2 != 0)
+        return false;
+
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+
+    out.assign(hex.size() / 2, '\0');
+    for (size_t i = 0; i < out.size(); ++i)
+    {
+        int hi = nibble(hex[2 * i]), lo = nibble(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0)
+            return false;
+        out[i] = static_cast<char>(hi << 4 | lo);
+    }
+    return true;
+}
+
+/**
+ * Overwrites a secret before its buffer is released.
+ */
+static void wipe(string& secret)
+{
+    volatile char* p = &secret[0];
+    for (size_t i = 0; i < secret.size(); ++i)
+        p[i] = 0;
+    secret.clear();
+}
+
+static inline uint32_t rotl32(uint32_t v, int n) { return (v << n) | (v >> (32 - n)); }
+
+static inline uint32_t load32(const uint8_t* p)
+{
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+/**
+ * ChaCha20 block function (RFC 8439): 20 rounds over the key, counter and nonce.
+ */
+static void chachaBlock(const array<uint32_t, 8>& key, uint32_t counter,
+                        const array<uint8_t, 12>& nonce, uint8_t out[64])
+{
+    uint32_t input[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+        key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+        counter, load32(&nonce[0]), load32(&nonce[4]), load32(&nonce[8])
+    };
+    uint32_t x[16];
+    for (int i = 0; i < 16; ++i)
+        x[i] = input[i];
+
+    auto quarter = [&x](int a, int b, int c, int d) {
+        x[a] += x[b]; x[d] = rotl32(x[d] ^ x[a], 16);
+        x[c] += x[d]; x[b] = rotl32(x[b] ^ x[c], 12);
+        x[a] += x[b]; x[d] = rotl32(x[d] ^ x[a], 8);
+        x[c] += x[d]; x[b] = rotl32(x[b] ^ x[c], 7);
+    };
+
+    for (int round = 0; round < 10; ++round)
+    {
+        quarter(0, 4,  8, 12); quarter(1, 5,  9, 13); quarter(2, 6, 10, 14); quarter(3, 7, 11, 15);
+        quarter(0, 5, 10, 15); quarter(1, 6, 11, 12); quarter(2, 7,  8, 13); quarter(3, 4,  9, 14);
+    }
+
+    for (int i = 0; i < 16; ++i)
+    {
+        uint32_t v = x[i] + input[i];
+        out[4 * i]     = static_cast<uint8_t>(v);
+        out[4 * i + 1] = static_cast<uint8_t>(v >> 8);
+        out[4 * i + 2] = static_cast<uint8_t>(v >> 16);
+        out[4 * i + 3] = static_cast<uint8_t>(v >> 24);
+    }
+}
+
+/**
+ * Stores v little-endian in 4 bytes.
+ */
+static inline void store32(uint8_t* p, uint32_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+/**
+ * Poly1305 (RFC 8439) in 26-bit limbs, over data already padded to whole 16-byte blocks.
+ */
+static void poly1305(const uint8_t key[32], const string& data, uint8_t tag[16])
+{
+    const uint32_t mask = 0x3ffffff;
+    const uint32_t r0 =  load32(key)       & 0x3ffffff, r1 = (load32(key + 3) >> 2) & 0x3ffff03;
+    const uint32_t r2 = (load32(key + 6) >> 4) & 0x3ffc0ff, r3 = (load32(key + 9) >> 6) & 0x3f03fff;
+    const uint32_t r4 = (load32(key + 12) >> 8) & 0x00fffff;
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = 0, h1 = 0, h2 = 0, h3 = 0, h4 = 0;
+
+    const uint8_t* m = reinterpret_cast<const uint8_t*>(data.data());
+    for (size_t offset = 0; offset + 16 <= data.size(); offset += 16, m += 16)
+    {
+        h0 +=  load32(m)       & mask;
+        h1 += (load32(m + 3) >> 2) & mask;
+        h2 += (load32(m + 6) >> 4) & mask;
+        h3 += (load32(m + 9) >> 6) & mask;
+        h4 += (load32(m + 12) >> 8) | (1u << 24);
+
+        uint64_t d0 = uint64_t(h0) * r0 + uint64_t(h1) * s4 + uint64_t(h2) * s3 + uint64_t(h3) * s2 + uint64_t(h4) * s1;
+        uint64_t d1 = uint64_t(h0) * r1 + uint64_t(h1) * r0 + uint64_t(h2) * s4 + uint64_t(h3) * s3 + uint64_t(h4) * s2;
+        uint64_t d2 = uint64_t(h0) * r2 + uint64_t(h1) * r1 + uint64_t(h2) * r0 + uint64_t(h3) * s4 + uint64_t(h4) * s3;
+        uint64_t d3 = uint64_t(h0) * r3 + uint64_t(h1) * r2 + uint64_t(h2) * r1 + uint64_t(h3) * r0 + uint64_t(h4) * s4;
+        uint64_t d4 = uint64_t(h0) * r4 + uint64_t(h1) * r3 + uint64_t(h2) * r2 + uint64_t(h3) * r1 + uint64_t(h4) * r0;
+
+        d1 += d0 >> 26; h0 = static_cast<uint32_t>(d0) & mask;
+        d2 += d1 >> 26; h1 = static_cast<uint32_t>(d1) & mask;
+        d3 += d2 >> 26; h2 = static_cast<uint32_t>(d2) & mask;
+        d4 += d3 >> 26; h3 = static_cast<uint32_t>(d3) & mask;
+        h0 += static_cast<uint32_t>(d4 >> 26) * 5; h4 = static_cast<uint32_t>(d4) & mask;
+        h1 += h0 >> 26; h0 &= mask;
+    }
+
+    // Fully carry h, then subtract p = 2^130 - 5 if h >= p, without branching on h
+    h2 += h1 >> 26; h1 &= mask;
+    h3 += h2 >> 26; h2 &= mask;
+    h4 += h3 >> 26; h3 &= mask;
+    h0 += (h4 >> 26) * 5; h4 &= mask;
+    h1 += h0 >> 26; h0 &= mask;
+
+    uint32_t g0 = h0 + 5;          uint32_t c = g0 >> 26; g0 &= mask;
+    uint32_t g1 = h1 + c;          c = g1 >> 26;          g1 &= mask;
+    uint32_t g2 = h2 + c;          c = g2 >> 26;          g2 &= mask;
+    uint32_t g3 = h3 + c;          c = g3 >> 26;          g3 &= mask;
+    uint32_t g4 = h4 + c - (1u << 26);
+
+    uint32_t useG = (g4 >> 31) - 1;
+    h0 = (h0 & ~useG) | (g0 & useG);
+    h1 = (h1 & ~useG) | (g1 & useG);
+    h2 = (h2 & ~useG) | (g2 & useG);
+    h3 = (h3 & ~useG) | (g3 & useG);
+    h4 = (h4 & ~useG) | (g4 & useG);
+
+    uint64_t f;
+    f = uint64_t(h0 | h1 << 26)        + load32(key + 16);            store32(tag,      static_cast<uint32_t>(f));
+    f = uint64_t(h1 >> 6 | h2 << 20)   + load32(key + 20) + (f >> 32); store32(tag + 4,  static_cast<uint32_t>(f));
+    f = uint64_t(h2 >> 12 | h3 << 14)  + load32(key + 24) + (f >> 32); store32(tag + 8,  static_cast<uint32_t>(f));
+    f = uint64_t(h3 >> 18 | h4 << 8)   + load32(key + 28) + (f >> 32); store32(tag + 12, static_cast<uint32_t>(f));
+}
+
+/**
+ * Compares two tags without an early exit on the first differing byte.
+ */
+static bool sameTag(const array<uint8_t, 16>& a, const array<uint8_t, 16>& b)
+{
+    uint8_t diff = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+        diff |= static_cast<uint8_t>(a[i] ^ b[i]);
+    return diff == 0;
+}
+
+/**
+ * Encrypts or decrypts in place (the cipher is its own inverse), counter starting at 1.
+ */
+static void chachaXor(const array<uint8_t, 12>& nonce, string& data)
+{
+    uint8_t block[64];
+    for (size_t offset = 0; offset < data.size(); offset += 64)
+    {
+        chachaBlock(vaultKey, static_cast<uint32_t>(offset / 64 + 1), nonce, block);
+        for (size_t i = 0; i < 64 && offset + i < data.size(); ++i)
+            data[offset + i] = static_cast<char>(data[offset + i] ^ block[i]);
+    }
+    for (auto& b : block)
+        b = 0;
+}
+
+/**
+ * ChaCha20-Poly1305 tag (RFC 8439) of a sealed record. The one-time key is keystream
+ * block 0; the associated data binds the record to its user, token and masked number,
+ * so a record cannot be moved to another user or relabelled without failing the check.
+ */
+static array<uint8_t, 16> recordTag(const string& username, const VaultEntry& entry)
+{
+    uint8_t block[64];
+    chachaBlock(vaultKey, 0, entry.nonce, block);
+
+    const string aad = username + '\n' + entry.token + '\n' + entry.masked;
+    string macData = aad;
+    macData.append((16 - aad.size() % 16) % 16, '\0');
+    macData += entry.sealed;
+    macData.append((16 - entry.sealed.size() % 16) % 16, '\0');
+    uint8_t lengths[16] = {};
+    store32(lengths,     static_cast<uint32_t>(aad.size()));
+    store32(lengths + 8, static_cast<uint32_t>(entry.sealed.size()));
+    macData.append(reinterpret_cast<const char*>(lengths), sizeof(lengths));
+
+    array<uint8_t, 16> tag;
+    poly1305(block, macData, tag.data());
+    for (auto& b : block)
+        b = 0;
+    return tag;
+}
+
+/**
+ * Checks a record's tag; records older than the authenticated format have none.
+ */
+static bool isAuthentic(const string& username, const VaultEntry& entry)
+{
+    return entry.version >= CARD_VAULT_RECORD_VERSION && sameTag(recordTag(username, entry), entry.tag);
+}
+
+/**
+ * Creates the key file holding hex. On POSIX the file is created exclusively and
+ * readable by the owner only from its first byte; returns false with existed set if
+ * another process created it first, or false if it cannot be written.
+ */
+static bool createKeyFile(const string& hex, bool& existed)
+{
+    const string line = hex + '\n';
+    existed = false;
+#ifndef _WIN32
+    int fd = open(PATH_OF_CARD_VAULT_KEY, O_CREAT | O_EXCL | O_WRONLY, 0600);
+    if (fd < 0)
+    {
+        existed = errno == EEXIST;
+        return false;
+    }
+    bool written = write(fd, line.data(), line.size()) == static_cast<ssize_t>(line.size());
+    written = close(fd) == 0 && written;
+    if (!written)
+        unlink(PATH_OF_CARD_VAULT_KEY);
+    return written;
+#else
+    ofstream out(PATH_OF_CARD_VAULT_KEY);
+    if (!out.is_open())
+        return false;
+    out << line;
+    out.close();
+    return static_cast<bool>(out);
+#endif
+}
+
+/**
+ * Loads the vault key from the environment or the key file, creating the file (readable
+ * by the owner only) with a fresh random key on first run.
+ */
+static bool loadVaultKey(void)
+{
+    string hex;
+    if (const char* fromEnv = getenv(CARD_VAULT_KEY_ENV))
+    {
+        hex = fromEnv;
+    }
+    else
+    {
+        ifstream keyFile(PATH_OF_CARD_VAULT_KEY);
+        if (keyFile.is_open())
+        {
+            keyFile >> hex;
+        }
+        else
+        {
+            uint8_t fresh[32];
+            randomBytes(fresh, sizeof(fresh));
+            hex = toHex(fresh, sizeof(fresh));
+
+            // If another process created the key since the read above, use that one
+            bool existed;
+            if (!createKeyFile(hex, existed) && !(existed && ifstream(PATH_OF_CARD_VAULT_KEY) >> hex))
+            {
+                cerr << "Error: Unable to create card vault key.\n";
+                return false;
+            }
+        }
+    }
+
+    string raw;
+    if (!fromHex(hex, raw) || raw.size() != 32)
+    {
+        cerr << "Error: Card vault key must be 64 hex digits.\n";
+        return false;
+    }
+    for (size_t i = 0; i < 8; ++i)
+        vaultKey[i] = load32(reinterpret_cast<const uint8_t*>(raw.data()) + 4 * i);
+    wipe(raw);
+    return true;
+}
+
+/**
+ * Serialises an index entry as one log line.
+ */
+static string recordLine(const string& username, const VaultEntry& entry)
+{
+    json record = {
+        {"v",      entry.version},
+        {"user",   username},
+        {"token",  entry.token},
+        {"masked", entry.masked},
+        {"nonce",  toHex(entry.nonce.data(), entry.nonce.size())},
+        {"data",   toHex(reinterpret_cast<const uint8_t*>(entry.sealed.data()), entry.sealed.size())},
+        {"tag",    toHex(entry.tag.data(), entry.tag.size())}
+    };
+    return record.dump();
+}
+
+/**
+ * Parses a log line into an index entry; malformed lines are skipped by the caller.
+ */
+static bool parseRecord(const string& line, string& username, VaultEntry& entry)
+{
+    json record = json::parse(line, nullptr, false);
+    if (record.is_discarded() || !record.is_object())
+        return false;
+
+    string nonce;
+    if (!fromHex(record.value("nonce", ""), nonce) || nonce.size() != entry.nonce.size() ||
+        !fromHex(record.value("data", ""), entry.sealed))
+    {
+        return false;
+    }
+
+    username      = record.value("user", "");
+    entry.version = record.value("v", 1);
+    entry.token   = record.value("token", "");
+    entry.masked  = record.value("masked", "");
+    copy(nonce.begin(), nonce.end(), entry.nonce.begin());
+
+    // Authenticated records must carry a tag; older ones are upgraded on load
+    string tag;
+    if (entry.version >= CARD_VAULT_RECORD_VERSION &&
+        (!fromHex(record.value("tag", ""), tag) || tag.size() != entry.tag.size()))
+    {
+        return false;
+    }
+    copy(tag.begin(), tag.end(), entry.tag.begin());
+    return !username.empty();
+}
+
+/**
+ * Seals a card's details under a fresh nonce and token with ChaCha20-Poly1305. The CVV
+ * is never part of them.
+ */
+static VaultEntry sealCard(const string& username, const string& cardNumber,
+                           const string& expDate, const string& cardHolder)
+{
+    VaultEntry entry;
+    uint8_t tokenBytes[8];
+    randomBytes(tokenBytes, sizeof(tokenBytes));
+    randomBytes(entry.nonce.data(), entry.nonce.size());
+
+    entry.token  = "tok_" + toHex(tokenBytes, sizeof(tokenBytes));
+    entry.masked = CardVault::maskCardNumber(cardNumber);
+    entry.sealed = json{
+        {"cardNumber", cardNumber},
+        {"expDate",    expDate},
+        {"cardHolder", cardHolder}
+    }.dump();
+    chachaXor(entry.nonce, entry.sealed);
+    entry.tag = recordTag(username, entry);
+    return entry;
+}
+
+/**
+ * Reseals a record written by an older version in the current format, dropping the CVV
+ * those versions kept; the token stays so pending charges still find the card. Those
+ * versions wrote no tag, so their records are trusted this one last time.
+ */
+static bool upgradeRecord(const string& username, VaultEntry& entry)
+{
+    chachaXor(entry.nonce, entry.sealed);
+    json card = json::parse(entry.sealed, nullptr, false);
+    wipe(entry.sealed);
+    if (card.is_discarded() || !card.is_object())
+        return false;
+
+    VaultEntry upgraded = sealCard(username, card.value("cardNumber", ""), card.value("expDate", ""),
+                                   card.value("cardHolder", ""));
+    for (auto& field : card)
+        if (field.is_string())
+            wipe(field.get_ref<string&>());
+
+    upgraded.token = entry.token;
+    upgraded.tag   = recordTag(username, upgraded);
+    entry          = move(upgraded);
+    return true;
+}
+
+/**
+ * Appends one record to the log; caller holds vaultMutex exclusively.
+ */
+static bool appendRecord(const string& username, const VaultEntry& entry)
+{
+    ofstream log(PATH_OF_CARD_VAULT_DATA_BASE, ios::app);
+    if (!log.is_open())
+        return false;
+    log << recordLine(username, entry) << '\n';
+    log.flush();
+    return static_cast<bool>(log);
+}
+
+/**
+ * Rewrites the log with only the live record of each user; caller holds vaultMutex.
+ */
+static void compactLog(void)
+{
+    string tmpPath = string(PATH_OF_CARD_VAULT_DATA_BASE) + ".tmp";
+    ofstream out(tmpPath, ios::trunc);
+    if (!out.is_open())
+        return;
+    for (auto const& card : vaultCards)
+        out << recordLine(card.first, card.second) << '\n';
+    out.close();
+
+    if (out)
+        rename(tmpPath.c_str(), PATH_OF_CARD_VAULT_DATA_BASE);
+}
+
+/**
+ * Moves any cards still in the plaintext file into the vault, then empties that file.
+ * A card already in the vault is newer than its plaintext copy and wins.
+ */
+static void migrateLegacyCards(void)
+{
+    ifstream inFile(PATH_OF_USER_CARD_DATA_BASE);
+    if (!inFile.is_open())
+        return;
+
+    json legacy = json::parse(inFile, nullptr, false);
+    inFile.close();
+    if (legacy.is_discarded() || !legacy.is_object() || legacy.empty())
+        return;
+
+    bool allMoved = true;
+    for (auto const& user : legacy.items())
+    {
+        if (vaultCards.count(user.key()))
+            continue;
+
+        json const& card = user.value();
+        VaultEntry entry = sealCard(user.key(), card.value("cardNumber", ""), card.value("expDate", ""),
+                                    card.value("cardHolder", ""));
+        if (appendRecord(user.key(), entry))
+            vaultCards[user.key()] = move(entry);
+        else
+            allMoved = false;
+    }
+
+    if (!allMoved)
+    {
+        cerr << "Error: Unable to move saved cards into the card vault.\n";
+        return;
+    }
+
+    ofstream outFile(PATH_OF_USER_CARD_DATA_BASE, ios::trunc);
+    if (outFile.is_open())
+        outFile << "{}" << endl;
+}
+
+/**
+ * Builds the index from the log, last record per user winning, and compacts the log
+ * once superseded records outnumber live ones or a record had to be upgraded. A record
+ * whose tag does not verify never enters the index, so an earlier record of the same
+ * user stays in force. Runs once per process.
+ */
+static void loadVault(void)
+{
+    call_once(vaultLoadOnce, []() {
+        unique_lock<shared_mutex> lock(vaultMutex);
+        if (!loadVaultKey())
+            return;
+        vaultKeyReady = true;
+
+        size_t lines = 0, forged = 0;
+        ifstream log(PATH_OF_CARD_VAULT_DATA_BASE);
+        string line;
+        while (getline(log, line))
+        {
+            string     username;
+            VaultEntry entry;
+            if (!parseRecord(line, username, entry))
+                continue;
+            if (entry.version >= CARD_VAULT_RECORD_VERSION && !isAuthentic(username, entry))
+            {
+                ++forged;
+                continue;
+            }
+            vaultCards[username] = move(entry);
+            ++lines;
+        }
+        log.close();
+        if (forged > 0)
+            cerr << "Error: " << forged << " card vault record(s) failed authentication and were ignored.\n";
+
+        bool upgraded = false;
+        for (auto& card : vaultCards)
+            if (card.second.version < CARD_VAULT_RECORD_VERSION)
+                upgraded |= upgradeRecord(card.first, card.second);
+
+        if (upgraded || lines > 2 * vaultCards.size())
+            compactLog();
+        migrateLegacyCards();
+    });
+}
+
+/**
+ * Copies a user's entry out of the index so decryption runs without the lock.
+ */
+static bool findEntry(const string& username, VaultEntry& entry)
+{
+    loadVault();
+    shared_lock<shared_mutex> lock(vaultMutex);
+    auto it = vaultCards.find(username);
+    if (!vaultKeyReady || it == vaultCards.end())
+        return false;
+    entry = it->second;
+    return true;
+}
+
+/**
+ * Index probe only.
+ */
+bool CardVault::hasCard(const string& username)
+{
+    VaultEntry entry;
+    return findEntry(username, entry);
+}
+
+/**
+ * Seals outside the lock, then appends and indexes under it.
+ */
+string CardVault::storeCard(const string& username, const string& cardNumber,
+                            const string& expDate, const string& cardHolder)
+{
+    loadVault();
+    VaultEntry entry = sealCard(username, cardNumber, expDate, cardHolder);
+
+    unique_lock<shared_mutex> lock(vaultMutex);
+    if (!vaultKeyReady || !appendRecord(username, entry))
+    {
+        cerr << "Error: Unable to save card information for user " << username << ".\n";
+        return "";
+    }
+
+    string token = entry.token;
+    vaultCards[username] = move(entry);
+    return token;
+}
+
+/**
+ * Getter: token of the saved card.
+ */
+string CardVault::tokenOf(const string& username)
+{
+    VaultEntry entry;
+    return findEntry(username, entry) ? entry.token : "";
+}
+
+/**
+ * Getter: masked number of the saved card.
+ */
+string CardVault::maskedCardOf(const string& username)
+{
+    VaultEntry entry;
+    return findEntry(username, entry) ? entry.masked : "";
+}
+
+/**
+ * Keeps the last four characters; shorter numbers are masked entirely.
+ */
+string CardVault::maskCardNumber(const string& cardNumber)
+{
+    if (cardNumber.size() <= 4)
+        return "****";
+    return "**** " + cardNumber.substr(cardNumber.size() - 4);
+}
+
+/**
+ * Number of users with a saved card.
+ */
+size_t CardVault::cardCount(void)
+{
+    loadVault();
+    shared_lock<shared_mutex> lock(vaultMutex);
+    return vaultCards.size();
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
@@ -0,0 +1,454 @@
+/******************************************************************************************
+ * MODULE NAME    : Command Runner Module
+ * FILE           : CommandRunner.cpp
+ * DESCRIPTION    : Implements the non-interactive JSON-lines command mode.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/CommandRunner.hpp"
+#include "../header/CardVault.hpp"
+#include "../header/FlightRegistry.hpp"
+#include "../header/FlightTable.hpp"
+#include "../header/IdempotencyIndex.hpp"
+#include "../header/Metrics.hpp"
+#include "../header/Payment.hpp"
+#include "../header/PaymentPipeline.hpp"
+#include "../header/ReportEngine.hpp"
+#include "../header/Reservation.hpp"
+#include "../header/ReservationPool.hpp"
+#include "../header/SeatHold.hpp"
+#include "../header/SeatInventory.hpp"
+#include "../header/SeatMap.hpp"
+#include "../header/json.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * Stream buffer that swallows everything; stands in for cout during a run.
+ */
+class DiscardBuffer : public streambuf
+{
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+};
+
+/**
+ * A booking reported to the caller but not yet written, with the line, op and id of the
+ * command that made it so a later failure can be reported against that command.
+ */
+struct PendingBooking
+{
+    shared_ptr<Reservation> reservation;
+    json                    origin;
+};
+
+/**
+ * State of one run: the reservations known so far, the bookings not yet written and the
+ * failure records of bookings a flush had to drop, waiting to be printed.
+ */
+struct RunState
+{
+    unordered_map<string, shared_ptr<Reservation>> byID;
+    vector<PendingBooking>                          unsaved;
+    vector<json>                                    dropped;
+};
+
+/**
+ * Records that an earlier booking did not survive its flush; the run prints the record
+ * with ok false and counts it as a failed command.
+ */
+static void dropBooking(RunState& state, const PendingBooking& pending, const string& error)
+{
+    json record = pending.origin;
+    record["reservationID"] = pending.reservation->getReservationID();
+    record["error"]         = error;
+    record["ok"]            = false;
+    state.dropped.push_back(move(record));
+    state.byID.erase(pending.reservation->getReservationID());
+}
+
+/**
+ * Writes the buffered bookings with one merge, then arms their holds and queues their
+ * card charges; the records are on disk before anything can settle or expire them.
+ */
+static void flushBookings(RunState& state)
+{
+    if (state.unsaved.empty())
+        return;
+
+    vector<shared_ptr<Reservation>> batch;
+    batch.reserve(state.unsaved.size());
+    for (auto const& pending : state.unsaved)
+        batch.push_back(pending.reservation);
+
+    if (!Reservation::saveReservations(batch))
+    {
+        // Nothing was written; give the seats back so the batch leaves no phantom sales
+        for (auto const& pending : state.unsaved)
+        {
+            auto const& res = pending.reservation;
+            const string& flightNumber = res->getFlight()->getFlightNumber();
+            SeatInventory::releaseSeat(flightNumber, res->getFareClass());
+            SeatMap::releaseSeat(flightNumber, res->getSeatNumber());
+            dropBooking(state, pending, "booking could not be saved; the seat was released");
+        }
+        state.unsaved.clear();
+        return;
+    }
+
+    for (auto const& pending : state.unsaved)
+    {
+        auto const& res = pending.reservation;
+        SeatHold::placeHold(res->getReservationID(), res->getHoldExpiresAt());
+        if (res->isPaymentPending() && !Payment::submitCardPayment({ res }))
+            dropBooking(state, pending, "card payment could not be queued; the reservation was released");
+    }
+    state.unsaved.clear();
+}
+
+/**
+ * Direct flights with seats left, most available first.
+ */
+static bool runSearch(const json& cmd, json& result)
+{
+    METRIC_SCOPE("CommandRunner::search");
+    vector<Flight> matches = *FlightRegistry::findDirectFlights(cmd.value("origin", ""),
+                                                                cmd.value("destination", ""));
+    SeatInventory::rankByAvailability(matches);
+
+    result["flights"] = json::array();
+    for (auto const& flight : matches)
+    {
+        result["flights"].push_back({
+            {"flightNumber", flight.getFlightNumber()},
+            {"departure",    flight.getDepartureTime()},
+            {"arrival",      flight.getArrivalTime()},
+            {"price",        flight.getflightPrice()},
+            {"seatsLeft",    SeatInventory::seatsAvailable(flight.getFlightNumber())}
+        });
+    }
+    return true;
+}
+
+/**
+ * Same steps as Passenger::bookFlight: fare, seat, inventory, then payment. Without a
+ * fare class the cheapest open bucket is sold; without a seat the first free one.
+ */
+static bool runBook(const json& cmd, json& result, RunState& state)
+{
+    METRIC_SCOPE("CommandRunner::book");
+    const string user         = cmd.value("user", "");
+    const string flightNumber = cmd.value("flight", "");
+    const string payment      = cmd.value("payment", "cash");
+    if (user.empty() || flightNumber.empty())
+    {
+        result["error"] = "book needs user and flight";
+        return false;
+    }
+    if (payment != "cash" && payment != "card")
+    {
+        result["error"] = "payment must be cash or card";
+        return false;
+    }
+    if (payment == "card" && !CardVault::hasCard(user))
+    {
+        result["error"] = "no saved card for " + user;
+        return false;
+    }
+    auto table = FlightRegistry::table();
+    long row   = table->findRow(flightNumber);
+    if (row < 0)
+    {
+        result["error"] = "unknown flight " + flightNumber;
+        return false;
+    }
+    auto flight = ReservationPool::makeFlight(table->row(static_cast<size_t>(row)));
+
+    // Buckets run from the highest fare down, so the cheapest open one is the last
+    string fareClass = cmd.value("fareClass", "");
+    if (fareClass.empty())
+    {
+        auto const& buckets = flight->getFareBuckets();
+        for (auto it = buckets.rbegin(); it != buckets.rend() && fareClass.empty(); ++it)
+            if (SeatInventory::fareAvailability(flightNumber, it->code) > 0)
+                fareClass = it->code;
+        if (fareClass.empty())
+        {
+            result["error"] = "flight " + flightNumber + " is sold out";
+            return false;
+        }
+    }
+    else if (!flight->findFareBucket(fareClass))
+    {
+        result["error"] = "unknown fare class " + fareClass;
+        return false;
+    }
+
+    string seat = OVERBOOKED_SEAT;
+    if (SeatInventory::seatsAvailable(flightNumber) > 0)
+    {
+        vector<string> seats;
+        bool claimed = cmd.contains("seat")
+            ? SeatMap::claimSeat(*flight, cmd.value("seat", ""), seat)
+            : SeatMap::claimAdjacentSeats(*flight, 1, seats);
+        if (!claimed)
+        {
+            result["error"] = "seat not available";
+            return false;
+        }
+        if (!seats.empty())
+            seat = seats.front();
+    }
+
+    if (!SeatInventory::reserveSeat(flightNumber, fareClass))
+    {
+        SeatMap::releaseSeat(flightNumber, seat);
+        result["error"] = "fare class " + fareClass + " is sold out";
+        return false;
+    }
+
+    string resID = Reservation::nextReservationID();
+    if (resID.empty())
+    {
+        SeatInventory::releaseSeat(flightNumber, fareClass);
+        SeatMap::releaseSeat(flightNumber, seat);
+        result["error"] = "no reservation number could be issued";
+        return false;
+    }
+
+    auto res = ReservationPool::makeReservation(resID, user, flight, seat, "", "");
+    res->setFareClass(fareClass);
+    res->setIsPaid(false);
+    res->setHoldExpiresAt(SeatHold::expiryFromNow());
+    if (payment == "card")
+    {
+        res->setPaymentMethod("Card");
+        res->setPaymentDetails(CardVault::maskedCardOf(user));
+    }
+    else
+    {
+        res->setPaymentMethod("Cash");
+    }
+
+    // A full batch is written before this booking joins the next one, so a failed save
+    // never contradicts the result printed for the current command
+    if (state.unsaved.size() >= COMMAND_WRITE_BATCH)
+        flushBookings(state);
+    state.byID[resID] = res;
+    state.unsaved.push_back({ res, result });
+
+    result["reservationID"] = resID;
+    result["flight"]        = flightNumber;
+    result["seat"]          = seat;
+    result["fareClass"]     = fareClass;
+    result["status"]        = payment == "card" ? "pending" : "held";
+    return true;
+}
+
+/**
+ * Cancels through the reservation files, which also frees the seat and the hold.
+ */
+static bool runCancel(const json& cmd, json& result, RunState& state)
+{
+    METRIC_SCOPE("CommandRunner::cancel");
+    const string resID = cmd.value("reservationID", "");
+    flushBookings(state);
+    if (!Reservation::cancelReservation(resID))
+    {
+        result["error"] = "reservation " + resID + " not found";
+        return false;
+    }
+    state.byID.erase(resID);
+    return true;
+}
+
+/**
+ * Cash confirmation with the same idempotency key as the menus, so a repeated command
+ * (or one already run interactively) reports the recorded outcome.
+ */
+static bool runConfirm(const json& cmd, json& result, RunState& state)
+{
+    METRIC_SCOPE("CommandRunner::confirm");
+    const string resID = cmd.value("reservationID", "");
+    flushBookings(state);
+
+    string key = "cash:" + resID, outcome;
+    IdempotencyState found = IdempotencyIndex::begin(key, outcome);
+    if (found != IdempotencyState::New)
+    {
+        result["status"] = found == IdempotencyState::Completed ? outcome : "in progress";
+        return true;
+    }
+
+    auto it = state.byID.find(resID);
+    if (it == state.byID.end() || it->second->getIsPaid() || it->second->isPaymentPending())
+    {
+        IdempotencyIndex::abandon(key);
+        result["error"] = "reservation " + resID + " not found or not awaiting cash";
+        return false;
+    }
+
+    auto& res = it->second;
+    if (SeatHold::hasLapsed(res->getHoldExpiresAt()))
+    {
+        IdempotencyIndex::complete(key, "expired");
+        state.byID.erase(it);
+        result["error"] = "hold on reservation " + resID + " has expired";
+        return false;
+    }
+
+    // The hold stays armed until the payment is on file; confirmPayments clears it
+    if (Reservation::confirmPayments({ resID }, "Cash") == 0)
+    {
+        IdempotencyIndex::abandon(key);
+        result["error"] = "reservation " + resID + " was canceled";
+        return false;
+    }
+
+    res->setIsPaid(true);
+    res->setHoldExpiresAt(0);
+    IdempotencyIndex::complete(key, "confirmed");
+    result["status"] = "confirmed";
+    return true;
+}
+
+/**
+ * Schedule and sales totals, counted per fare bucket like the operational report, and
+ * optionally broken down by "groupBy" (flight, route, month, aircraft or channel).
+ */
+static bool runReport(const json& cmd, json& result, RunState& state)
+{
+    METRIC_SCOPE("CommandRunner::report");
+    ReportGrouping grouping = ReportGrouping::Flight;
+    if (cmd.contains("groupBy") &&
+        !ReportEngine::parseGrouping(cmd.value("groupBy", ""), grouping))
+    {
+        result["error"] = "unknown groupBy";
+        return false;
+    }
+    flushBookings(state);
+
+    ReportTotals totals = ReportEngine::aggregate();
+    result["flights"]      = FlightRegistry::totalFlights();
+    result["completed"]    = FlightRegistry::statusCount(FlightStatus::Completed);
+    result["delayed"]      = FlightRegistry::statusCount(FlightStatus::Delayed);
+    result["canceled"]     = FlightRegistry::statusCount(FlightStatus::Canceled);
+    result["reservations"] = totals.reservations;
+    result["unpaid"]       = totals.unpaid;
+    result["revenue"]      = totals.revenueCents / 100.0;
+    if (cmd.contains("groupBy"))
+        result["groups"] = ReportEngine::toJson(ReportEngine::group(totals, grouping), grouping);
+    return true;
+}
+
+/**
+ * Prints the failure records of bookings dropped since the last command and counts each
+ * of them as a failed command.
+ */
+static void printDropped(RunState& state, ostream& results, size_t& failed)
+{
+    for (auto const& record : state.dropped)
+        results << record.dump() << '\n';
+    failed += state.dropped.size();
+    state.dropped.clear();
+}
+
+/**
+ * Opens the command file (or takes stdin) and runs it against stdout.
+ */
+int CommandRunner::runFile(const string& path, const StartupData* preloaded)
+{
+    if (path == "-")
+        return run(cin, cout, preloaded);
+
+    ifstream in(path);
+    if (!in.is_open())
+    {
+        cerr << "Error: Unable to open command file " << path << ".\n";
+        return COMMAND_EXIT_BAD_INPUT;
+    }
+    return run(in, cout, preloaded);
+}
+
+/**
+ * Results go to out's buffer as it was on entry; cout itself is pointed at a discarding
+ * buffer until every queued charge has settled, so menu-style messages from the domain
+ * layer (and from payment callbacks) never interleave with the JSON lines.
+ */
+int CommandRunner::run(istream& in, ostream& out, const StartupData* preloaded)
+{
+    ostream results(out.rdbuf());
+    DiscardBuffer discard;
+    streambuf* console = cout.rdbuf(&discard);
+
+    auto started = chrono::steady_clock::now();
+    RunState state;
+    auto reservations = preloaded ? preloaded->reservations : Reservation::loadReservations();
+    for (auto const& res : reservations)
+        state.byID.emplace(res->getReservationID(), res);
+
+    size_t lineNumber = 0, commands = 0, failed = 0;
+    string line;
+    while (getline(in, line))
+    {
+        ++lineNumber;
+        if (line.find_first_not_of(" \t\r") == string::npos)
+            continue;
+        ++commands;
+
+        json cmd = json::parse(line, nullptr, false);
+        json result = { {"line", lineNumber} };
+        bool ok = false;
+        if (cmd.is_discarded() || !cmd.is_object())
+        {
+            result["error"] = "malformed command";
+        }
+        else
+        {
+            const string op = cmd.value("op", "");
+            result["op"] = op;
+            if (cmd.contains("id"))
+                result["id"] = cmd["id"];
+
+            if (op == "search")       ok = runSearch(cmd, result);
+            else if (op == "book")    ok = runBook(cmd, result, state);
+            else if (op == "cancel")  ok = runCancel(cmd, result, state);
+            else if (op == "confirm") ok = runConfirm(cmd, result, state);
+            else if (op == "report")  ok = runReport(cmd, result, state);
+            else if (op == "metrics") { result["metrics"] = Metrics::snapshot(); ok = true; }
+            else                      result["error"] = "unknown op '" + op + "'";
+        }
+
+        printDropped(state, results, failed);
+        result["ok"] = ok;
+        failed += ok ? 0 : 1;
+        results << result.dump() << '\n';
+    }
+
+    flushBookings(state);
+    printDropped(state, results, failed);
+    PaymentPipeline::drain();
+    cout.rdbuf(console);
+    cout.clear();
+
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - started);
+    json summary = { {"summary", true}, {"commands", commands}, {"failed", failed},
+                     {"elapsedMs", elapsed.count()} };
+    if (preloaded)
+        summary["startupMs"] = preloaded->loadMs + preloaded->indexMs;
+    results << summary.dump() << endl;
+
+    if (in.bad())
+        return COMMAND_EXIT_BAD_INPUT;
+    return failed ? COMMAND_EXIT_FAILURES : COMMAND_EXIT_OK;
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
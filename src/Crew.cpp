@@ -8,6 +8,8 @@
  ******************************************************************************************/
 
 #include "../header/Crew.hpp"
+#include "../header/Metrics.hpp"
+#include "../header/MemoryAccounting.hpp"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
@@ -22,13 +24,13 @@ std::vector<Crew> allCrewMembers;
  * Constructor: Initializes a Crew member with name and role.
  */
 Crew::Crew(std::string name, std::string role)
-    : name(name), role(role)
+    : name(std::move(name)), role(std::move(role))
 {}
 
 /**
  * Getter: Returns the crew member's name.
  */
-std::string Crew::getName(void) const
+const std::string& Crew::getName(void) const
 {
     return name;
 }
@@ -36,7 +38,7 @@ std::string Crew::getName(void) const
 /**
  * Getter: Returns the crew member's role.
  */
-std::string Crew::getRole(void) const
+const std::string& Crew::getRole(void) const
 {
     return role;
 }
@@ -44,7 +46,7 @@ std::string Crew::getRole(void) const
 /**
  * Getter: Returns the list of flights assigned to this crew member.
  */
-std::vector<std::shared_ptr<Flight>> Crew::getAssignedFlights(void) const
+const std::vector<std::shared_ptr<Flight>>& Crew::getAssignedFlights(void) const
 {
     return assignedFlights;
 }
@@ -54,7 +56,7 @@ std::vector<std::shared_ptr<Flight>> Crew::getAssignedFlights(void) const
  */
 void Crew::assignFlight(std::shared_ptr<Flight> flight)
 {
-    assignedFlights.push_back(flight);
+    assignedFlights.push_back(std::move(flight));
 }
 
 /**
@@ -126,6 +128,8 @@ void Crew::saveCrewToFile(const std::string& filename)
  */
 void Crew::loadCrewFromFile(const std::string& filename)
 {
+    METRIC_SCOPE("Crew::loadCrewFromFile");
+    MEMORY_TAG(Crew);
     std::ifstream inFile(filename);
     if (!inFile.is_open())
     {
@@ -134,25 +138,21 @@ void Crew::loadCrewFromFile(const std::string& filename)
     }
 
     json crewJson;
-    inFile >> crewJson;
+    {
+        MEMORY_TAG(Json);
+        inFile >> crewJson;
+    }
     inFile.close();
+    METRIC_RECORDS(crewJson.size());
 
     for (auto& element : crewJson.items())
     {
-        std::string crewName       = element.key();
-        auto        flightsData    = element.value();
-
-        Crew crewMember(crewName, "Role Placeholder");
-
-        for (auto& flightJson : flightsData)
-        {
-            std::shared_ptr<Flight> flightPtr =
-                std::make_shared<Flight>(Flight::fromJson(flightJson));
+        Crew crewMember(element.key(), "Role Placeholder");
 
-            crewMember.assignFlight(flightPtr);
-        }
+        for (auto const& flightJson : element.value())
+            crewMember.assignFlight(std::make_shared<Flight>(Flight::fromJson(flightJson)));
 
-        allCrewMembers.push_back(crewMember);
+        allCrewMembers.push_back(std::move(crewMember));
     }
 }
 
@@ -249,6 +249,14 @@ void Crew::updateCrewInFile(const std::string& crewName,
     }
 }
 
+/**
+ * Size of the in-memory crew list.
+ */
+size_t Crew::crewCount(void)
+{
+    return allCrewMembers.size();
+}
+
 /******************************************************************************************
  * END OF FILE
  ******************************************************************************************/
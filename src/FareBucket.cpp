@@ -0,0 +1,161 @@
+/******************************************************************************************
+ * MODULE NAME    : Fare Bucket Module
+ * FILE           : FareBucket.cpp
+ * DESCRIPTION    : Implements fare table parsing, validation, JSON conversion and the
+ *                  fare class prompt used by the booking flows.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/FareBucket.hpp"
+#include "../header/Flight.hpp"
+#include "../header/SeatInventory.hpp"
+#include <iostream>
+#include <set>
+#include <sstream>
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * Capacity plus the overbooking allowance, rounded down.
+ */
+int authorizedCapacity(int totalSeats, int overbookingPercent)
+{
+    return totalSeats + totalSeats * overbookingPercent / 100;
+}
+
+/**
+ * Enforces the invariants nested availability relies on.
+ */
+bool validateFareBuckets(const vector<FareBucket>& buckets)
+{
+    if (buckets.empty() || buckets.size() > MAX_FARE_BUCKETS)
+        return false;
+
+    set<string> codes;
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        if (buckets[i].code.empty() || !codes.insert(buckets[i].code).second)
+            return false;
+        if (buckets[i].bookingLimit <= 0)
+            return false;
+        if (i > 0 && buckets[i].bookingLimit > buckets[i - 1].bookingLimit)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Splits the comma-separated entries and each entry on ':'.
+ */
+bool parseFareBuckets(const string& text, vector<FareBucket>& buckets)
+{
+    vector<FareBucket> parsed;
+    stringstream entries(text);
+    string entry;
+
+    while (getline(entries, entry, ','))
+    {
+        size_t first = entry.find(':');
+        size_t second = first == string::npos ? string::npos : entry.find(':', first + 1);
+        if (second == string::npos)
+            return false;
+
+        FareBucket bucket;
+        bucket.code  = entry.substr(0, first);
+        bucket.price = entry.substr(first + 1, second - first - 1);
+        try
+        {
+            bucket.bookingLimit = stoi(entry.substr(second + 1));
+        }
+        catch (const exception&)
+        {
+            return false;
+        }
+        parsed.push_back(bucket);
+    }
+
+    if (!validateFareBuckets(parsed))
+        return false;
+    buckets = move(parsed);
+    return true;
+}
+
+/**
+ * Serialises the buckets in order.
+ */
+json fareBucketsToJson(const vector<FareBucket>& buckets)
+{
+    json j = json::array();
+    for (auto const& b : buckets)
+        j.push_back({ {"code", b.code}, {"price", b.price}, {"bookingLimit", b.bookingLimit} });
+    return j;
+}
+
+/**
+ * Deserialises the buckets; malformed entries are skipped.
+ */
+vector<FareBucket> fareBucketsFromJson(const json& j)
+{
+    vector<FareBucket> buckets;
+    if (!j.is_array())
+        return buckets;
+
+    for (auto const& b : j)
+    {
+        if (b.contains("code") && b.contains("price") && b.contains("bookingLimit"))
+            buckets.push_back({ b.at("code").get<string>(), b.at("price").get<string>(),
+                                b.at("bookingLimit").get<int>() });
+    }
+    return buckets;
+}
+
+/**
+ * Shows each bucket with its nested availability and reads the choice.
+ */
+bool selectFareBucket(const Flight& flight, string& fareClass)
+{
+    auto const& buckets = flight.getFareBuckets();
+    vector<size_t> open;
+    for (size_t i = 0; i < buckets.size(); ++i)
+        if (SeatInventory::fareAvailability(flight.getFlightNumber(), buckets[i].code) > 0)
+            open.push_back(i);
+
+    if (open.empty())
+    {
+        cout << "Flight " << flight.getFlightNumber() << " is fully booked.\n";
+        return false;
+    }
+
+    if (open.size() == 1)
+    {
+        fareClass = buckets[open.front()].code;
+        return true;
+    }
+
+    cout << "\nAvailable Fare Classes:\n";
+    for (size_t i = 0; i < open.size(); ++i)
+    {
+        auto const& b = buckets[open[i]];
+        cout << i + 1 << ". " << b.code << " - " << b.price << " ("
+             << SeatInventory::fareAvailability(flight.getFlightNumber(), b.code) << " left)\n";
+    }
+    cout << "Choose a fare class: ";
+
+    size_t choice = 0;
+    cin >> choice;
+    if (!cin || choice < 1 || choice > open.size())
+    {
+        cin.clear();
+        cout << "Invalid fare class. Booking cancelled.\n";
+        return false;
+    }
+
+    fareClass = buckets[open[choice - 1]].code;
+    return true;
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
@@ -9,6 +9,11 @@
 
 #include "../header/Flight.hpp"
 #include "../header/json.hpp"
+#include "../header/FlightRegistry.hpp"
+#include "../header/SeatInventory.hpp"
+#include "../header/Metrics.hpp"
+#include "../header/MemoryAccounting.hpp"
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -19,41 +24,50 @@ using namespace std;
 using json = nlohmann::json;
 
 /**
- * Parameterized Constructor: Initializes a Flight with all details.
+ * Parameterized Constructor: Initializes a Flight with all details. Strings kept as they
+ * are arrive by value and are moved in; names that get interned are only read.
  */
-Flight::Flight(const string& flightNumber,
+Flight::Flight(string flightNumber,
                const string& origin,
                const string& destination,
-               const string& departureTime,
-               const string& arrivalTime,
+               string departureTime,
+               string arrivalTime,
                const string& aircraftType,
                int totalSeats,
                const string& status,
-               const string& flightPrice)
-    : flightNumber(flightNumber),
-      origin(origin),
-      destination(destination),
-      departureTime(departureTime),
-      arrivalTime(arrivalTime),
-      aircraftType(aircraftType),
+               string flightPrice)
+    : flightNumber(move(flightNumber)),
+      origin(SymbolTable::intern(origin)),
+      destination(SymbolTable::intern(destination)),
+      departureTime(move(departureTime)),
+      arrivalTime(move(arrivalTime)),
+      aircraftType(SymbolTable::intern(aircraftType)),
       totalSeats(totalSeats),
-      status(status),
-      flightPrice(flightPrice)
-{}
+      status(FlightStatus::Scheduled),
+      flightPrice(move(flightPrice)),
+      fareBuckets{ FareBucket{ DEFAULT_FARE_BUCKET, this->flightPrice, totalSeats } },
+      overbookingPercent(0)
+{
+    if (!flightStatusFromString(status, this->status))
+        cerr << "Warning: Unknown status '" << status << "' for flight "
+             << this->flightNumber << "; treating it as Scheduled.\n";
+}
 
 /**
  * Default Constructor: Initializes an empty Flight with default values.
  */
 Flight::Flight(void)
     : flightNumber(""),
-      origin(""),
-      destination(""),
+      origin(SymbolTable::intern("")),
+      destination(SymbolTable::intern("")),
       departureTime(""),
       arrivalTime(""),
-      aircraftType(""),
+      aircraftType(SymbolTable::intern("")),
       totalSeats(0),
-      status(""),
-      flightPrice("")
+      status(FlightStatus::Scheduled),
+      flightPrice(""),
+      fareBuckets{ FareBucket{ DEFAULT_FARE_BUCKET, "", 0 } },
+      overbookingPercent(0)
 {}
 
 /**
@@ -61,16 +75,29 @@ Flight::Flight(void)
  */
 void Flight::displayFlightInfo(void) const
 {
-    cout << "Flight Number : " << flightNumber   << '\n'
-         << "Origin        : " << origin         << '\n'
-         << "Destination   : " << destination    << '\n'
-         << "Departure Time: " << departureTime  << '\n'
-         << "Arrival Time  : " << arrivalTime    << '\n'
-         << "Aircraft Type : " << aircraftType   << '\n'
-         << "Total Seats   : " << totalSeats     << '\n'
-         << "Flight Status : " << status         << '\n'
-         << "Flight Price  : " << flightPrice    << '\n'
-         << "------------------------------------" << endl;
+    int seatsLeft = SeatInventory::seatsAvailable(flightNumber);
+
+    cout << "Flight Number : " << flightNumber      << '\n'
+         << "Origin        : " << getOrigin()       << '\n'
+         << "Destination   : " << getDestination()  << '\n'
+         << "Departure Time: " << departureTime     << '\n'
+         << "Arrival Time  : " << arrivalTime       << '\n'
+         << "Aircraft Type : " << getAircraftType() << '\n'
+         << "Total Seats   : " << totalSeats        << '\n'
+         << "Flight Status : " << getStatus()       << '\n'
+         << "Flight Price  : " << flightPrice    << '\n';
+    if (fareBuckets.size() > 1)
+    {
+        cout << "Fare Classes  :";
+        for (auto const& bucket : fareBuckets)
+            cout << ' ' << bucket.code << '=' << bucket.price;
+        cout << '\n';
+    }
+    if (overbookingPercent > 0)
+        cout << "Overbooking   : " << overbookingPercent << "%\n";
+    if (seatsLeft >= 0)
+        cout << "Seats Left    : " << seatsLeft << '\n';
+    cout << "------------------------------------" << endl;
 }
 
 /**
@@ -78,35 +105,74 @@ void Flight::displayFlightInfo(void) const
  */
 json Flight::toJson(void) const
 {
-    return json{
+    json j{
         {"flightNumber", flightNumber},
-        {"origin",       origin},
-        {"destination",  destination},
+        {"origin",       getOrigin()},
+        {"destination",  getDestination()},
         {"departureTime", departureTime},
         {"arrivalTime",  arrivalTime},
-        {"aircraftType", aircraftType},
+        {"aircraftType", getAircraftType()},
         {"totalSeats",   totalSeats},
-        {"status",       status},
+        {"status",       getStatus()},
         {"price",        flightPrice}
     };
+
+    // Flights still on the implicit single-fare table are written exactly as before
+    if (fareBuckets.size() > 1 || fareBuckets.front().code != DEFAULT_FARE_BUCKET)
+        j["fareBuckets"] = fareBucketsToJson(fareBuckets);
+    if (overbookingPercent > 0)
+        j["overbookingPercent"] = overbookingPercent;
+    return j;
+}
+
+/**
+ * Fare buckets are parsed from a plain tree; an arena subtree is copied out, a plain one
+ * is used as is.
+ */
+static const json& asPlainJson(const json& j)
+{
+    return j;
+}
+
+static json asPlainJson(const ArenaJson& j)
+{
+    return json(j);
 }
 
 /**
  * Creates a Flight object from its JSON representation.
  */
-Flight Flight::fromJson(const json& j)
+template <typename Json>
+Flight Flight::fromJsonOf(const Json& j)
 {
-    return Flight(
-        j.at("flightNumber").get<string>(),
-        j.at("origin").get<string>(),
-        j.at("destination").get<string>(),
-        j.at("departureTime").get<string>(),
-        j.at("arrivalTime").get<string>(),
-        j.at("aircraftType").get<string>(),
-        j.at("totalSeats").get<int>(),
-        j.at("status").get<string>(),
-        j.at("price").get<string>()
+    Flight fl(
+        j.at("flightNumber").template get<string>(),
+        j.at("origin").template get<string>(),
+        j.at("destination").template get<string>(),
+        j.at("departureTime").template get<string>(),
+        j.at("arrivalTime").template get<string>(),
+        j.at("aircraftType").template get<string>(),
+        j.at("totalSeats").template get<int>(),
+        j.at("status").template get<string>(),
+        j.at("price").template get<string>()
     );
+
+    if (j.contains("fareBuckets") && !fl.setFareBuckets(fareBucketsFromJson(asPlainJson(j.at("fareBuckets")))))
+        cerr << "Warning: Invalid fare buckets for flight " << fl.flightNumber
+             << "; using a single fare.\n";
+    if (j.contains("overbookingPercent"))
+        fl.setOverbookingPercent(j.at("overbookingPercent").template get<int>());
+    return fl;
+}
+
+Flight Flight::fromJson(const json& j)
+{
+    return fromJsonOf(j);
+}
+
+Flight Flight::fromJson(const ArenaJson& j)
+{
+    return fromJsonOf(j);
 }
 
 /**
@@ -114,6 +180,7 @@ Flight Flight::fromJson(const json& j)
  */
 void Flight::saveFlights(const vector<Flight>& flights, const string& filename)
 {
+    METRIC_SCOPE("Flight::saveFlights");
     json flightsArray = json::array();
     for (auto const& flight : flights)
         flightsArray.push_back(flight.toJson());
@@ -126,6 +193,7 @@ void Flight::saveFlights(const vector<Flight>& flights, const string& filename)
     }
 
     file << setw(4) << flightsArray << endl;
+    METRIC_BYTES_WRITTEN(static_cast<uint64_t>(file.tellp()));
 }
 
 /**
@@ -133,21 +201,27 @@ void Flight::saveFlights(const vector<Flight>& flights, const string& filename)
  */
 vector<Flight> Flight::loadFlights(const string& filename)
 {
+    METRIC_SCOPE("Flight::loadFlights");
+    MEMORY_TAG(Flights);
     vector<Flight> flights;
-    ifstream file(filename);
 
-    if (!file.is_open())
+    // The file text and its parse tree live in an arena released in one step on return
+    auto arena = LoadArena::forFile(filename);
+    LoadArenaScope scope(*arena);
+    string_view text;
+    if (!arena->readFile(filename, text))
     {
         cerr << "No existing flights data found at " << filename << ".\n";
         return flights;
     }
+    METRIC_BYTES_READ(text.size());
 
-    json flightsJson;
-    file >> flightsJson;
-
+    ArenaJson flightsJson = ArenaJson::parse(text.begin(), text.end());
+    flights.reserve(flightsJson.size());
     for (auto const& flightJson : flightsJson)
         flights.push_back(Flight::fromJson(flightJson));
 
+    METRIC_RECORDS(flights.size());
     return flights;
 }
 
@@ -159,6 +233,8 @@ void Flight::addFlightToFile(const Flight& newFlight, const string& filename)
     auto flights = loadFlights(filename);
     flights.push_back(newFlight);
     saveFlights(flights, filename);
+    if (filename == PATH_OF_FLIGHTS_DATA_BASE)
+        FlightRegistry::onFlightAdded(newFlight);
     cout << "Flight added successfully to " << filename << "!\n";
 }
 
@@ -169,6 +245,7 @@ void Flight::removeFlightFromFile(const string& flightNumber, const string& file
 {
     auto flights = loadFlights(filename);
     vector<Flight> updated;
+    Flight removed;
     bool found = false;
 
     for (auto const& fl : flights)
@@ -176,7 +253,10 @@ void Flight::removeFlightFromFile(const string& flightNumber, const string& file
         if (fl.getFlightNumber() != flightNumber)
             updated.push_back(fl);
         else
+        {
+            removed = fl;
             found = true;
+        }
     }
 
     if (!found)
@@ -186,6 +266,8 @@ void Flight::removeFlightFromFile(const string& flightNumber, const string& file
     }
 
     saveFlights(updated, filename);
+    if (filename == PATH_OF_FLIGHTS_DATA_BASE)
+        FlightRegistry::onFlightRemoved(removed);
     cout << "Flight " << flightNumber << " removed successfully from " << filename << "!\n";
 }
 
@@ -199,25 +281,60 @@ void Flight::updateFlightInFile(const string& flightNumber,
 {
     auto flights = loadFlights(filename);
     bool found = false;
+    Flight before, after;
 
     for (auto& fl : flights)
     {
         if (fl.getFlightNumber() == flightNumber)
         {
             found = true;
+            before = fl;
 
             if      (fieldToUpdate == "departureTime") fl.setDepartureTime(newValue);
             else if (fieldToUpdate == "arrivalTime")   fl.setArrivalTime(newValue);
-            else if (fieldToUpdate == "status")        fl.setStatus(newValue);
+            else if (fieldToUpdate == "status")
+            {
+                if (!fl.setStatus(newValue))
+                    return;
+            }
             else if (fieldToUpdate == "origin")        fl.setOrigin(newValue);
             else if (fieldToUpdate == "destination")   fl.setDestination(newValue);
             else if (fieldToUpdate == "aircraftType")  fl.setAircraftType(newValue);
+            else if (fieldToUpdate == "totalSeats")
+            {
+                int seats = atoi(newValue.c_str());
+                if (seats <= 0)
+                {
+                    cout << "Invalid seat count: " << newValue << "\n";
+                    return;
+                }
+                fl.setTotalSeats(seats);
+            }
             else if (fieldToUpdate == "flightPrice")   fl.setflightPrice(newValue);
+            else if (fieldToUpdate == "fareBuckets")
+            {
+                vector<FareBucket> buckets;
+                if (!parseFareBuckets(newValue, buckets) || !fl.setFareBuckets(move(buckets)))
+                {
+                    cout << "Invalid fare buckets: " << newValue
+                         << " (expected CODE:PRICE:LIMIT,... with non-increasing limits)\n";
+                    return;
+                }
+            }
+            else if (fieldToUpdate == "overbookingPercent")
+            {
+                if (!fl.setOverbookingPercent(atoi(newValue.c_str())))
+                {
+                    cout << "Invalid overbooking percent: " << newValue << "\n";
+                    return;
+                }
+            }
             else
             {
                 cout << "Invalid field name: " << fieldToUpdate << "\n";
                 return;
             }
+            after = fl;
             break;
         }
     }
@@ -229,30 +346,116 @@ void Flight::updateFlightInFile(const string& flightNumber,
     }
 
     saveFlights(flights, filename);
+    if (filename == PATH_OF_FLIGHTS_DATA_BASE)
+        FlightRegistry::onFlightUpdated(before, after);
     cout << "Flight " << flightNumber << " updated successfully in " << filename << "!\n";
 }
 
 
 void Flight::setFlightNumber(const string& fn)   { flightNumber = fn; }
-void Flight::setOrigin(const string& o)          { origin = o; }
-void Flight::setDestination(const string& d)     { destination = d; }
+void Flight::setOrigin(const string& o)          { origin = SymbolTable::intern(o); }
+void Flight::setDestination(const string& d)     { destination = SymbolTable::intern(d); }
 void Flight::setDepartureTime(const string& dt)  { departureTime = dt; }
 void Flight::setArrivalTime(const string& at)    { arrivalTime = at; }
-void Flight::setAircraftType(const string& atype){ aircraftType = atype; }
+void Flight::setAircraftType(const string& atype){ aircraftType = SymbolTable::intern(atype); }
 void Flight::setTotalSeats(int seats)            { totalSeats = seats; }
-void Flight::setStatus(const string& st)         { status = st; }
-void Flight::setflightPrice(const string& price) { flightPrice = price; }
-
-
-string Flight::getFlightNumber(void) const { return flightNumber; }
-string Flight::getflightPrice(void) const  { return flightPrice; }
-string Flight::getOrigin(void) const       { return origin; }
-string Flight::getDestination(void) const  { return destination; }
-string Flight::getDepartureTime(void) const{ return departureTime; }
-string Flight::getArrivalTime(void) const  { return arrivalTime; }
-string Flight::getAircraftType(void) const { return aircraftType; }
-int    Flight::getTotalSeats(void) const   { return totalSeats; }
-string Flight::getStatus(void) const       { return status; }
+/**
+ * Applies a status change if the name is valid and the state machine allows it.
+ */
+bool Flight::setStatus(const string& st)
+{
+    FlightStatus next;
+    if (!flightStatusFromString(st, next))
+    {
+        cout << "Invalid status: " << st << " (expected Scheduled, Delayed, Canceled or Completed)\n";
+        return false;
+    }
+    if (!isValidStatusTransition(status, next))
+    {
+        cout << "Invalid status transition: " << getStatus() << " -> "
+             << flightStatusToString(next) << "\n";
+        return false;
+    }
+    status = next;
+    return true;
+}
+void Flight::setflightPrice(const string& price)
+{
+    flightPrice = price;
+    fareBuckets.front().price = price;
+}
+
+/**
+ * Installs a validated fare table and mirrors its first price into flightPrice.
+ */
+bool Flight::setFareBuckets(vector<FareBucket> buckets)
+{
+    if (!validateFareBuckets(buckets))
+        return false;
+    fareBuckets = move(buckets);
+    flightPrice = fareBuckets.front().price;
+    return true;
+}
+
+/**
+ * Accepts an overbooking allowance between 0 and 100 percent.
+ */
+bool Flight::setOverbookingPercent(int percent)
+{
+    if (percent < 0 || percent > 100)
+        return false;
+    overbookingPercent = percent;
+    return true;
+}
+
+/**
+ * Linear lookup; a flight has at most MAX_FARE_BUCKETS buckets.
+ */
+const FareBucket* Flight::findFareBucket(const string& code) const
+{
+    for (auto const& bucket : fareBuckets)
+        if (bucket.code == code)
+            return &bucket;
+    return nullptr;
+}
+
+
+const string& Flight::getFlightNumber(void) const { return flightNumber; }
+const string& Flight::getflightPrice(void) const  { return flightPrice; }
+const string& Flight::getOrigin(void) const       { return SymbolTable::name(origin); }
+const string& Flight::getDestination(void) const  { return SymbolTable::name(destination); }
+const string& Flight::getDepartureTime(void) const{ return departureTime; }
+const string& Flight::getArrivalTime(void) const  { return arrivalTime; }
+const string& Flight::getAircraftType(void) const { return SymbolTable::name(aircraftType); }
+int           Flight::getTotalSeats(void) const   { return totalSeats; }
+const vector<FareBucket>& Flight::getFareBuckets(void) const { return fareBuckets; }
+int           Flight::getOverbookingPercent(void) const { return overbookingPercent; }
+int           Flight::getAuthorizedCapacity(void) const
+{
+    return authorizedCapacity(totalSeats, overbookingPercent);
+}
+const string& Flight::getStatus(void) const       { return flightStatusToString(status); }
+FlightStatus  Flight::getStatusCode(void) const   { return status; }
+
+SymbolTable::Symbol Flight::getOriginID(void) const       { return origin; }
+SymbolTable::Symbol Flight::getDestinationID(void) const  { return destination; }
+SymbolTable::Symbol Flight::getAircraftTypeID(void) const { return aircraftType; }
+
+/**
+ * Route predicate used by the search loops; compares without copying.
+ */
+bool Flight::servesRoute(string_view o, string_view d) const
+{
+    return servesRoute(SymbolTable::find(o), SymbolTable::find(d));
+}
+
+/**
+ * Route predicate on interned IDs: two integer compares.
+ */
+bool Flight::servesRoute(SymbolTable::Symbol o, SymbolTable::Symbol d) const
+{
+    return origin == o && destination == d;
+}
 
 /******************************************************************************************
  * END OF FILE
@@ -0,0 +1,203 @@
+/******************************************************************************************
+ * MODULE NAME    : Flight Registry Module
+ * FILE           : FlightRegistry.cpp
+ * DESCRIPTION    : Implements the FlightRegistry live counters over the flight schedule.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/FlightRegistry.hpp"
+#include "../header/SeatInventory.hpp"
+#include "../header/SeatMap.hpp"
+#include <array>
+#include <atomic>
+#include <mutex>
+
+using namespace std;
+
+static array<atomic<int>, FLIGHT_STATUS_COUNT> statusCounters;
+static atomic<int>                              flightCount(0);
+static atomic<bool>                             registrySeeded(false);
+static once_flag                                registrySeedOnce;
+
+// Current table snapshot; writers copy, modify and swap it under the mutex
+static shared_ptr<const FlightTable>            tableSnapshot = make_shared<FlightTable>();
+static mutex                                    tableMutex;
+
+// Time-expanded route graph, patched leg by leg (it locks internally)
+static RouteGraph                               routeGraph;
+
+/**
+ * Copies the current table, applies an edit and publishes the result.
+ */
+template <typename Edit>
+static shared_ptr<const FlightTable> editTable(Edit edit)
+{
+    lock_guard<mutex> lock(tableMutex);
+    auto next = make_shared<FlightTable>(*tableSnapshot);
+    edit(*next);
+    tableSnapshot = next;
+    return tableSnapshot;
+}
+
+/**
+ * Seeds the counters from the flights file the first time they are read. Updates that
+ * happen before this point are already reflected in the file, so hooks skip them.
+ */
+static void seedRegistry(void)
+{
+    call_once(registrySeedOnce, []()
+    {
+        auto flights = Flight::loadFlights(PATH_OF_FLIGHTS_DATA_BASE);
+        for (auto const& fl : flights)
+            ++statusCounters[static_cast<size_t>(fl.getStatusCode())];
+
+        flightCount    = static_cast<int>(flights.size());
+
+        {
+            lock_guard<mutex> lock(tableMutex);
+            tableSnapshot = make_shared<FlightTable>(FlightTable::fromFlights(flights));
+            routeGraph.build(*tableSnapshot);
+        }
+        registrySeeded = true;
+    });
+}
+
+/**
+ * Returns the live count for one status.
+ */
+int FlightRegistry::statusCount(FlightStatus status)
+{
+    seedRegistry();
+    return statusCounters[static_cast<size_t>(status)].load();
+}
+
+/**
+ * Returns the live number of scheduled flights of any status.
+ */
+int FlightRegistry::totalFlights(void)
+{
+    seedRegistry();
+    return flightCount.load();
+}
+
+/**
+ * Returns the latest table snapshot.
+ */
+shared_ptr<const FlightTable> FlightRegistry::table(void)
+{
+    seedRegistry();
+    lock_guard<mutex> lock(tableMutex);
+    return tableSnapshot;
+}
+
+/**
+ * Returns the route graph after making sure it has been built.
+ */
+const RouteGraph& FlightRegistry::routes(void)
+{
+    seedRegistry();
+    return routeGraph;
+}
+
+/**
+ * Answers a direct-flight query from the cache, or scans the table and caches the rows.
+ */
+SearchCache::Results FlightRegistry::findDirectFlights(const string& origin, const string& destination,
+                                                       int32_t fromMinute, int32_t toMinute)
+{
+    SearchQuery query{ origin, destination, fromMinute, toMinute };
+    query.normalize();
+
+    if (auto cached = SearchCache::lookup(query))
+        return cached;
+
+    // Read the generation before the snapshot so a concurrent edit makes store() a no-op
+    uint64_t generation = SearchCache::generation();
+    auto snapshot = table();
+
+    vector<uint32_t> rows;
+    snapshot->filterByRouteAndDate(SymbolTable::find(query.origin), SymbolTable::find(query.destination),
+                                   fromMinute, toMinute, rows);
+
+    auto matches = make_shared<vector<Flight>>();
+    matches->reserve(rows.size());
+    for (auto row : rows)
+        matches->push_back(snapshot->row(row));
+
+    SearchCache::store(query, matches, generation);
+    return matches;
+}
+
+/**
+ * Counts a newly added flight and appends its row.
+ */
+void FlightRegistry::onFlightAdded(const Flight& flight)
+{
+    if (!registrySeeded)
+        return;
+
+    ++statusCounters[static_cast<size_t>(flight.getStatusCode())];
+    ++flightCount;
+    auto snapshot = editTable([&](FlightTable& t) { t.append(flight); });
+    routeGraph.addLeg(*snapshot, snapshot->size() - 1);
+    SearchCache::invalidateFlight(flight);
+    SeatInventory::onFlightAdded(flight);
+}
+
+/**
+ * Uncounts a removed flight and drops its row.
+ */
+void FlightRegistry::onFlightRemoved(const Flight& flight)
+{
+    if (!registrySeeded)
+        return;
+
+    --statusCounters[static_cast<size_t>(flight.getStatusCode())];
+    --flightCount;
+    editTable([&](FlightTable& t)
+    {
+        long row = t.findRow(flight.getFlightNumber());
+        if (row >= 0)
+            t.erase(static_cast<size_t>(row));
+    });
+    routeGraph.removeLeg(flight.getFlightNumber());
+    SearchCache::invalidateFlight(flight);
+    SeatInventory::onFlightRemoved(flight);
+    SeatMap::invalidate(flight.getFlightNumber());
+}
+
+/**
+ * Moves the flight between status counters if needed and rewrites its row.
+ */
+void FlightRegistry::onFlightUpdated(const Flight& before, const Flight& after)
+{
+    if (!registrySeeded)
+        return;
+
+    if (before.getStatusCode() != after.getStatusCode())
+    {
+        --statusCounters[static_cast<size_t>(before.getStatusCode())];
+        ++statusCounters[static_cast<size_t>(after.getStatusCode())];
+    }
+    auto snapshot = editTable([&](FlightTable& t)
+    {
+        long row = t.findRow(before.getFlightNumber());
+        if (row >= 0)
+            t.update(static_cast<size_t>(row), after);
+    });
+
+    long row = snapshot->findRow(after.getFlightNumber());
+    if (row >= 0)
+        routeGraph.addLeg(*snapshot, static_cast<size_t>(row));
+
+    // Queries that listed the old version, and queries the new version now matches
+    SearchCache::invalidateFlight(before);
+    SearchCache::invalidateFlight(after);
+    SeatInventory::onFlightUpdated(before, after);
+    SeatMap::invalidate(before.getFlightNumber());
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
@@ -0,0 +1,82 @@
+/******************************************************************************************
+ * MODULE NAME    : Flight Status Module
+ * FILE           : FlightStatus.cpp
+ * DESCRIPTION    : Implements FlightStatus string conversions and transition rules.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/FlightStatus.hpp"
+#include <array>
+#include <cctype>
+
+using namespace std;
+
+static const array<string, FLIGHT_STATUS_COUNT> statusNames = {
+    "Scheduled", "Delayed", "Canceled", "Completed"
+};
+
+/*
+ * Allowed transitions, indexed [from][to]:
+ *   Scheduled -> Delayed, Canceled, Completed
+ *   Delayed   -> Scheduled (back on time), Canceled, Completed
+ *   Canceled and Completed are terminal.
+ */
+static const bool statusTransitions[FLIGHT_STATUS_COUNT][FLIGHT_STATUS_COUNT] = {
+    /* from Scheduled */ { true,  true,  true,  true  },
+    /* from Delayed   */ { true,  true,  true,  true  },
+    /* from Canceled  */ { false, false, true,  false },
+    /* from Completed */ { false, false, false, true  }
+};
+
+/**
+ * Returns the name stored in JSON and shown on screen for a status.
+ */
+const string& flightStatusToString(FlightStatus status)
+{
+    return statusNames[static_cast<size_t>(status)];
+}
+
+/**
+ * Parses a status name, ignoring case; "Cancelled" is accepted as an alias.
+ */
+bool flightStatusFromString(string_view text, FlightStatus& status)
+{
+    auto equalsIgnoreCase = [](string_view a, string_view b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); ++i)
+            if (tolower(static_cast<unsigned char>(a[i])) != tolower(static_cast<unsigned char>(b[i])))
+                return false;
+        return true;
+    };
+
+    for (size_t i = 0; i < FLIGHT_STATUS_COUNT; ++i)
+    {
+        if (equalsIgnoreCase(text, statusNames[i]))
+        {
+            status = static_cast<FlightStatus>(i);
+            return true;
+        }
+    }
+
+    if (equalsIgnoreCase(text, "Cancelled"))
+    {
+        status = FlightStatus::Canceled;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Looks up the transition table.
+ */
+bool isValidStatusTransition(FlightStatus from, FlightStatus to)
+{
+    return statusTransitions[static_cast<size_t>(from)][static_cast<size_t>(to)];
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
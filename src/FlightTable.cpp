@@ -0,0 +1,327 @@
+/******************************************************************************************
+ * MODULE NAME    : Flight Table Module
+ * FILE           : FlightTable.cpp
+ * DESCRIPTION    : Implements the column-oriented FlightTable and its scan kernels.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/FlightTable.hpp"
+#include <cstdio>
+#include <cctype>
+#include <ctime>
+
+using namespace std;
+
+/**
+ * Builds a table with one row per flight.
+ */
+FlightTable FlightTable::fromFlights(const vector<Flight>& flights)
+{
+    FlightTable table;
+    for (auto const& fl : flights)
+        table.append(fl);
+    return table;
+}
+
+/**
+ * Returns the number of rows.
+ */
+size_t FlightTable::size(void) const
+{
+    return flightNumbers.size();
+}
+
+/**
+ * Hash lookup; called per reservation by the reports and the sales ledger.
+ */
+long FlightTable::findRow(const string& flightNumber) const
+{
+    auto it = rowByNumber.find(flightNumber);
+    return it == rowByNumber.end() ? -1 : static_cast<long>(it->second);
+}
+
+/**
+ * A duplicate flight number keeps pointing at its first row, as a scan would find.
+ */
+void FlightTable::indexRow(size_t index)
+{
+    auto added = rowByNumber.emplace(flightNumbers[index], index);
+    if (!added.second && added.first->second > index)
+        added.first->second = index;
+}
+
+/**
+ * Only duplicate flight numbers need the scan for the next occurrence.
+ */
+void FlightTable::unindexRow(size_t index)
+{
+    auto it = rowByNumber.find(flightNumbers[index]);
+    if (it == rowByNumber.end() || it->second != index)
+        return;
+
+    rowByNumber.erase(it);
+    for (size_t i = index + 1; i < flightNumbers.size(); ++i)
+    {
+        if (flightNumbers[i] == flightNumbers[index])
+        {
+            rowByNumber.emplace(flightNumbers[i], i);
+            return;
+        }
+    }
+}
+
+/**
+ * Rebuilds a Flight from the columns of one row.
+ */
+Flight FlightTable::row(size_t index) const
+{
+    Flight fl(
+        flightNumbers[index],
+        SymbolTable::name(originIDs[index]),
+        SymbolTable::name(destinationIDs[index]),
+        departureTimes[index],
+        arrivalTimes[index],
+        SymbolTable::name(aircraftTypeIDs[index]),
+        totalSeats[index],
+        flightStatusToString(static_cast<FlightStatus>(statuses[index])),
+        fareBuckets[index].front().price
+    );
+    fl.setFareBuckets(fareBuckets[index]);
+    fl.setOverbookingPercent(overbookingPercents[index]);
+    return fl;
+}
+
+/**
+ * Fills the fixed-width fare slots of a row; unused slots stay zero so the revenue
+ * kernel needs no per-row bucket count.
+ */
+void FlightTable::storeFares(size_t index, const Flight& flight)
+{
+    auto const& buckets = flight.getFareBuckets();
+    int64_t* slot = fareCents.data() + index * MAX_FARE_BUCKETS;
+    for (size_t b = 0; b < MAX_FARE_BUCKETS; ++b)
+        slot[b] = b < buckets.size() ? parsePriceCents(buckets[b].price) : 0;
+
+    fareBuckets[index]         = buckets;
+    overbookingPercents[index] = flight.getOverbookingPercent();
+}
+
+/**
+ * Appends one flight to every column.
+ */
+void FlightTable::append(const Flight& flight)
+{
+    originIDs.push_back(flight.getOriginID());
+    destinationIDs.push_back(flight.getDestinationID());
+    aircraftTypeIDs.push_back(flight.getAircraftTypeID());
+    departureMinutes.push_back(parseDateTime(flight.getDepartureTime()));
+    arrivalMinutes.push_back(parseDateTime(flight.getArrivalTime()));
+    totalSeats.push_back(flight.getTotalSeats());
+    statuses.push_back(static_cast<uint8_t>(flight.getStatusCode()));
+    overbookingPercents.push_back(0);
+    fareCents.resize(fareCents.size() + MAX_FARE_BUCKETS);
+
+    flightNumbers.push_back(flight.getFlightNumber());
+    departureTimes.push_back(flight.getDepartureTime());
+    arrivalTimes.push_back(flight.getArrivalTime());
+    fareBuckets.emplace_back();
+    storeFares(size() - 1, flight);
+    indexRow(size() - 1);
+}
+
+/**
+ * Overwrites every column of one row.
+ */
+void FlightTable::update(size_t index, const Flight& flight)
+{
+    originIDs[index]       = flight.getOriginID();
+    destinationIDs[index]  = flight.getDestinationID();
+    aircraftTypeIDs[index] = flight.getAircraftTypeID();
+    departureMinutes[index] = parseDateTime(flight.getDepartureTime());
+    arrivalMinutes[index]   = parseDateTime(flight.getArrivalTime());
+    totalSeats[index]      = flight.getTotalSeats();
+    statuses[index]        = static_cast<uint8_t>(flight.getStatusCode());
+
+    if (flightNumbers[index] != flight.getFlightNumber())
+    {
+        unindexRow(index);
+        flightNumbers[index] = flight.getFlightNumber();
+        indexRow(index);
+    }
+    departureTimes[index] = flight.getDepartureTime();
+    arrivalTimes[index]   = flight.getArrivalTime();
+    storeFares(index, flight);
+}
+
+/**
+ * Removes one row from every column; the rows after it move up one in the index.
+ */
+void FlightTable::erase(size_t index)
+{
+    unindexRow(index);
+    for (size_t i = index + 1; i < flightNumbers.size(); ++i)
+    {
+        auto it = rowByNumber.find(flightNumbers[i]);
+        if (it != rowByNumber.end() && it->second == i)
+            it->second = i - 1;
+    }
+
+    originIDs.erase(originIDs.begin() + index);
+    destinationIDs.erase(destinationIDs.begin() + index);
+    aircraftTypeIDs.erase(aircraftTypeIDs.begin() + index);
+    departureMinutes.erase(departureMinutes.begin() + index);
+    arrivalMinutes.erase(arrivalMinutes.begin() + index);
+    totalSeats.erase(totalSeats.begin() + index);
+    statuses.erase(statuses.begin() + index);
+    overbookingPercents.erase(overbookingPercents.begin() + index);
+    fareCents.erase(fareCents.begin() + index * MAX_FARE_BUCKETS,
+                    fareCents.begin() + (index + 1) * MAX_FARE_BUCKETS);
+
+    flightNumbers.erase(flightNumbers.begin() + index);
+    departureTimes.erase(departureTimes.begin() + index);
+    arrivalTimes.erase(arrivalTimes.begin() + index);
+    fareBuckets.erase(fareBuckets.begin() + index);
+}
+
+/**
+ * Route/date filter. The first pass computes a 0/1 match flag per row with no branches
+ * so it vectorises; the second pass compacts the matching row numbers. The flags live
+ * in a block on the stack, FILTER_BLOCK_ROWS rows at a time, so a scan allocates
+ * nothing beyond the growth of rows.
+ */
+void FlightTable::filterByRouteAndDate(SymbolTable::Symbol originID,
+                                       SymbolTable::Symbol destinationID,
+                                       int32_t fromMinute,
+                                       int32_t toMinute,
+                                       vector<uint32_t>& rows) const
+{
+    const size_t n = size();
+    const SymbolTable::Symbol* orig = originIDs.data();
+    const SymbolTable::Symbol* dest = destinationIDs.data();
+    const int32_t*             dep  = departureMinutes.data();
+
+    uint8_t m[FILTER_BLOCK_ROWS];
+    for (size_t start = 0; start < n; start += FILTER_BLOCK_ROWS)
+    {
+        const size_t count = n - start < FILTER_BLOCK_ROWS ? n - start : FILTER_BLOCK_ROWS;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t r = start + i;
+            m[i] = static_cast<uint8_t>((orig[r] == originID) &
+                                        (dest[r] == destinationID) &
+                                        (dep[r] >= fromMinute) &
+                                        (dep[r] <= toMinute));
+        }
+
+        for (size_t i = 0; i < count; ++i)
+            if (m[i])
+                rows.push_back(static_cast<uint32_t>(start + i));
+    }
+}
+
+/**
+ * Revenue reduction over the flat fare column.
+ */
+int64_t FlightTable::sumRevenueCents(const vector<int32_t>& bookings) const
+{
+    const size_t   n      = fareCents.size();
+    const int64_t* price  = fareCents.data();
+    const int32_t* booked = bookings.data();
+
+    int64_t total = 0;
+    for (size_t i = 0; i < n; ++i)
+        total += price[i] * static_cast<int64_t>(booked[i]);
+    return total;
+}
+
+const string&       FlightTable::getFlightNumber(size_t i) const   { return flightNumbers[i]; }
+SymbolTable::Symbol FlightTable::getOriginID(size_t i) const       { return originIDs[i]; }
+SymbolTable::Symbol FlightTable::getDestinationID(size_t i) const  { return destinationIDs[i]; }
+int32_t             FlightTable::getDepartureMinute(size_t i) const { return departureMinutes[i]; }
+int32_t             FlightTable::getArrivalMinute(size_t i) const   { return arrivalMinutes[i]; }
+int32_t             FlightTable::getTotalSeats(size_t i) const     { return totalSeats[i]; }
+FlightStatus        FlightTable::getStatus(size_t i) const         { return static_cast<FlightStatus>(statuses[i]); }
+int64_t             FlightTable::getPriceCents(size_t i) const     { return fareCents[i * MAX_FARE_BUCKETS]; }
+int64_t             FlightTable::getFareCents(size_t i, size_t b) const { return fareCents[i * MAX_FARE_BUCKETS + b]; }
+const vector<FareBucket>& FlightTable::getFareBuckets(size_t i) const { return fareBuckets[i]; }
+
+/**
+ * Linear over at most MAX_FARE_BUCKETS codes.
+ */
+size_t FlightTable::fareBucketIndex(size_t index, const string& code) const
+{
+    auto const& buckets = fareBuckets[index];
+    for (size_t b = 0; b < buckets.size(); ++b)
+        if (buckets[b].code == code)
+            return b;
+    return 0;
+}
+
+int32_t FlightTable::currentMinute(void)
+{
+    return static_cast<int32_t>(time(nullptr) / 60);
+}
+
+/**
+ * Converts "YYYY-MM-DD HH:MM" to Unix minutes using the days-from-civil algorithm.
+ */
+int32_t FlightTable::parseDateTime(const string& text)
+{
+    int year, month, day, hour, minute;
+    char sep1, sep2, colon;
+    if (sscanf(text.c_str(), "%d%c%d%c%d %d%c%d",
+               &year, &sep1, &month, &sep2, &day, &hour, &colon, &minute) != 8 ||
+        sep1 != '-' || sep2 != '-' || colon != ':' ||
+        month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour < 0 || hour > 23 || minute < 0 || minute > 59)
+    {
+        return -1;
+    }
+
+    int64_t y   = year - (month <= 2);
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int64_t days = era * 146097 + doe - 719468;
+
+    return static_cast<int32_t>(days * 1440 + hour * 60 + minute);
+}
+
+/**
+ * Reads the first decimal amount in a price string and returns it in cents.
+ */
+int64_t FlightTable::parsePriceCents(const string& text)
+{
+    int64_t whole = 0, fraction = 0;
+    int     fractionDigits = 0;
+    bool    seenDigit = false, inFraction = false;
+
+    for (char c : text)
+    {
+        if (isdigit(static_cast<unsigned char>(c)))
+        {
+            seenDigit = true;
+            if (!inFraction)
+                whole = whole * 10 + (c - '0');
+            else if (fractionDigits < 2)
+            {
+                fraction = fraction * 10 + (c - '0');
+                ++fractionDigits;
+            }
+        }
+        else if (c == '.' && seenDigit && !inFraction)
+            inFraction = true;
+        else if (seenDigit)
+            break;
+    }
+
+    if (fractionDigits == 1)
+        fraction *= 10;
+    return whole * 100 + fraction;
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
@@ -0,0 +1,176 @@
+/******************************************************************************************
+ * MODULE NAME    : Idempotency Index Module
+ * FILE           : IdempotencyIndex.cpp
+ * DESCRIPTION    : Implements the bounded, persisted dedup index for payment operations.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/IdempotencyIndex.hpp"
+#include "../header/json.hpp"
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * State of one key. Completed keys are also linked into completionOrder for eviction.
+ */
+struct KeyRecord
+{
+    bool                   completed = false;
+    string                 outcome;
+    list<string>::iterator age;
+};
+
+static unordered_map<string, KeyRecord> idempotencyKeys;
+static list<string>                     completionOrder;   // Oldest completion first
+static mutex                            idempotencyMutex;
+static once_flag                        idempotencyLoadOnce;
+static size_t                           logLines = 0;
+static uint64_t                         duplicateCount = 0;
+static uint64_t                         evictionCount = 0;
+
+/**
+ * Records a completion in memory, evicting the oldest completions past the capacity.
+ * Caller holds idempotencyMutex.
+ */
+static void recordCompletion(const string& key, const string& outcome)
+{
+    KeyRecord& record = idempotencyKeys[key];
+    if (record.completed)
+        completionOrder.erase(record.age);
+
+    record.completed = true;
+    record.outcome   = outcome;
+    record.age       = completionOrder.insert(completionOrder.end(), key);
+
+    while (completionOrder.size() > IDEMPOTENCY_CAPACITY)
+    {
+        idempotencyKeys.erase(completionOrder.front());
+        completionOrder.pop_front();
+        ++evictionCount;
+    }
+}
+
+/**
+ * Rewrites the log with only the completions still in memory, oldest first.
+ * Caller holds idempotencyMutex.
+ */
+static void compactLog(void)
+{
+    string tmpPath = string(PATH_OF_IDEMPOTENCY_DATA_BASE) + ".tmp";
+    ofstream out(tmpPath, ios::trunc);
+    if (!out.is_open())
+        return;
+    for (auto const& key : completionOrder)
+        out << json{ {"key", key}, {"outcome", idempotencyKeys[key].outcome} }.dump() << '\n';
+    out.close();
+
+    if (out && rename(tmpPath.c_str(), PATH_OF_IDEMPOTENCY_DATA_BASE) == 0)
+        logLines = completionOrder.size();
+}
+
+/**
+ * Replays the log once per process; malformed lines are skipped.
+ */
+static void loadIndex(void)
+{
+    call_once(idempotencyLoadOnce, []() {
+        lock_guard<mutex> lock(idempotencyMutex);
+        ifstream log(PATH_OF_IDEMPOTENCY_DATA_BASE);
+        string line;
+        while (getline(log, line))
+        {
+            json record = json::parse(line, nullptr, false);
+            if (record.is_discarded() || !record.contains("key"))
+                continue;
+            recordCompletion(record.value("key", ""), record.value("outcome", ""));
+            ++logLines;
+        }
+
+        if (logLines > 2 * completionOrder.size() + 1024)
+            compactLog();
+    });
+}
+
+/**
+ * One hash probe under the lock; an unknown key is inserted as in progress.
+ */
+IdempotencyState IdempotencyIndex::begin(const string& key, string& outcome)
+{
+    loadIndex();
+    lock_guard<mutex> lock(idempotencyMutex);
+
+    auto it = idempotencyKeys.find(key);
+    if (it == idempotencyKeys.end())
+    {
+        idempotencyKeys.emplace(key, KeyRecord());
+        return IdempotencyState::New;
+    }
+
+    ++duplicateCount;
+    if (!it->second.completed)
+        return IdempotencyState::InProgress;
+
+    outcome = it->second.outcome;
+    return IdempotencyState::Completed;
+}
+
+/**
+ * Appends the completion to the log and compacts it once it is twice the capacity.
+ */
+void IdempotencyIndex::complete(const string& key, const string& outcome)
+{
+    loadIndex();
+    lock_guard<mutex> lock(idempotencyMutex);
+    recordCompletion(key, outcome);
+
+    ofstream log(PATH_OF_IDEMPOTENCY_DATA_BASE, ios::app);
+    if (!log.is_open())
+    {
+        cerr << "Error: Unable to record completion of " << key << ".\n";
+        return;
+    }
+    log << json{ {"key", key}, {"outcome", outcome}, {"at", static_cast<int64_t>(time(nullptr))} }.dump()
+        << '\n';
+    log.close();
+
+    if (++logLines > 2 * IDEMPOTENCY_CAPACITY)
+        compactLog();
+}
+
+/**
+ * Forgets an in-progress key; completed keys are never abandoned.
+ */
+void IdempotencyIndex::abandon(const string& key)
+{
+    lock_guard<mutex> lock(idempotencyMutex);
+    auto it = idempotencyKeys.find(key);
+    if (it != idempotencyKeys.end() && !it->second.completed)
+        idempotencyKeys.erase(it);
+}
+
+/**
+ * Snapshot of the counters.
+ */
+IdempotencyStats IdempotencyIndex::stats(void)
+{
+    loadIndex();
+    lock_guard<mutex> lock(idempotencyMutex);
+    IdempotencyStats s;
+    s.entries    = idempotencyKeys.size();
+    s.duplicates = duplicateCount;
+    s.evictions  = evictionCount;
+    return s;
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
@@ -0,0 +1,109 @@
+/******************************************************************************************
+ * MODULE NAME    : Load Arena Module
+ * FILE           : LoadArena.cpp
+ * DESCRIPTION    : Implements the load-scoped arena, its chunk source and the per-thread
+ *                  current arena.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/LoadArena.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <system_error>
+
+using namespace std;
+
+static thread_local pmr::memory_resource* currentArena = nullptr;
+
+/**
+ * Source of the arena's chunks. new_delete_resource() asks for every chunk through the
+ * aligned operator new, which the counting allocator leaves alone; plain operator new
+ * already aligns for any fundamental type, so chunks stay visible to memory accounting.
+ */
+class ChunkResource : public pmr::memory_resource
+{
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            return ::operator new(bytes, align_val_t(alignment));
+        return ::operator new(bytes);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ::operator delete(p, bytes, align_val_t(alignment));
+        else
+            ::operator delete(p, bytes);
+    }
+
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+static ChunkResource chunkResource;
+
+LoadArena::LoadArena(size_t initialBytes)
+    : arena(max<size_t>(LOAD_ARENA_MIN_BYTES, initialBytes), &chunkResource)
+{
+}
+
+/**
+ * Sized from the file so the whole load usually fits in the first chunk.
+ */
+shared_ptr<LoadArena> LoadArena::forFile(const string& path)
+{
+    error_code error;
+    uintmax_t  bytes = filesystem::file_size(path, error);
+    if (error)
+        bytes = 0;
+    return make_shared<LoadArena>(static_cast<size_t>(bytes) * LOAD_ARENA_BYTES_PER_FILE_BYTE);
+}
+
+/**
+ * One read straight into arena memory; the view stays valid as long as the arena.
+ */
+bool LoadArena::readFile(const string& path, string_view& contents)
+{
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file.is_open())
+        return false;
+
+    streamsize size = file.tellg();
+    file.seekg(0);
+    char* buffer = static_cast<char*>(arena.allocate(static_cast<size_t>(size), 1));
+    if (!file.read(buffer, size))
+        return false;
+
+    contents = string_view(buffer, static_cast<size_t>(size));
+    return true;
+}
+
+pmr::memory_resource* LoadArena::current(void)
+{
+    return currentArena ? currentArena : pmr::new_delete_resource();
+}
+
+/**
+ * Scopes nest: the previous arena becomes current again when the scope ends.
+ */
+LoadArenaScope::LoadArenaScope(LoadArena& arena)
+    : previous(currentArena)
+{
+    currentArena = arena.resource();
+}
+
+LoadArenaScope::~LoadArenaScope(void)
+{
+    currentArena = previous;
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
@@ -20,15 +20,15 @@ using json = nlohmann::json;
 /**
  * Constructor: Initializes a Maintenance record with aircraft ID and details.
  */
-Maintenance::Maintenance(const string& id, const string& details)
-    : aircraftID(id),
-      maintenanceDetails(details)
+Maintenance::Maintenance(string id, string details)
+    : aircraftID(move(id)),
+      maintenanceDetails(move(details))
 {}
 
 /**
  * Getter: Returns the associated aircraft ID.
  */
-string Maintenance::getAircraftID(void) const
+const string& Maintenance::getAircraftID(void) const
 {
     return aircraftID;
 }
@@ -36,7 +36,7 @@ string Maintenance::getAircraftID(void) const
 /**
  * Getter: Returns the maintenance details.
  */
-string Maintenance::getMaintenanceDetails(void) const
+const string& Maintenance::getMaintenanceDetails(void) const
 {
     return maintenanceDetails;
 }
@@ -96,15 +96,12 @@ void Maintenance::loadMaintenanceData(const string& filename,
 
     for (auto& item : maintenanceJson.items())
     {
-        string id             = item.key();
-        auto   dataArray      = item.value();
+        const string& id = item.key();
         vector<Maintenance> list;
+        list.reserve(item.value().size());
 
-        for (auto const& entry : dataArray)
-        {
-            string details = entry["maintenanceDetails"].get<string>();
-            list.emplace_back(id, details);
-        }
+        for (auto const& entry : item.value())
+            list.emplace_back(id, entry.at("maintenanceDetails").get<string>());
 
         maintenanceRecords[id] = move(list);
     }
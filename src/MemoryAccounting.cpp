@@ -0,0 +1,567 @@
+/******************************************************************************************
+ * MODULE NAME    : Memory Accounting Module
+ * FILE           : MemoryAccounting.cpp
+ * DESCRIPTION    : Implements the counting global allocator, subsystem tags and the
+ *                  per-data-set load profile.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/MemoryAccounting.hpp"
+#include "../header/Aircraft.hpp"
+#include "../header/Crew.hpp"
+#include "../header/Flight.hpp"
+#include "../header/FlightRegistry.hpp"
+#include "../header/FlightTable.hpp"
+#include "../header/Reservation.hpp"
+#include "../header/ReservationPool.hpp"
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <new>
+#include <vector>
+
+using namespace std;
+using json = nlohmann::json;
+
+#define SUBSYSTEM_COUNT static_cast<size_t>(MemorySubsystem::Count)
+
+/* Bookings held at once in each round of the pooled-booking profile */
+#define POOL_PROFILE_BOOKINGS 256
+
+/* Passes over the loaded records in each scan of the scan profile */
+#define SCAN_PROFILE_ROUNDS 64
+
+/* Records in the synthetic aircraft file of the move-versus-copy profile, and runs of
+   each loader over it; the fastest run is reported */
+#define MOVE_PROFILE_RECORDS 20000
+#define MOVE_PROFILE_RUNS    3
+
+/* Counters of every subsystem at one instant; an array so taking one never allocates */
+using UsageSet = array<MemoryUsage, SUBSYSTEM_COUNT>;
+
+/**
+ * Lock-free counters of one subsystem.
+ */
+struct SubsystemCounters
+{
+    atomic<uint64_t> allocations{0};
+    atomic<uint64_t> frees{0};
+    atomic<uint64_t> bytesAllocated{0};
+    atomic<int64_t>  liveBytes{0};
+    atomic<int64_t>  peakBytes{0};
+};
+
+static SubsystemCounters             subsystemCounters[SUBSYSTEM_COUNT];
+static thread_local MemorySubsystem  currentSubsystem = MemorySubsystem::Other;
+
+static const char* const subsystemNames[SUBSYSTEM_COUNT] = {
+    "other", "flights", "reservations", "crew", "aircraft", "json"
+};
+
+#if AIRLINE_MEMORY_ACCOUNTING
+
+/**
+ * Prefix of every counted block; 16 bytes keeps the payload aligned like malloc's.
+ */
+struct alignas(16) AllocationHeader
+{
+    uint64_t size;
+    uint8_t  subsystem;
+};
+static_assert(sizeof(AllocationHeader) == 16, "allocation header must keep 16-byte alignment");
+
+/**
+ * Charges an allocation to the calling thread's subsystem.
+ */
+static void* countedAllocate(size_t size) noexcept
+{
+    auto* header = static_cast<AllocationHeader*>(malloc(sizeof(AllocationHeader) + size));
+    if (!header)
+        return nullptr;
+
+    header->size      = size;
+    header->subsystem = static_cast<uint8_t>(currentSubsystem);
+
+    SubsystemCounters& counters = subsystemCounters[header->subsystem];
+    counters.allocations.fetch_add(1, memory_order_relaxed);
+    counters.bytesAllocated.fetch_add(size, memory_order_relaxed);
+    int64_t live = counters.liveBytes.fetch_add(static_cast<int64_t>(size), memory_order_relaxed) +
+                   static_cast<int64_t>(size);
+    int64_t peak = counters.peakBytes.load(memory_order_relaxed);
+    while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed)) {}
+
+    return header + 1;
+}
+
+/**
+ * Credits a free to the subsystem recorded in the block's header.
+ */
+static void countedFree(void* pointer) noexcept
+{
+    if (!pointer)
+        return;
+
+    auto* header = static_cast<AllocationHeader*>(pointer) - 1;
+    SubsystemCounters& counters = subsystemCounters[header->subsystem];
+    counters.frees.fetch_add(1, memory_order_relaxed);
+    counters.liveBytes.fetch_sub(static_cast<int64_t>(header->size), memory_order_relaxed);
+    free(header);
+}
+
+/*
+ * Replacements of the global allocation functions. The over-aligned forms are left to
+ * the standard library; they have their own matching deallocation functions.
+ */
+void* operator new(size_t size)
+{
+    void* pointer = countedAllocate(size);
+    if (!pointer)
+        throw bad_alloc();
+    return pointer;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept
+{
+    return countedAllocate(size);
+}
+
+void* operator new[](size_t size, const nothrow_t&) noexcept
+{
+    return countedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept                          { countedFree(pointer); }
+void operator delete[](void* pointer) noexcept                        { countedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept                  { countedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept                { countedFree(pointer); }
+void operator delete(void* pointer, const nothrow_t&) noexcept        { countedFree(pointer); }
+void operator delete[](void* pointer, const nothrow_t&) noexcept      { countedFree(pointer); }
+
+#endif
+
+/**
+ * Tags nest: the previous subsystem is restored when the tag goes out of scope.
+ */
+MemoryTag::MemoryTag(MemorySubsystem subsystem)
+    : previous(currentSubsystem)
+{
+    currentSubsystem = subsystem;
+}
+
+MemoryTag::~MemoryTag(void)
+{
+    currentSubsystem = previous;
+}
+
+/**
+ * Snapshot of one subsystem's counters.
+ */
+MemoryUsage MemoryAccounting::usage(MemorySubsystem subsystem)
+{
+    const SubsystemCounters& counters = subsystemCounters[static_cast<size_t>(subsystem)];
+    MemoryUsage u;
+    u.allocations    = counters.allocations.load(memory_order_relaxed);
+    u.frees          = counters.frees.load(memory_order_relaxed);
+    u.bytesAllocated = counters.bytesAllocated.load(memory_order_relaxed);
+    u.liveBytes      = counters.liveBytes.load(memory_order_relaxed);
+    u.peakBytes      = counters.peakBytes.load(memory_order_relaxed);
+    return u;
+}
+
+const char* MemoryAccounting::name(MemorySubsystem subsystem)
+{
+    return subsystemNames[static_cast<size_t>(subsystem)];
+}
+
+/**
+ * One object per subsystem, keyed by name.
+ */
+json MemoryAccounting::snapshot(void)
+{
+    json j = { {"enabled", enabled()} };
+    for (size_t s = 0; s < SUBSYSTEM_COUNT; ++s)
+    {
+        MemoryUsage u = usage(static_cast<MemorySubsystem>(s));
+        j["subsystems"][subsystemNames[s]] = {
+            {"allocations", u.allocations}, {"frees", u.frees},
+            {"bytesAllocated", u.bytesAllocated}, {"liveBytes", u.liveBytes},
+            {"peakBytes", u.peakBytes}
+        };
+    }
+    return j;
+}
+
+/**
+ * Reads every subsystem's counters.
+ */
+static UsageSet usageOfAll(void)
+{
+    UsageSet all;
+    for (size_t s = 0; s < SUBSYSTEM_COUNT; ++s)
+        all[s] = MemoryAccounting::usage(static_cast<MemorySubsystem>(s));
+    return all;
+}
+
+/**
+ * Difference between two snapshots taken around a load, while its result is still held:
+ * allocations and bytes requested while loading (JSON trees included) and the bytes
+ * still live, i.e. what the loaded records cost to keep.
+ */
+static json loadCost(const UsageSet& before, const UsageSet& after, size_t records)
+{
+    uint64_t allocations = 0, bytesAllocated = 0;
+    int64_t  retained = 0;
+    json bySubsystem = json::object();
+    for (size_t s = 0; s < SUBSYSTEM_COUNT; ++s)
+    {
+        uint64_t a = after[s].allocations - before[s].allocations;
+        uint64_t b = after[s].bytesAllocated - before[s].bytesAllocated;
+        int64_t  r = after[s].liveBytes - before[s].liveBytes;
+        allocations    += a;
+        bytesAllocated += b;
+        retained       += r;
+        if (a > 0)
+            bySubsystem[subsystemNames[s]] = { {"allocations", a}, {"bytesAllocated", b}, {"retainedBytes", r} };
+    }
+
+    double perRecord = records ? 1.0 / records : 0.0;
+    return {
+        {"records",                records},
+        {"allocations",            allocations},
+        {"allocationsPerRecord",   allocations * perRecord},
+        {"bytesAllocated",         bytesAllocated},
+        {"retainedBytes",          retained},
+        {"retainedBytesPerRecord", retained * perRecord},
+        {"bySubsystem",            bySubsystem}
+    };
+}
+
+/**
+ * Measures one data set. The load runs between the two snapshots and keeps its result
+ * alive until the second; a data set that fails to parse is reported, not fatal.
+ */
+template <typename Load>
+static json measureLoad(Load load)
+{
+    try
+    {
+        UsageSet before  = usageOfAll();
+        size_t   records = 0;
+        UsageSet after;
+        load(records, after);
+        return loadCost(before, after, records);
+    }
+    catch (const exception& e)
+    {
+        return { {"error", e.what()} };
+    }
+}
+
+/**
+ * Steady-state cost of the objects one booking creates. Each round builds a batch of
+ * pooled reservations on copies of a real flight and releases them; the first round
+ * warms the pool and grows the recycled buffers, the second is measured.
+ */
+static json measurePooledBooking(void)
+{
+    auto   flights = Flight::loadFlights(PATH_OF_FLIGHTS_DATA_BASE);
+    Flight source  = flights.empty() ? Flight() : flights.front();
+
+    // Caller-side strings, built once like the booking path's own
+    const string resID = "A100", name = "passenger", seat = "12C", method = "Card",
+                 details = "**** **** **** 4242", fareClass = "Y";
+
+    vector<shared_ptr<Reservation>> batch;
+    batch.reserve(POOL_PROFILE_BOOKINGS);
+    auto round = [&]() {
+        for (size_t i = 0; i < POOL_PROFILE_BOOKINGS; ++i)
+        {
+            auto res = ReservationPool::makeReservation(resID, name, ReservationPool::makeFlight(source),
+                                                        seat, method, details);
+            res->setFareClass(fareClass);
+            batch.push_back(move(res));
+        }
+        batch.clear();
+    };
+
+    round();
+    UsageSet before = usageOfAll();
+    round();
+    json cost = loadCost(before, usageOfAll(), POOL_PROFILE_BOOKINGS);
+
+    ReservationPoolStats stats = ReservationPool::stats();
+    cost["poolHits"]   = stats.hits;
+    cost["poolMisses"] = stats.misses;
+    return cost;
+}
+
+/**
+ * Allocations of one scan: body() walks `records` records and runs SCAN_PROFILE_ROUNDS
+ * times; anything it allocates per comparison shows as one or more per record.
+ */
+template <typename Scan>
+static json measureScan(size_t records, Scan body)
+{
+    UsageSet before = usageOfAll();
+    for (size_t r = 0; r < SCAN_PROFILE_ROUNDS; ++r)
+        body();
+    UsageSet after = usageOfAll();
+
+    uint64_t allocations = 0;
+    for (size_t s = 0; s < SUBSYSTEM_COUNT; ++s)
+        allocations += after[s].allocations - before[s].allocations;
+
+    size_t scanned = records * SCAN_PROFILE_ROUNDS;
+    return {
+        {"recordsScanned",       scanned},
+        {"allocations",          allocations},
+        {"allocationsPerRecord", scanned ? double(allocations) / scanned : 0.0}
+    };
+}
+
+/**
+ * The record loops of the menus, over data already loaded: the route match of a flight
+ * search, the flight-number match of a booking, the route filter of the flight table
+ * behind the search cache, and the passenger match of "My Reservations". The queries
+ * are the last record's own values, so every scan compares all the way through, and
+ * result buffers are sized up front like a warm caller's.
+ */
+static json measureScans(void)
+{
+    auto flights      = Flight::loadFlights(PATH_OF_FLIGHTS_DATA_BASE);
+    auto reservations = Reservation::loadReservations();
+    auto table        = FlightRegistry::table();
+    if (flights.empty())
+        return { {"note", "no flights to scan"} };
+
+    const string origin      = flights.back().getOrigin();
+    const string destination = flights.back().getDestination();
+    const string number      = flights.back().getFlightNumber();
+    const string passenger   = reservations.empty() ? string() : reservations.back()->getPassengerName();
+    auto originID      = SymbolTable::find(origin);
+    auto destinationID = SymbolTable::find(destination);
+
+    vector<const Flight*>      found;
+    vector<uint32_t>           rows;
+    vector<const Reservation*> mine;
+    found.reserve(flights.size());
+    rows.reserve(table->size());
+    mine.reserve(reservations.size());
+
+    json report;
+    report["flightSearch"] = measureScan(flights.size(), [&]() {
+        found.clear();
+        for (auto const& flight : flights)
+            if (flight.servesRoute(origin, destination))
+                found.push_back(&flight);
+    });
+    report["flightByNumber"] = measureScan(flights.size(), [&]() {
+        found.clear();
+        for (auto const& flight : flights)
+            if (flight.getFlightNumber() == number)
+            {
+                found.push_back(&flight);
+                break;
+            }
+    });
+    report["flightTableFilter"] = measureScan(table->size(), [&]() {
+        rows.clear();
+        table->filterByRouteAndDate(originID, destinationID, INT32_MIN, INT32_MAX, rows);
+    });
+    report["reservationsByPassenger"] = measureScan(reservations.size(), [&]() {
+        mine.clear();
+        for (auto const& res : reservations)
+            if (res->getPassengerName() == passenger)
+                mine.push_back(res.get());
+    });
+    return report;
+}
+
+/**
+ * The aircraft loader as it was before it moved what it parsed: every record's JSON
+ * subtree is copied, strings are passed as named copies, and the finished record is
+ * copied into the map. Kept only as the baseline of measureMoveVsCopy.
+ */
+static void loadAircraftCopying(const string& filename, map<string, Aircraft>& aircraftRecords)
+{
+    MEMORY_TAG(Aircraft);
+    ifstream file(filename);
+    json     aircraftJson;
+    {
+        MEMORY_TAG(Json);
+        file >> aircraftJson;
+    }
+
+    for (auto& item : aircraftJson.items())
+    {
+        string id   = item.key();
+        auto   data = item.value();
+        shared_ptr<Maintenance> maintPtr;
+
+        if (data.contains("maintenance") && !data["maintenance"].is_null())
+        {
+            auto m = data["maintenance"];
+            if (m.contains("maintenanceDetails") && !m["maintenanceDetails"].is_null())
+            {
+                string aircraftID = m["aircraftID"].get<string>();
+                string details    = m["maintenanceDetails"].get<string>();
+                maintPtr = make_shared<Maintenance>(aircraftID, details);
+            }
+        }
+
+        string   type = data["aircraftType"].get<string>();
+        Aircraft aircraft(id, type, data["capacity"].get<int>(), maintPtr);
+        if (data.contains("cabinLayout"))
+        {
+            CabinLayout layout;
+            if (CabinLayout::fromJson(data["cabinLayout"], layout))
+                aircraft.setCabinLayout(layout);
+        }
+        aircraftRecords[id] = aircraft;
+    }
+}
+
+/**
+ * Runs one aircraft loader MOVE_PROFILE_RUNS times over a file: the cost of the last
+ * run, taken while its records are held, and the fastest run's time.
+ */
+template <typename Load>
+static json measureAircraftLoader(const string& filename, Load load)
+{
+    json    cost;
+    int64_t bestMicroseconds = INT64_MAX;
+    for (size_t run = 0; run < MOVE_PROFILE_RUNS; ++run)
+    {
+        map<string, Aircraft> records;
+        UsageSet before  = usageOfAll();
+        auto     started = chrono::steady_clock::now();
+        load(filename, records);
+        auto     elapsed = chrono::steady_clock::now() - started;
+        cost = loadCost(before, usageOfAll(), records.size());
+        bestMicroseconds = min<int64_t>(bestMicroseconds,
+                                        chrono::duration_cast<chrono::microseconds>(elapsed).count());
+    }
+    cost["bestMs"] = bestMicroseconds / 1000.0;
+    return cost;
+}
+
+/**
+ * Loads one large aircraft file with the current loader, which moves strings and binds
+ * JSON subtrees by reference, and with the copying baseline. The file repeats the
+ * shipped aircraft under numbered IDs to MOVE_PROFILE_RECORDS records and lives in the
+ * system temp directory for the run only. Times include the counting allocator's
+ * bookkeeping, which both loaders pay alike.
+ */
+static json measureMoveVsCopy(void)
+{
+    json shipped;
+    {
+        ifstream file(PATH_OF_AIR_CRAFT_DATA_BASE);
+        if (file.is_open())
+            shipped = json::parse(file, nullptr, false);
+    }
+    if (!shipped.is_object() || shipped.empty())
+        return { {"note", "no aircraft to build the data set from"} };
+
+    json synthetic = json::object();
+    for (size_t i = 0; synthetic.size() < MOVE_PROFILE_RECORDS; ++i)
+        for (auto const& item : shipped.items())
+        {
+            if (synthetic.size() == MOVE_PROFILE_RECORDS)
+                break;
+            string id     = item.key() + "-" + to_string(i);
+            json   record = item.value();
+            record["aircraftID"] = id;
+            if (record.contains("maintenance") && record["maintenance"].is_object())
+                record["maintenance"]["aircraftID"] = id;
+            synthetic[id] = move(record);
+        }
+
+    error_code       ec;
+    filesystem::path path = filesystem::temp_directory_path(ec) /
+        ("airline-move-profile-" + to_string(chrono::steady_clock::now().time_since_epoch().count()) + ".json");
+    {
+        ofstream out(path);
+        out << synthetic;
+        if (ec || !out)
+            return { {"error", "cannot write the synthetic aircraft file"} };
+    }
+    synthetic = json();
+
+    json report = { {"records", MOVE_PROFILE_RECORDS} };
+    report["copy"] = measureAircraftLoader(path.string(), loadAircraftCopying);
+    report["move"] = measureAircraftLoader(path.string(), Aircraft::loadAircraftData);
+    filesystem::remove(path, ec);
+
+    double copied = report["copy"]["allocations"].get<double>();
+    double timed  = report["copy"]["bestMs"].get<double>();
+    report["allocationReductionPercent"] =
+        copied > 0 ? 100.0 * (copied - report["move"]["allocations"].get<double>()) / copied : 0.0;
+    report["timeReductionPercent"] =
+        timed > 0 ? 100.0 * (timed - report["move"]["bestMs"].get<double>()) / timed : 0.0;
+    return report;
+}
+
+/**
+ * Crew members go to the crew module's own list, so that load is measured as it grows.
+ */
+json MemoryAccounting::profileLoads(void)
+{
+    json report = { {"enabled", enabled()} };
+    if (!enabled())
+    {
+        report["note"] = "rebuild with make MEMORY_ACCOUNTING=1 to count allocations";
+        return report;
+    }
+
+    report["flights"] = measureLoad([](size_t& records, UsageSet& after) {
+        auto flights = Flight::loadFlights(PATH_OF_FLIGHTS_DATA_BASE);
+        after   = usageOfAll();
+        records = flights.size();
+    });
+    report["reservations"] = measureLoad([](size_t& records, UsageSet& after) {
+        auto reservations = Reservation::loadReservations();
+        after   = usageOfAll();
+        records = reservations.size();
+    });
+    report["bookingAgentReservations"] = measureLoad([](size_t& records, UsageSet& after) {
+        auto reservations = Reservation::loadBookingAgentReservations();
+        after   = usageOfAll();
+        records = reservations.size();
+    });
+    report["crew"] = measureLoad([](size_t& records, UsageSet& after) {
+        size_t loaded = Crew::crewCount();
+        Crew::loadCrewFromFile(PATH_OF_CREW_DATA_BASE);
+        after   = usageOfAll();
+        records = Crew::crewCount() - loaded;
+    });
+    report["aircraft"] = measureLoad([](size_t& records, UsageSet& after) {
+        map<string, Aircraft> aircraft;
+        Aircraft::loadAircraftData(PATH_OF_AIR_CRAFT_DATA_BASE, aircraft);
+        after   = usageOfAll();
+        records = aircraft.size();
+    });
+
+    report["pooledBooking"] = measurePooledBooking();
+    report["scans"]         = measureScans();
+    report["moveVsCopy"]    = measureMoveVsCopy();
+
+    report["process"] = snapshot()["subsystems"];
+    return report;
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
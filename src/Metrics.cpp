@@ -0,0 +1,318 @@
+/******************************************************************************************
+ * MODULE NAME    : Metrics Module
+ * FILE           : Metrics.cpp
+ * DESCRIPTION    : Implements the scoped timers, latency histograms and I/O counters.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/Metrics.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+using namespace std;
+using json = nlohmann::json;
+
+/* Values below this are counted exactly; above it, 16 sub-buckets per power of two */
+#define HISTOGRAM_LINEAR_LIMIT 32
+#define HISTOGRAM_SUB_BUCKETS  16
+
+/* Largest power of two tracked (2^44 ns is almost five hours); longer samples are clamped */
+#define HISTOGRAM_MAX_MAGNITUDE 44
+
+#define HISTOGRAM_BUCKETS \
+    (HISTOGRAM_LINEAR_LIMIT + (HISTOGRAM_MAX_MAGNITUDE - 4) * HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * Samples and counters of one operation; every field is updated without a lock.
+ */
+struct OperationMetrics
+{
+    atomic<uint64_t> buckets[HISTOGRAM_BUCKETS];
+    atomic<uint64_t> count{0};
+    atomic<uint64_t> sum{0};
+    atomic<uint64_t> min{UINT64_MAX};
+    atomic<uint64_t> max{0};
+    atomic<uint64_t> bytesRead{0};
+    atomic<uint64_t> bytesWritten{0};
+    atomic<uint64_t> records{0};
+};
+
+atomic<bool> Metrics::recording{false};
+
+static OperationMetrics       operations[MAX_METRIC_OPERATIONS];
+static string                 operationNames[MAX_METRIC_OPERATIONS];
+static atomic<uint32_t>       operationCount{0};
+static mutex                  registryMutex;
+static OperationMetrics       unattributed;   // Counters charged outside any timer
+static thread_local ScopedTimer* innermostTimer = nullptr;
+
+/**
+ * Dumps to the configured path when the process exits.
+ */
+struct MetricsDumper
+{
+    string path;
+    ~MetricsDumper() { if (!path.empty()) Metrics::dump(path); }
+};
+static MetricsDumper metricsDumper;
+
+/**
+ * Maps a value to its bucket: exact below the linear limit, then the top four bits
+ * after the leading one select the sub-bucket of its power of two.
+ */
+static size_t bucketOf(uint64_t value)
+{
+    if (value < HISTOGRAM_LINEAR_LIMIT)
+        return static_cast<size_t>(value);
+
+    int magnitude = 63 - __builtin_clzll(value);
+    if (magnitude >= HISTOGRAM_MAX_MAGNITUDE)
+        return HISTOGRAM_BUCKETS - 1;
+
+    size_t sub = static_cast<size_t>(value >> (magnitude - 4)) & (HISTOGRAM_SUB_BUCKETS - 1);
+    return HISTOGRAM_LINEAR_LIMIT + (magnitude - 5) * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+/**
+ * Highest value a bucket holds, so reported percentiles never understate latency.
+ */
+static uint64_t bucketUpperBound(size_t bucket)
+{
+    if (bucket < HISTOGRAM_LINEAR_LIMIT)
+        return bucket;
+
+    size_t   offset    = bucket - HISTOGRAM_LINEAR_LIMIT;
+    int      magnitude = static_cast<int>(offset / HISTOGRAM_SUB_BUCKETS) + 5;
+    uint64_t sub       = offset % HISTOGRAM_SUB_BUCKETS;
+    return ((HISTOGRAM_SUB_BUCKETS + sub + 1) << (magnitude - 4)) - 1;
+}
+
+/**
+ * Lowers or raises an atomic bound with a compare-and-swap loop.
+ */
+static void updateMin(atomic<uint64_t>& bound, uint64_t value)
+{
+    uint64_t seen = bound.load(memory_order_relaxed);
+    while (value < seen && !bound.compare_exchange_weak(seen, value, memory_order_relaxed)) {}
+}
+
+static void updateMax(atomic<uint64_t>& bound, uint64_t value)
+{
+    uint64_t seen = bound.load(memory_order_relaxed);
+    while (value > seen && !bound.compare_exchange_weak(seen, value, memory_order_relaxed)) {}
+}
+
+/**
+ * The operation the calling thread's counters go to.
+ */
+static OperationMetrics& chargedOperation(void)
+{
+    return innermostTimer ? operations[innermostTimer->id] : unattributed;
+}
+
+/**
+ * Flips the run-time switch.
+ */
+void Metrics::setEnabled(bool on)
+{
+    recording.store(on, memory_order_relaxed);
+}
+
+/**
+ * Linear search under the lock; it runs once per call site thanks to METRIC_SCOPE's
+ * static handle.
+ */
+MetricId Metrics::operation(const char* name)
+{
+    lock_guard<mutex> lock(registryMutex);
+    uint32_t count = operationCount.load(memory_order_relaxed);
+    for (uint32_t i = 0; i < count; ++i)
+        if (operationNames[i] == name)
+            return i;
+
+    if (count == MAX_METRIC_OPERATIONS)
+        return MAX_METRIC_OPERATIONS - 1;
+
+    operationNames[count] = name;
+    operationCount.store(count + 1, memory_order_release);
+    return count;
+}
+
+/**
+ * One bucket increment plus the running count, sum and bounds.
+ */
+void Metrics::record(MetricId id, uint64_t nanoseconds)
+{
+    OperationMetrics& op = operations[id];
+    op.buckets[bucketOf(nanoseconds)].fetch_add(1, memory_order_relaxed);
+    op.count.fetch_add(1, memory_order_relaxed);
+    op.sum.fetch_add(nanoseconds, memory_order_relaxed);
+    updateMin(op.min, nanoseconds);
+    updateMax(op.max, nanoseconds);
+}
+
+void Metrics::addBytesRead(uint64_t bytes)
+{
+    chargedOperation().bytesRead.fetch_add(bytes, memory_order_relaxed);
+}
+
+void Metrics::addBytesWritten(uint64_t bytes)
+{
+    chargedOperation().bytesWritten.fetch_add(bytes, memory_order_relaxed);
+}
+
+void Metrics::addRecordsParsed(uint64_t records)
+{
+    chargedOperation().records.fetch_add(records, memory_order_relaxed);
+}
+
+/**
+ * Walks the buckets once, picking off each percentile as the running total passes it.
+ */
+static json operationJson(const OperationMetrics& op)
+{
+    json j;
+    uint64_t count = op.count.load(memory_order_relaxed);
+    j["count"] = count;
+    if (count > 0)
+    {
+        j["meanUs"] = op.sum.load(memory_order_relaxed) / 1000.0 / count;
+        j["minUs"]  = op.min.load(memory_order_relaxed) / 1000.0;
+        j["maxUs"]  = op.max.load(memory_order_relaxed) / 1000.0;
+
+        static const pair<const char*, double> percentiles[] = {
+            {"p50Us", 0.50}, {"p90Us", 0.90}, {"p99Us", 0.99}, {"p999Us", 0.999}
+        };
+        size_t   next = 0;
+        uint64_t seen = 0;
+        for (size_t b = 0; b < HISTOGRAM_BUCKETS && next < 4; ++b)
+        {
+            seen += op.buckets[b].load(memory_order_relaxed);
+            while (next < 4 && seen >= percentiles[next].second * count)
+            {
+                uint64_t bound = min(bucketUpperBound(b), op.max.load(memory_order_relaxed));
+                j[percentiles[next++].first] = bound / 1000.0;
+            }
+        }
+    }
+    j["bytesRead"]     = op.bytesRead.load(memory_order_relaxed);
+    j["bytesWritten"]  = op.bytesWritten.load(memory_order_relaxed);
+    j["recordsParsed"] = op.records.load(memory_order_relaxed);
+    return j;
+}
+
+/**
+ * Operations without any sample or count are left out.
+ */
+json Metrics::snapshot(void)
+{
+    json ops = json::object();
+    uint64_t bytesRead = 0, bytesWritten = 0, records = 0;
+
+    uint32_t count = operationCount.load(memory_order_acquire);
+    for (uint32_t i = 0; i <= count && i < MAX_METRIC_OPERATIONS; ++i)
+    {
+        const OperationMetrics& op = i < count ? operations[i] : unattributed;
+        bytesRead    += op.bytesRead.load(memory_order_relaxed);
+        bytesWritten += op.bytesWritten.load(memory_order_relaxed);
+        records      += op.records.load(memory_order_relaxed);
+
+        json j = operationJson(op);
+        if (j["count"] != 0 || j["bytesRead"] != 0 || j["bytesWritten"] != 0 || j["recordsParsed"] != 0)
+            ops[i < count ? operationNames[i] : "(unattributed)"] = j;
+    }
+
+    return {
+        {"enabled",    enabled()},
+        {"operations", ops},
+        {"totals",     { {"bytesRead", bytesRead}, {"bytesWritten", bytesWritten},
+                         {"recordsParsed", records} }}
+    };
+}
+
+/**
+ * Pretty-printed so the dump can be read without tooling.
+ */
+bool Metrics::dump(const string& path)
+{
+    json j = snapshot();
+    if (path == "-")
+    {
+        cerr << setw(4) << j << endl;
+        return true;
+    }
+
+    ofstream out(path);
+    if (!out.is_open())
+    {
+        cerr << "Error: Unable to write metrics to " << path << ".\n";
+        return false;
+    }
+    out << setw(4) << j << endl;
+    return static_cast<bool>(out);
+}
+
+/**
+ * Reads the environment once at startup.
+ */
+void Metrics::configureFromEnvironment(void)
+{
+    const char* path = getenv(METRICS_ENVIRONMENT_VARIABLE);
+    if (!path || !*path)
+        return;
+
+    metricsDumper.path = path;
+    setEnabled(true);
+}
+
+/**
+ * Zeroes every slot; callers make sure no timer is recording meanwhile.
+ */
+void Metrics::reset(void)
+{
+    auto clear = [](OperationMetrics& op) {
+        for (auto& bucket : op.buckets)
+            bucket.store(0, memory_order_relaxed);
+        op.count.store(0, memory_order_relaxed);
+        op.sum.store(0, memory_order_relaxed);
+        op.min.store(UINT64_MAX, memory_order_relaxed);
+        op.max.store(0, memory_order_relaxed);
+        op.bytesRead.store(0, memory_order_relaxed);
+        op.bytesWritten.store(0, memory_order_relaxed);
+        op.records.store(0, memory_order_relaxed);
+    };
+    for (auto& op : operations)
+        clear(op);
+    clear(unattributed);
+}
+
+/**
+ * Only called while recording is on; a disabled timer never leaves the header.
+ */
+void ScopedTimer::start(void)
+{
+    parent         = innermostTimer;
+    innermostTimer = this;
+    started        = chrono::steady_clock::now();
+}
+
+void ScopedTimer::stop(void)
+{
+    auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - started);
+    Metrics::record(id, static_cast<uint64_t>(elapsed.count()));
+    innermostTimer = parent;
+}
+
+ScopedTimer* ScopedTimer::current(void)
+{
+    return innermostTimer;
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
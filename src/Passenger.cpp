@@ -8,7 +8,13 @@
  ******************************************************************************************/
 
 #include "../header/Passenger.hpp"
+#include "../header/SeatInventory.hpp"
+#include "../header/SeatHold.hpp"
+#include "../header/SeatMap.hpp"
+#include "../header/IdempotencyIndex.hpp"
 #include "../header/Payment.hpp"
+#include "../header/ReservationPool.hpp"
+#include "../header/Tracer.hpp"
 #include "../header/json.hpp"
 #include <iostream>
 #include <fstream>
@@ -24,11 +30,19 @@ using json = nlohmann::json;
  * Constructor: Initializes Passenger and loads existing reservations.
  */
 Passenger::Passenger(string username, string password)
-    : User(username, password, "Passenger")
+    : User(move(username), move(password), "Passenger")
 {
     reservations = Reservation::loadReservations();
 }
 
+/**
+ * Constructor: Initializes Passenger with reservations the caller already loaded.
+ */
+Passenger::Passenger(string username, string password, vector<shared_ptr<Reservation>> loaded)
+    : User(move(username), move(password), "Passenger"), reservations(move(loaded))
+{
+}
+
 /**
  * Displays the main menu and dispatches user choices.
  */
@@ -37,6 +51,9 @@ void Passenger::displayMenu(void)
     int choice;
     do
     {
+        // Outcomes of card charges settled since the last prompt
+        Payment::printNotices();
+
         cout << "\n--- Passenger Menu ---\n"
              << "1. Search Flights\n"
              << "2. View My Reservations\n"
@@ -75,18 +92,43 @@ void Passenger::searchFlights(void)
     cout << "Enter Destination: ";
     getline(cin, destination);
 
-    auto flights = Flight::loadFlights(PATH_OF_FLIGHTS_DATA_BASE);
-    vector<Flight> matches;
-
-    for (auto const& fl : flights)
-    {
-        if (fl.getOrigin() == origin && fl.getDestination() == destination)
-            matches.push_back(fl);
-    }
+    // Direct flights come from the search cache; sold-out ones are hidden and the rest
+    // listed with the most seats left first. The snapshot serves connections.
+    vector<Flight> matches = *FlightRegistry::findDirectFlights(origin, destination);
+    SeatInventory::rankByAvailability(matches);
+    auto table          = FlightRegistry::table();
+    auto originID       = SymbolTable::find(origin);
+    auto destinationID  = SymbolTable::find(destination);
 
     if (matches.empty())
     {
-        cout << "No flights found for the given criteria.\n";
+        // No direct flight: fall back to itineraries with up to MAX_CONNECTIONS stops that
+        // have not left yet, over legs with a seat to sell
+        auto itineraries = FlightRegistry::routes().findItineraries(
+            originID, destinationID, FlightTable::currentMinute(),
+            [](const string& number) { return SeatInventory::isBookable(number); });
+        if (itineraries.empty())
+        {
+            cout << "No flights found for the given criteria.\n";
+            return;
+        }
+
+        cout << "\nNo direct flights. Connecting itineraries:\n";
+        for (size_t i = 0; i < itineraries.size(); ++i)
+        {
+            auto const& legs = itineraries[i].flightNumbers;
+            cout << i + 1 << ". " << legs.size() - 1 << " connection(s): ";
+            for (size_t l = 0; l < legs.size(); ++l)
+                cout << legs[l] << (l + 1 < legs.size() ? " -> " : "\n");
+
+            for (auto const& number : legs)
+            {
+                long row = table->findRow(number);
+                if (row >= 0)
+                    table->row(static_cast<size_t>(row)).displayFlightInfo();
+            }
+        }
+        bookFlight();
         return;
     }
 
@@ -101,16 +143,6 @@ void Passenger::searchFlights(void)
     bookFlight();
 }
 
-/**
- * Generates a random reservation ID: Letter + 3-digit number.
- */
-static string generateRandomReservationID(void)
-{
-    char letter = 'A' + rand() % 26;
-    int  num    = rand() % 900 + 100;
-    return string(1, letter) + to_string(num);
-}
-
 /**
  * Books a flight: select flight, seat, process payment, save reservation.
  */
@@ -121,12 +153,15 @@ void Passenger::bookFlight(void)
     cin >> flightNumber;
     if (flightNumber == "0") return;
 
-    auto flightsVec = Flight::loadFlights(PATH_OF_FLIGHTS_DATA_BASE);
+    // Covers seat claim, inventory, payment and save as child spans
+    TRACE_SPAN("Passenger::bookFlight");
+
+    auto table = FlightRegistry::table();
+    long row   = table->findRow(flightNumber);
     shared_ptr<Flight> selected;
 
-    for (auto const& fl : flightsVec)
-        if (fl.getFlightNumber() == flightNumber)
-            selected = make_shared<Flight>(fl);
+    if (row >= 0)
+        selected = ReservationPool::makeFlight(table->row(static_cast<size_t>(row)));
 
     if (!selected)
     {
@@ -134,59 +169,89 @@ void Passenger::bookFlight(void)
         return;
     }
 
-    cout << "Enter Seat Number (e.g., 14): ";
-    string seat;
-    cin >> seat;
+    string fareClass;
+    if (!selectFareBucket(*selected, fareClass))
+        return;
 
-    if (stoi(seat) > selected->getTotalSeats())
+    string resID = Reservation::nextReservationID();
+    if (resID.empty())
     {
-        cout << "Invalid seat number. Must be ≤ "
-             << selected->getTotalSeats() << ".\n";
+        cout << "No reservation number could be issued. Booking cancelled.\n";
         return;
     }
 
-    bool occupied = false;
-    auto allRes = Reservation::loadReservations();
-    for (auto const& res : allRes)
+    string seat = OVERBOOKED_SEAT;
+    if (SeatInventory::seatsAvailable(flightNumber) > 0)
     {
-        if (res->getFlight()->getFlightNumber() == flightNumber &&
-            res->getSeatNumber() == seat)
-        {
-            occupied = true;
-            break;
-        }
+        cout << "Enter Seat (e.g., 14A, or " << WINDOW_SEAT_REQUEST << " for a window seat): ";
+        string request;
+        cin >> request;
+
+        if (!SeatMap::claimSeat(*selected, request, seat))
+            return;
+    }
+    else
+    {
+        // Every physical seat is sold; the overbooking allowance still lets this fare sell
+        cout << "All seats are taken; a seat will be assigned at check-in.\n";
     }
 
-    if (occupied)
+    if (!SeatInventory::reserveSeat(flightNumber, fareClass))
     {
-        cout << "Seat " << seat << " already reserved. Choose another.\n";
+        SeatMap::releaseSeat(flightNumber, seat);
+        cout << "Fare class " << fareClass << " on flight " << flightNumber << " is sold out.\n";
         return;
     }
 
-    srand(static_cast<unsigned>(time(nullptr)));
-    string resID = generateRandomReservationID();
-    auto newRes  = make_shared<Reservation>(
+    auto newRes = ReservationPool::makeReservation(
         resID, username, selected, seat, "", ""
     );
+    newRes->setFareClass(fareClass);
+
+    if (!Payment::processPayment(newRes))
+    {
+        cout << "Payment failed. Booking aborted.\n";
+        SeatInventory::releaseSeat(flightNumber, fareClass);
+        SeatMap::releaseSeat(flightNumber, seat);
+        return;
+    }
 
-    bool paid = Payment::processPayment(newRes);
-    if (paid && newRes->getIsPaid())
+    // Only the new record is written, so settlements made meanwhile are left alone
+    if (!newRes->getIsPaid())
+        newRes->setHoldExpiresAt(SeatHold::expiryFromNow());
+    if (!Reservation::saveReservations({ newRes }))
+    {
+        cout << "Reservation could not be saved. Booking aborted.\n";
+        SeatInventory::releaseSeat(flightNumber, fareClass);
+        SeatMap::releaseSeat(flightNumber, seat);
+        return;
+    }
+
+    if (newRes->getIsPaid())
     {
-        allRes.push_back(newRes);
-        Reservation::saveReservations(allRes);
         cout << "Reservation successful!\n";
         newRes->displayReservation();
     }
-    else if (!newRes->getIsPaid())
+    else if (newRes->isPaymentPending())
     {
-        cout << "Reservation on hold. Confirm payment at airport.\n";
-        allRes.push_back(newRes);
-        Reservation::saveReservations(allRes);
-        newRes->displayHoldingReservation();
+        // Saved (and held) before the charge is queued, so the result always finds it
+        SeatHold::placeHold(resID, newRes->getHoldExpiresAt());
+        if (Payment::submitCardPayment({ newRes }))
+        {
+            cout << "Reservation saved; you will be notified once the card payment clears.\n";
+            newRes->displayReservation();
+        }
+        else
+        {
+            cout << "The card payment could not be started; the reservation was released. "
+                 << "Please try again.\n";
+        }
     }
     else
     {
-        cout << "Payment failed. Booking aborted.\n";
+        cout << "Reservation on hold. Confirm payment at airport.\n";
+        SeatHold::placeHold(resID, newRes->getHoldExpiresAt());
+        newRes->displayHoldingReservation();
     }
 
     reservations = Reservation::loadReservations();
@@ -231,6 +296,25 @@ void Passenger::checkIn(void)
     {
         if (res->getReservationID() == resID)
         {
+            if (res->getIsPaid() && res->getSeatNumber() == OVERBOOKED_SEAT)
+            {
+                // Overbooked passenger: seat them if a seat has been freed since booking
+                vector<string> freed;
+                if (!SeatMap::claimAdjacentSeats(*res->getFlight(), 1, freed))
+                {
+                    cout << "No seat is free yet; you are on standby for this flight.\n";
+                    return;
+                }
+                res->setSeatNumber(freed.front());
+                if (!Reservation::saveReservations({ res }))
+                {
+                    SeatMap::releaseSeat(res->getFlight()->getFlightNumber(), freed.front());
+                    res->setSeatNumber(OVERBOOKED_SEAT);
+                    cout << "Check-in could not be saved; please try again.\n";
+                    return;
+                }
+            }
+
             if (res->getIsPaid())
             {
                 cout << "\n✅ Check-In Successful!\n";
@@ -269,18 +353,48 @@ void Passenger::confirmCashPayment(void)
     string resID;
     cin >> resID;
 
+    // A repeated confirmation is answered from the idempotency index without file I/O
+    string key = "cash:" + resID, outcome;
+    IdempotencyState state = IdempotencyIndex::begin(key, outcome);
+    if (state == IdempotencyState::Completed)
+    {
+        cout << "Payment for reservation " << resID << " was already " << outcome << ".\n";
+        return;
+    }
+    if (state == IdempotencyState::InProgress)
+    {
+        cout << "Payment for reservation " << resID << " is already being confirmed.\n";
+        return;
+    }
+
+    // Reload so a hold that lapsed while the menu was open is no longer offered
+    reservations = Reservation::loadReservations();
     for (auto& res : reservations)
     {
-        if (res->getReservationID() == resID && !res->getIsPaid())
+        if (res->getReservationID() == resID && !res->getIsPaid() && !res->isPaymentPending())
         {
+            if (SeatHold::hasLapsed(res->getHoldExpiresAt()))
+            {
+                cout << "Hold on reservation " << resID << " has expired.\n";
+                IdempotencyIndex::complete(key, "expired");
+                return;
+            }
+
+            // The hold stays armed until the payment is on file; confirmPayments clears it
+            if (Reservation::confirmPayments({ resID }) == 0)
+                break;
+
             cout << "Payment confirmed at airport!\n";
             res->setIsPaid(true);
-            Reservation::saveReservations(reservations);
+            res->setHoldExpiresAt(0);
+            IdempotencyIndex::complete(key, "confirmed");
             cout << "Reservation confirmed.\n";
             res->printBoardingPass();
             return;
         }
     }
+
+    IdempotencyIndex::abandon(key);
     cout << "Reservation ID not found or already paid.\n";
 }
 
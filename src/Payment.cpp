@@ -2,19 +2,62 @@
  * MODULE NAME    : Payment Module
  * FILE           : Payment.cpp
  * DESCRIPTION    : Implements the Payment class methods, handling cash and card payments,
- *                  and saving user card details to JSON.
+ *                  and saving user card details to the card vault.
  * AUTHOR         : Hassan Darwish
  * DATE CREATED   : May 2025
  ******************************************************************************************/
 
 #include "../header/Payment.hpp"
+#include "../header/CardVault.hpp"
+#include "../header/FlightTable.hpp"
+#include "../header/Metrics.hpp"
+#include "../header/PaymentPipeline.hpp"
+#include <algorithm>
+#include <deque>
 #include <iostream>
-#include <fstream>
-#include <iomanip>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
 
 using namespace std;
-using json = nlohmann::json;
+
+static mutex                         checkoutMutex;
+static unordered_map<string, string> checkoutCvvs;   // Username -> CVV of the next charge
+
+/**
+ * Three or four digits, as printed on the card.
+ */
+static bool isWellFormedCvv(const string& cvv)
+{
+    return (cvv.size() == 3 || cvv.size() == 4) && cvv.find_first_not_of("0123456789") == string::npos;
+}
+
+/**
+ * Keeps the CVV entered at checkout until submitCardPayment hands it to the gateway.
+ */
+static void holdCheckoutCvv(const string& username, string& cvv)
+{
+    lock_guard<mutex> lock(checkoutMutex);
+    checkoutCvvs[username] = cvv;
+    fill(cvv.begin(), cvv.end(), '\0');
+}
+
+/**
+ * Takes (and forgets) the CVV entered at checkout; empty for charges made without one.
+ */
+static string takeCheckoutCvv(const string& username)
+{
+    lock_guard<mutex> lock(checkoutMutex);
+    auto it = checkoutCvvs.find(username);
+    if (it == checkoutCvvs.end())
+        return "";
+    string cvv = it->second;
+    fill(it->second.begin(), it->second.end(), '\0');
+    checkoutCvvs.erase(it);
+    return cvv;
+}
 
 /**
  * Prompts user for payment method (cash or card) and processes accordingly.
@@ -23,6 +66,7 @@ using json = nlohmann::json;
  */
 bool Payment::processPayment(shared_ptr<Reservation>& reservation)
 {
+    METRIC_SCOPE("Payment::processPayment");
     cout << "Choose Payment Method:\n"
          << "\t1 - Cash\n"
          << "\t2 - Card\n"
@@ -50,36 +94,30 @@ bool Payment::processPayment(shared_ptr<Reservation>& reservation)
 }
 
 /**
- * Handles card payment flow: existing card CVV check or new card entry.
+ * Handles card payment flow: saved card or new card entry, with the CVV asked for
+ * either way and kept only for the charge.
  * @param reservation Shared pointer to the Reservation object.
  * @return True if card payment is successful; false otherwise.
  */
 bool Payment::processCardPayment(shared_ptr<Reservation>& reservation)
 {
-    string username = reservation->getPassengerName();
-    ifstream inFile(PATH_OF_USER_CARD_DATA_BASE);
-    json allCards;
-
-    if (!inFile.is_open())
-    {
-        cerr << "Error: Unable to open card database.\n";
-        return false;
-    }
-
-    inFile >> allCards;
-    inFile.close();
+    const string& username = reservation->getPassengerName();
 
     // Existing card path
-    if (allCards.contains(username))
+    if (CardVault::hasCard(username))
     {
         cout << "Enter saved card CVV: ";
         string cvv;
         cin >> cvv;
 
-        if (allCards[username]["cvv"] == cvv)
+        // Only the issuer can check the CVV itself; the gateway gets it with the charge
+        if (isWellFormedCvv(cvv))
         {
-            cout << "Payment successful with saved card!\n";
-            reservation->setIsPaid(true);
+            holdCheckoutCvv(username, cvv);
+            cout << "Card accepted; payment is being processed.\n";
+            reservation->setPaymentMethod("Card");
+            reservation->setPaymentDetails(CardVault::maskedCardOf(username));
+            reservation->setIsPaid(false);
             return true;
         }
         else
@@ -106,55 +144,138 @@ bool Payment::processCardPayment(shared_ptr<Reservation>& reservation)
     string cvv;
     cin >> cvv;
 
-    reservation->setPaymentMethod(cardNumber);
-    reservation->setPaymentDetails(cvv);
+    // The reservation only ever sees the masked number; the card itself goes to the vault
+    reservation->setPaymentMethod("Card");
+    reservation->setPaymentDetails(CardVault::maskCardNumber(cardNumber));
 
-    saveCardInfo(cardNumber, cvv, expDate, cardHolder, username);
+    saveCardInfo(cardNumber, expDate, cardHolder, username);
+    holdCheckoutCvv(username, cvv);
 
-    cout << "Payment successful!\n";
-    reservation->setIsPaid(true);
+    cout << "Card accepted; payment is being processed.\n";
+    reservation->setIsPaid(false);
     return true;
 }
 
+static mutex         noticeMutex;
+static deque<string> paymentNotices;   // Oldest first
+
 /**
- * Saves or updates a user's card information in the JSON database.
- * @param cardNumber Card number string.
- * @param cvv        Card CVV string.
- * @param expDate    Card expiration date string.
- * @param cardHolder Card holder name string.
- * @param username   Username key for JSON.
+ * Runs on a pipeline worker: settles or cancels the whole batch with one file pass, and
+ * queues the outcome for the menu thread. Reservations canceled (by their owner or by
+ * hold expiry) while the charge was pending are not settled, so their share of an
+ * approved charge is refunded.
  */
-void Payment::saveCardInfo(const string& cardNumber,
-                          const string& cvv,
-                          const string& expDate,
-                          const string& cardHolder,
-                          const string& username)
+static void onCardPaymentResult(const PaymentRequest& request, const PaymentResult& result)
 {
-    json userCard = {
-        {"cardNumber", cardNumber},
-        {"cvv",        cvv},
-        {"expDate",    expDate},
-        {"cardHolder", cardHolder}
-    };
-
-    json allCards;
-    ifstream inFile(PATH_OF_USER_CARD_DATA_BASE);
-    if (inFile.is_open())
+    ostringstream notice;
+    if (result.approved)
     {
-        inFile >> allCards;
-        inFile.close();
+        vector<string> settledIDs;
+        size_t settled = Reservation::confirmPayments(request.reservationIDs, "", &settledIDs);
+        notice << "[Payment " << request.reference << "] Approved (" << result.authorizationCode
+               << "): " << settled << " reservation(s) confirmed.\n";
+
+        int64_t unsettledCents = 0;
+        size_t  unsettled      = 0;
+        for (size_t i = 0; i < request.reservationIDs.size(); ++i)
+            if (find(settledIDs.begin(), settledIDs.end(), request.reservationIDs[i]) == settledIDs.end())
+            {
+                ++unsettled;
+                unsettledCents += i < request.reservationCents.size() ? request.reservationCents[i] : 0;
+            }
+
+        if (unsettled > 0)
+        {
+            PaymentResult back = PaymentPipeline::refund(request, result, unsettledCents);
+            notice << "[Payment " << request.reference << "] " << unsettled
+                   << " reservation(s) were canceled before the charge cleared; ";
+            if (back.approved)
+                notice << PaymentPipeline::formatAmount(unsettledCents) << " refunded ("
+                       << back.authorizationCode << ").\n";
+            else
+                notice << "refund of " << PaymentPipeline::formatAmount(unsettledCents) << " failed ("
+                       << back.declineReason << "); please contact support.\n";
+        }
+    }
+    else
+    {
+        size_t canceled = Reservation::expireHolds(request.reservationIDs);
+        notice << "[Payment " << request.reference << "] Declined (" << result.declineReason
+               << "): " << canceled << " reservation(s) canceled.\n";
     }
 
-    allCards[username] = userCard;
+    lock_guard<mutex> lock(noticeMutex);
+    paymentNotices.push_back(notice.str());
+    if (paymentNotices.size() > PAYMENT_NOTICE_LIMIT)
+        paymentNotices.pop_front();
+}
 
-    ofstream outFile(PATH_OF_USER_CARD_DATA_BASE);
-    if (outFile.is_open())
+/**
+ * Takes the queue under the lock and prints it outside.
+ */
+void Payment::printNotices(void)
+{
+    deque<string> notices;
     {
-        outFile << setw(4) << allCards << endl;
-        outFile.close();
+        lock_guard<mutex> lock(noticeMutex);
+        notices.swap(paymentNotices);
     }
-    else
+    for (auto const& notice : notices)
+        cout << '\n' << notice;
+}
+
+/**
+ * Builds one request for the batch, priced at each reservation's fare, and queues it.
+ * @param reservations Saved reservations left pending by processCardPayment.
+ * @return True if the charge was queued (or an identical one already was); false if it
+ *         could not be, in which case the reservations have been canceled.
+ */
+bool Payment::submitCardPayment(const vector<shared_ptr<Reservation>>& reservations)
+{
+    METRIC_SCOPE("Payment::submitCardPayment");
+    if (reservations.empty())
+        return false;
+
+    PaymentRequest request;
+    request.reference = PaymentPipeline::newReference();
+    request.username  = reservations.front()->getPassengerName();
+    request.cardToken = CardVault::tokenOf(request.username);
+    request.cardCvv   = takeCheckoutCvv(request.username);
+
+    // The key names the reservations being paid for, so resubmitting them is a no-op
+    int64_t cents = 0;
+    request.idempotencyKey = "charge:";
+    for (auto const& res : reservations)
     {
-        cerr << "Error: Unable to save card information for user " << username << ".\n";
+        const Flight&     flight = *res->getFlight();
+        const FareBucket* bucket = flight.findFareBucket(res->getFareClass());
+        request.reservationCents.push_back(FlightTable::parsePriceCents(bucket ? bucket->price : flight.getflightPrice()));
+        cents += request.reservationCents.back();
+        request.reservationIDs.push_back(res->getReservationID());
+        request.idempotencyKey += (request.reservationIDs.size() > 1 ? "," : "") + res->getReservationID();
     }
+
+    request.amount = PaymentPipeline::formatAmount(cents);
+
+    if (PaymentPipeline::submit(request, onCardPaymentResult))
+        return true;
+
+    // Nothing will ever settle or decline them; release them rather than leave them pending
+    Reservation::expireHolds(request.reservationIDs);
+    return false;
+}
+
+/**
+ * Saves or updates a user's card in the card vault.
+ * @param cardNumber Card number string.
+ * @param expDate    Card expiration date string.
+ * @param cardHolder Card holder name string.
+ * @param username   Username the card is saved under.
+ */
+void Payment::saveCardInfo(const string& cardNumber,
+                          const string& expDate,
+                          const string& cardHolder,
+                          const string& username)
+{
+    CardVault::storeCard(username, cardNumber, expDate, cardHolder);
 }
@@ -0,0 +1,93 @@
+/******************************************************************************************
+ * MODULE NAME    : Payment Gateway Module
+ * FILE           : PaymentGateway.cpp
+ * DESCRIPTION    : Implements the mock payment gateway.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/PaymentGateway.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+
+/**
+ * Constructor: Clamps the decline rate into [0, 1].
+ */
+MockPaymentGateway::MockPaymentGateway(int latency, double rate, unsigned seed)
+    : latencyMs(max(latency, 0)), declineRate(min(max(rate, 0.0), 1.0)),
+      declineSeed(seed), approvals(0), refunds(0)
+{
+}
+
+/**
+ * Sleeps outside the lock so concurrent charges overlap like real network calls.
+ */
+PaymentResult MockPaymentGateway::charge(const PaymentRequest& request)
+{
+    if (latencyMs > 0)
+        this_thread::sleep_for(chrono::milliseconds(latencyMs));
+
+    seed_seq draw{ declineSeed, static_cast<unsigned>(hash<string>()(request.idempotencyKey)) };
+    mt19937  random(draw);
+
+    PaymentResult result;
+    lock_guard<mutex> lock(approvalMutex);
+    if (request.cardToken.empty())
+    {
+        result.declineReason = "no card on file";
+    }
+    else if (!request.cardCvv.empty() &&
+             (request.cardCvv.size() < 3 || request.cardCvv.size() > 4 ||
+              request.cardCvv.find_first_not_of("0123456789") != string::npos))
+    {
+        result.declineReason = "invalid CVV";
+    }
+    else if (uniform_real_distribution<double>(0.0, 1.0)(random) < declineRate)
+    {
+        result.declineReason = "declined by issuer";
+    }
+    else
+    {
+        result.approved          = true;
+        result.authorizationCode = "MOCK" + to_string(++approvals);
+    }
+    return result;
+}
+
+/**
+ * Refunds are never declined, short of naming a charge this gateway did not approve.
+ */
+PaymentResult MockPaymentGateway::refund(const PaymentRequest&, const string& authorizationCode,
+                                         const string&)
+{
+    if (latencyMs > 0)
+        this_thread::sleep_for(chrono::milliseconds(latencyMs));
+
+    PaymentResult result;
+    lock_guard<mutex> lock(approvalMutex);
+    if (authorizationCode.compare(0, 4, "MOCK") != 0)
+    {
+        result.declineReason = "unknown charge";
+    }
+    else
+    {
+        result.approved          = true;
+        result.authorizationCode = "MOCKREF" + to_string(++refunds);
+    }
+    return result;
+}
+
+/**
+ * Getter: gateway name.
+ */
+string MockPaymentGateway::name(void) const
+{
+    return "mock";
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
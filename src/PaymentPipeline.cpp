@@ -0,0 +1,271 @@
+/******************************************************************************************
+ * MODULE NAME    : Payment Pipeline Module
+ * FILE           : PaymentPipeline.cpp
+ * DESCRIPTION    : Implements the background card payment queue.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/PaymentPipeline.hpp"
+#include "../header/ThreadPool.hpp"
+#include "../header/IdempotencyIndex.hpp"
+#include "../header/Metrics.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <ctime>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <mutex>
+
+using namespace std;
+
+static shared_ptr<ThreadPool>     paymentWorkers;
+static shared_ptr<PaymentGateway> paymentGateway;
+static mutex                      pipelineMutex;
+static atomic<uint64_t>           paymentsSubmitted{0};
+static atomic<uint64_t>           paymentsApproved{0};
+static atomic<uint64_t>           paymentsDeclined{0};
+static atomic<uint64_t>           paymentsDeduplicated{0};
+static atomic<uint64_t>           paymentsRefunded{0};
+static atomic<uint64_t>           referenceCounter{0};
+
+/**
+ * Stops the workers at exit if main did not.
+ */
+struct PipelineStopper
+{
+    ~PipelineStopper() { PaymentPipeline::stop(); }
+};
+static PipelineStopper pipelineStopper;
+
+/**
+ * Replaces the pool; releasing the old one settles whatever it still had queued.
+ */
+void PaymentPipeline::start(shared_ptr<PaymentGateway> gateway, size_t workers)
+{
+    shared_ptr<ThreadPool> previous;
+    {
+        lock_guard<mutex> lock(pipelineMutex);
+        previous       = move(paymentWorkers);
+        paymentGateway = move(gateway);
+        paymentWorkers = make_shared<ThreadPool>(workers);
+    }
+}
+
+/**
+ * Detaches the pool under the lock and joins it outside, so callbacks still running
+ * can read the stats without deadlocking.
+ */
+void PaymentPipeline::stop(void)
+{
+    shared_ptr<ThreadPool> workers;
+    {
+        lock_guard<mutex> lock(pipelineMutex);
+        workers = move(paymentWorkers);
+    }
+    workers.reset();
+}
+
+/**
+ * Asks a gateway for a refund; one that throws counts as a refused refund.
+ */
+static PaymentResult refundThrough(PaymentGateway& gateway, const PaymentRequest& request,
+                                   const string& authorizationCode, const string& amount)
+{
+    PaymentResult result;
+    try
+    {
+        METRIC_SCOPE("PaymentGateway::refund");
+        result = gateway.refund(request, authorizationCode, amount);
+    }
+    catch (const exception& e)
+    {
+        result.approved      = false;
+        result.declineReason = string("gateway error: ") + e.what();
+    }
+    if (result.approved)
+        ++paymentsRefunded;
+    return result;
+}
+
+/**
+ * The worker charges, counts the outcome and hands it to the callback. A gateway that
+ * throws counts as a decline, so the booking is never left pending forever. The key is
+ * marked complete only after the callback has settled the reservations; if the callback
+ * fails instead, the money goes back and the key is abandoned rather than left in
+ * progress, where every retry would be dropped as a duplicate.
+ */
+bool PaymentPipeline::submit(const PaymentRequest& request, PaymentCallback onResult)
+{
+    const string& key = request.idempotencyKey;
+    if (!key.empty())
+    {
+        string outcome;
+        if (IdempotencyIndex::begin(key, outcome) != IdempotencyState::New)
+        {
+            ++paymentsDeduplicated;
+            return true;
+        }
+    }
+
+    lock_guard<mutex> lock(pipelineMutex);
+    if (!paymentWorkers)
+    {
+        paymentGateway = make_shared<MockPaymentGateway>(MOCK_GATEWAY_LATENCY_MS,
+                                                         MOCK_GATEWAY_DECLINE_RATE,
+                                                         mockGatewaySeed());
+        paymentWorkers = make_shared<ThreadPool>(PAYMENT_WORKERS);
+    }
+
+    shared_ptr<PaymentGateway> gateway = paymentGateway;
+    bool queued = paymentWorkers->submit([gateway, request, onResult]() {
+        PaymentResult result;
+        try
+        {
+            METRIC_SCOPE("PaymentGateway::charge");
+            result = gateway->charge(request);
+        }
+        catch (const exception& e)
+        {
+            result.approved      = false;
+            result.declineReason = string("gateway error: ") + e.what();
+        }
+
+        ++(result.approved ? paymentsApproved : paymentsDeclined);
+        string failure;
+        try
+        {
+            if (onResult)
+                onResult(request, result);
+        }
+        catch (const exception& e)
+        {
+            failure = e.what();
+        }
+        catch (...)
+        {
+            failure = "unknown error";
+        }
+
+        if (!failure.empty())
+        {
+            cerr << "[Payment " << request.reference << "] Could not be settled (" << failure << ")";
+            if (result.approved)
+            {
+                PaymentResult back = refundThrough(*gateway, request, result.authorizationCode, request.amount);
+                cerr << (back.approved ? "; charge refunded" : "; refund failed: " + back.declineReason);
+            }
+            cerr << ".\n";
+            if (!request.idempotencyKey.empty())
+                IdempotencyIndex::abandon(request.idempotencyKey);
+        }
+        else if (!request.idempotencyKey.empty())
+        {
+            IdempotencyIndex::complete(request.idempotencyKey,
+                                       result.approved ? "approved " + result.authorizationCode
+                                                       : "declined: " + result.declineReason);
+        }
+    });
+
+    if (queued)
+        ++paymentsSubmitted;
+    else if (!key.empty())
+        IdempotencyIndex::abandon(key);
+    return queued;
+}
+
+/**
+ * Uses the gateway the pipeline runs on now; charges are always refunded where made
+ * because start() only swaps gateways between drained pools.
+ */
+PaymentResult PaymentPipeline::refund(const PaymentRequest& request, const PaymentResult& charged, int64_t cents)
+{
+    shared_ptr<PaymentGateway> gateway;
+    {
+        lock_guard<mutex> lock(pipelineMutex);
+        gateway = paymentGateway;
+    }
+    if (!gateway)
+    {
+        PaymentResult result;
+        result.declineReason = "no gateway";
+        return result;
+    }
+    return refundThrough(*gateway, request, charged.authorizationCode, formatAmount(cents));
+}
+
+/**
+ * Dollars and two-digit cents followed by '$'.
+ */
+string PaymentPipeline::formatAmount(int64_t cents)
+{
+    char amount[32];
+    snprintf(amount, sizeof(amount), "%lld.%02lld$",
+             static_cast<long long>(cents / 100), static_cast<long long>(cents % 100));
+    return amount;
+}
+
+/**
+ * Waits on the current pool, if any, without holding the lock so callbacks may submit.
+ */
+void PaymentPipeline::drain(void)
+{
+    shared_ptr<ThreadPool> workers;
+    {
+        lock_guard<mutex> lock(pipelineMutex);
+        workers = paymentWorkers;
+    }
+    if (workers)
+        workers->wait();
+}
+
+/**
+ * Start time plus a process-wide counter keeps references unique across runs.
+ */
+string PaymentPipeline::newReference(void)
+{
+    return "PAY-" + to_string(static_cast<long long>(time(nullptr))) + "-" +
+           to_string(++referenceCounter);
+}
+
+/**
+ * Snapshot of the counters.
+ */
+PaymentPipelineStats PaymentPipeline::stats(void)
+{
+    PaymentPipelineStats s;
+    s.submitted    = paymentsSubmitted.load();
+    s.approved     = paymentsApproved.load();
+    s.declined     = paymentsDeclined.load();
+    s.deduplicated = paymentsDeduplicated.load();
+    s.refunded     = paymentsRefunded.load();
+
+    lock_guard<mutex> lock(pipelineMutex);
+    if (paymentWorkers)
+    {
+        s.inFlight = paymentWorkers->pending();
+        s.workers  = paymentWorkers->size();
+    }
+    if (paymentGateway)
+        s.gateway = paymentGateway->name();
+    return s;
+}
+
+/**
+ * Reads the environment on every call; it is only consulted when a gateway is made.
+ */
+unsigned PaymentPipeline::mockGatewaySeed(void)
+{
+    const char* text = getenv(GATEWAY_SEED_ENVIRONMENT_VARIABLE);
+    char*       end  = nullptr;
+    if (!text || !*text)
+        return MOCK_GATEWAY_SEED;
+
+    unsigned long seed = strtoul(text, &end, 10);
+    return *end == '\0' ? static_cast<unsigned>(seed) : MOCK_GATEWAY_SEED;
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
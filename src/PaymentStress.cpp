@@ -0,0 +1,242 @@
+/******************************************************************************************
+ * MODULE NAME    : Payment Stress Module
+ * FILE           : PaymentStress.cpp
+ * DESCRIPTION    : Implements the exactly-once payment self-check.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/PaymentStress.hpp"
+#include "../header/CardVault.hpp"
+#include "../header/FlightRegistry.hpp"
+#include "../header/FlightTable.hpp"
+#include "../header/IdempotencyIndex.hpp"
+#include "../header/Payment.hpp"
+#include "../header/PaymentPipeline.hpp"
+#include "../header/Reservation.hpp"
+#include "../header/SeatHold.hpp"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * A copy of data_base in a fresh temp directory, worked in for the length of a run.
+ * Leaving the scope moves back to the original working directory and removes the copy,
+ * whether the run finished or its setup stopped halfway.
+ */
+class ScratchCopy
+{
+public:
+    ~ScratchCopy(void)
+    {
+        error_code ec;
+        if (!original.empty())
+            filesystem::current_path(original, ec);
+        if (!scratch.empty())
+            filesystem::remove_all(scratch, ec);
+    }
+
+    /**
+     * Creates the directory (never reusing one that exists), copies data_base into it
+     * and moves into it.
+     */
+    bool enter(string& error)
+    {
+        error_code       ec;
+        filesystem::path base = filesystem::current_path(ec);
+        filesystem::path dir;
+        if (!ec)
+            dir = filesystem::temp_directory_path(ec) /
+                  ("airline-stress-" + to_string(chrono::steady_clock::now().time_since_epoch().count()));
+        if (!ec && filesystem::create_directory(dir, ec))
+            scratch = dir;
+        else if (!ec)
+            ec = make_error_code(errc::file_exists);
+        if (!ec)
+            filesystem::copy(base / "data_base", scratch / "data_base", filesystem::copy_options::recursive, ec);
+        if (!ec)
+            filesystem::current_path(scratch, ec);
+        if (!ec)
+            original = base;
+        if (ec)
+            error = "cannot set up a scratch copy of data_base: " + ec.message();
+        return !ec;
+    }
+
+private:
+    filesystem::path original;   // Set once the run has moved into the copy
+    filesystem::path scratch;    // Set once the directory exists
+};
+
+/**
+ * Runs body(thread, retry) on every thread for every retry, all threads at once.
+ */
+static void race(size_t threads, size_t retries, const function<void(size_t, size_t)>& body)
+{
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+        workers.emplace_back([t, retries, &body]() {
+            for (size_t r = 0; r < retries; ++r)
+                body(t, r);
+        });
+    for (auto& worker : workers)
+        worker.join();
+}
+
+/**
+ * Books one unpaid reservation per ID on the first scheduled flight, all with one write.
+ */
+static bool bookUnpaid(const vector<string>& ids, const string& method,
+                       vector<shared_ptr<Reservation>>& booked)
+{
+    auto table = FlightRegistry::table();
+    if (table->size() == 0)
+        return false;
+
+    auto flight = make_shared<Flight>(table->row(0));
+    for (auto const& id : ids)
+    {
+        auto res = make_shared<Reservation>(id, PAYMENT_STRESS_USER, flight, OVERBOOKED_SEAT,
+                                            method, method == "Card" ? CardVault::maskedCardOf(PAYMENT_STRESS_USER) : "");
+        if (!flight->getFareBuckets().empty())
+            res->setFareClass(flight->getFareBuckets().back().code);
+        res->setHoldExpiresAt(SeatHold::expiryFromNow());
+        booked.push_back(res);
+    }
+    if (!Reservation::saveReservations(booked))
+        return false;
+
+    for (auto const& res : booked)
+        SeatHold::placeHold(res->getReservationID(), res->getHoldExpiresAt());
+    return true;
+}
+
+/**
+ * Each phase checks its own invariant; "passed" is their conjunction. Console output of
+ * the domain layer is muted for the run so only the report is printed.
+ */
+json PaymentStress::run(size_t reservations, size_t threads, size_t retries)
+{
+    json report = { {"reservations", reservations}, {"threads", threads}, {"retries", retries} };
+    report["passed"] = false;
+    if (reservations == 0 || threads == 0 || retries == 0)
+    {
+        report["error"] = "reservations, threads and retries must be positive";
+        return report;
+    }
+
+    ScratchCopy scratch;
+    string      error;
+    if (!scratch.enter(error))
+    {
+        report["error"] = error;
+        return report;
+    }
+    cout.setstate(ios::badbit);
+
+    PaymentPipeline::start(make_shared<MockPaymentGateway>(PAYMENT_STRESS_LATENCY_MS, 0.0, 1));
+    if (CardVault::storeCard(PAYMENT_STRESS_USER, "4111111111111111", "12/99", "Stress Test").empty())
+        error = "cannot save the test card";
+
+    // IDs: every thread draws its share at once; none may repeat or be empty
+    const size_t       total = 2 * reservations;
+    vector<vector<string>> drawn(threads);
+    race(threads, 1, [&](size_t t, size_t) {
+        for (size_t i = t; i < total; i += threads)
+            drawn[t].push_back(Reservation::nextReservationID());
+    });
+    vector<string> ids;
+    for (auto const& part : drawn)
+        ids.insert(ids.end(), part.begin(), part.end());
+    unordered_set<string> distinct(ids.begin(), ids.end());
+    distinct.erase("");
+    report["ids"] = { {"drawn", ids.size()}, {"distinct", distinct.size()} };
+
+    vector<string> cashIDs(ids.begin(), ids.begin() + reservations);
+    vector<string> cardIDs(ids.begin() + reservations, ids.end());
+    vector<shared_ptr<Reservation>> cash, card;
+    if (error.empty() && (!bookUnpaid(cashIDs, "Cash", cash) || !bookUnpaid(cardIDs, "Card", card)))
+        error = "cannot book the test reservations";
+
+    // Cash: the confirmation protocol of the menus and the batch runner, from every thread
+    atomic<size_t> claimed{0}, settled{0}, repeated{0};
+    if (error.empty())
+    {
+        race(threads, retries, [&](size_t t, size_t) {
+            for (size_t i = 0; i < reservations; ++i)
+            {
+                const string& id  = cashIDs[(i + t) % reservations];
+                string        key = "cash:" + id, outcome;
+                if (IdempotencyIndex::begin(key, outcome) != IdempotencyState::New)
+                {
+                    ++repeated;
+                    continue;
+                }
+                ++claimed;
+                size_t paid = Reservation::confirmPayments({ id }, "Cash");
+                settled += paid;
+                if (paid > 0)
+                    IdempotencyIndex::complete(key, "confirmed");
+                else
+                    IdempotencyIndex::abandon(key);
+            }
+        });
+    }
+    report["cash"] = { {"attempts", threads * retries * reservations}, {"claimed", claimed.load()},
+                       {"settled", settled.load()}, {"deduplicated", repeated.load()} };
+
+    // Card: the same charge resubmitted from every thread while earlier ones are in flight
+    PaymentPipelineStats before = PaymentPipeline::stats();
+    if (error.empty())
+    {
+        race(threads, retries, [&](size_t t, size_t) {
+            for (size_t i = 0; i < reservations; ++i)
+                Payment::submitCardPayment({ card[(i + t) % reservations] });
+        });
+        PaymentPipeline::drain();
+    }
+    PaymentPipelineStats after = PaymentPipeline::stats();
+    report["card"] = { {"attempts", threads * retries * reservations},
+                       {"charged", after.submitted - before.submitted},
+                       {"approved", after.approved - before.approved},
+                       {"deduplicated", after.deduplicated - before.deduplicated} };
+
+    size_t paid = 0, holdsLeft = 0;
+    unordered_set<string> ours(ids.begin(), ids.end());
+    for (auto const& res : Reservation::loadReservations())
+        if (ours.count(res->getReservationID()) && res->getIsPaid())
+            ++paid;
+    for (auto const& id : ids)
+        holdsLeft += SeatHold::clearHold(id) ? 1 : 0;
+    report["paid"]      = paid;
+    report["holdsLeft"] = holdsLeft;
+
+    PaymentPipeline::stop();
+    SeatHold::stop();
+    Reservation::waitForCompaction();
+    cout.clear();
+
+    if (!error.empty())
+        report["error"] = error;
+    report["passed"] = error.empty() && distinct.size() == total &&
+                       claimed == reservations && settled == reservations &&
+                       report["card"]["charged"] == reservations &&
+                       report["card"]["approved"] == reservations &&
+                       paid == total && holdsLeft == 0;
+    return report;
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
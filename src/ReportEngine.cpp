@@ -0,0 +1,403 @@
+/******************************************************************************************
+ * MODULE NAME    : Report Engine Module
+ * FILE           : ReportEngine.cpp
+ * DESCRIPTION    : Implements the chunked parallel aggregation of reservations, the
+ *                  grouping of its totals and the console, CSV and JSON writers.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/ReportEngine.hpp"
+#include "../header/FlightRegistry.hpp"
+#include "../header/Metrics.hpp"
+#include "../header/ThreadPool.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * Bookings of one sold flight counted by one chunk. The flight is the one embedded in
+ * the first reservation counted for it, so it outlives nothing but the chunk's input.
+ */
+struct SoldCount
+{
+    const Flight* flight;
+    long          row;                    // In the live table, or -1 if no longer scheduled
+    int64_t       bookings          = 0;
+    int64_t       agentBookings     = 0;
+    int64_t       revenueCents      = 0;
+    int64_t       agentRevenueCents = 0;
+};
+
+/**
+ * What one chunk of reservations adds up to, keyed by flight number and then by the
+ * departure the reservations were sold for (almost always one).
+ */
+struct ChunkTotals
+{
+    unordered_map<string, vector<SoldCount>> flights;
+    int     reservations = 0;
+    int     unpaid       = 0;
+    int64_t revenueCents = 0;
+};
+
+/**
+ * Fare of one booking: the current fare of its class while the flight is scheduled
+ * (as the sales ledger values it), else the fare embedded in the reservation. A class
+ * the flight does not sell counts at the first bucket, like FlightTable::fareBucketIndex.
+ */
+static int64_t fareOf(const Reservation& res, const FlightTable& table, long row)
+{
+    if (row >= 0)
+    {
+        size_t index = static_cast<size_t>(row);
+        return table.getFareCents(index, table.fareBucketIndex(index, res.getFareClass()));
+    }
+
+    const Flight&     flight = *res.getFlight();
+    const FareBucket* bucket = flight.findFareBucket(res.getFareClass());
+    if (!bucket && !flight.getFareBuckets().empty())
+        bucket = &flight.getFareBuckets().front();
+    return FlightTable::parsePriceCents(bucket ? bucket->price : flight.getflightPrice());
+}
+
+/**
+ * Counts one chunk from the flight data each reservation carries, so bookings on a
+ * flight since removed from the schedule are still counted; every lookup table it
+ * reads is shared and read-only.
+ */
+static void countChunk(const vector<shared_ptr<Reservation>>& reservations, size_t first, size_t last,
+                       const FlightTable& table, const unordered_set<string>& agentIDs,
+                       ChunkTotals& totals)
+{
+    for (size_t i = first; i < last; ++i)
+    {
+        const Reservation& res    = *reservations[i];
+        const Flight&      flight = *res.getFlight();
+
+        auto it = totals.flights.find(flight.getFlightNumber());
+        if (it == totals.flights.end())
+            it = totals.flights.emplace(flight.getFlightNumber(), vector<SoldCount>()).first;
+
+        SoldCount* sold = nullptr;
+        for (auto& candidate : it->second)
+            if (candidate.flight->getDepartureTime() == flight.getDepartureTime())
+                sold = &candidate;
+        if (!sold)
+        {
+            it->second.push_back({ &flight, table.findRow(flight.getFlightNumber()) });
+            sold = &it->second.back();
+        }
+
+        int64_t fare = fareOf(res, table, sold->row);
+        ++sold->bookings;
+        sold->revenueCents += fare;
+        if (agentIDs.count(res.getReservationID()))
+        {
+            ++sold->agentBookings;
+            sold->agentRevenueCents += fare;
+        }
+        ++totals.reservations;
+        totals.unpaid       += res.getIsPaid() ? 0 : 1;
+        totals.revenueCents += fare;
+    }
+}
+
+/**
+ * The main file holds every booking, agent ones included; the agent file only says
+ * which of them came through an agent.
+ */
+ReportTotals ReportEngine::aggregate(size_t workers)
+{
+    vector<string> agentIDs;
+    for (auto const& res : Reservation::loadBookingAgentReservations())
+        agentIDs.push_back(res->getReservationID());
+    return aggregate(Reservation::loadReservations(), agentIDs, workers);
+}
+
+/**
+ * A report too small for two chunks is counted on the calling thread; otherwise a pool
+ * is started for the report and each worker takes a contiguous chunk.
+ */
+ReportTotals ReportEngine::aggregate(const vector<shared_ptr<Reservation>>& reservations,
+                                     const vector<string>& agentIDs, size_t workers)
+{
+    METRIC_SCOPE("ReportEngine::aggregate");
+    ReportTotals totals;
+    totals.table = FlightRegistry::table();
+    const FlightTable& table = *totals.table;
+
+    unordered_set<string> agents(agentIDs.begin(), agentIDs.end());
+
+    if (workers == 0)
+        workers = max<size_t>(thread::hardware_concurrency(), 1);
+    size_t chunks = min(workers, max<size_t>(reservations.size() / REPORT_CHUNK_RESERVATIONS, 1));
+
+    vector<ChunkTotals> parts(chunks);
+    if (chunks == 1)
+    {
+        countChunk(reservations, 0, reservations.size(), table, agents, parts[0]);
+    }
+    else
+    {
+        ThreadPool pool(chunks);
+        vector<function<void()>> tasks;
+        for (size_t c = 0; c < chunks; ++c)
+        {
+            size_t first = reservations.size() * c / chunks;
+            size_t last  = reservations.size() * (c + 1) / chunks;
+            tasks.push_back([&, first, last, c]()
+            {
+                countChunk(reservations, first, last, table, agents, parts[c]);
+            });
+        }
+        pool.runAll(move(tasks));
+    }
+
+    // Merge by flight number and departure; the flights are copied out of the chunks
+    // because the reservations they point into may not outlive the report
+    unordered_map<string, vector<size_t>> merged;
+    for (auto const& part : parts)
+    {
+        for (auto const& entry : part.flights)
+        {
+            vector<size_t>& slots = merged[entry.first];
+            for (auto const& sold : entry.second)
+            {
+                size_t slot = totals.flights.size();
+                for (size_t s : slots)
+                    if (totals.flights[s].flight.getDepartureTime() == sold.flight->getDepartureTime())
+                        slot = s;
+                if (slot == totals.flights.size())
+                {
+                    slots.push_back(slot);
+                    totals.flights.push_back({ *sold.flight, sold.row });
+                }
+
+                SoldFlight& into = totals.flights[slot];
+                into.bookings          += sold.bookings;
+                into.agentBookings     += sold.agentBookings;
+                into.revenueCents      += sold.revenueCents;
+                into.agentRevenueCents += sold.agentRevenueCents;
+            }
+        }
+        totals.reservations += part.reservations;
+        totals.unpaid       += part.unpaid;
+        totals.revenueCents += part.revenueCents;
+    }
+    return totals;
+}
+
+/**
+ * Group key of a flight; channel grouping is split per booking instead. A sold flight
+ * without an aircraft type takes the one its schedule row has now, if any.
+ */
+static string groupOf(const Flight& flight, const FlightTable& table, long row, ReportGrouping grouping)
+{
+    switch (grouping)
+    {
+    case ReportGrouping::Flight:
+        return flight.getFlightNumber();
+    case ReportGrouping::Route:
+        return flight.getOrigin() + "-" + flight.getDestination();
+    case ReportGrouping::Month:
+        return flight.getDepartureTime().size() >= 7 ? flight.getDepartureTime().substr(0, 7) : "unknown";
+    case ReportGrouping::AircraftType:
+        if (flight.getAircraftType().empty() && row >= 0)
+            return table.row(static_cast<size_t>(row)).getAircraftType();
+        return flight.getAircraftType();
+    default:
+        return string();
+    }
+}
+
+/**
+ * One visit per sold flight, then one per scheduled flight nobody has booked so the
+ * flight counts still cover the whole schedule.
+ */
+vector<ReportLine> ReportEngine::group(const ReportTotals& totals, ReportGrouping grouping)
+{
+    METRIC_SCOPE("ReportEngine::group");
+    const FlightTable& table = *totals.table;
+    map<string, ReportLine> lines;
+
+    vector<bool> booked(table.size(), false);
+    for (auto const& sold : totals.flights)
+    {
+        if (sold.row >= 0)
+            booked[static_cast<size_t>(sold.row)] = true;
+
+        if (grouping == ReportGrouping::Channel)
+        {
+            ReportLine& direct = lines["direct"];
+            ReportLine& agent  = lines["agent"];
+            direct.flights      += sold.bookings > sold.agentBookings ? 1 : 0;
+            direct.bookings     += sold.bookings - sold.agentBookings;
+            direct.revenueCents += sold.revenueCents - sold.agentRevenueCents;
+            agent.flights       += sold.agentBookings > 0 ? 1 : 0;
+            agent.bookings      += sold.agentBookings;
+            agent.revenueCents  += sold.agentRevenueCents;
+            continue;
+        }
+
+        ReportLine& line = lines[groupOf(sold.flight, table, sold.row, grouping)];
+        ++line.flights;
+        line.bookings     += sold.bookings;
+        line.revenueCents += sold.revenueCents;
+    }
+
+    if (grouping == ReportGrouping::Channel)
+    {
+        // Both channels always appear, as they did when every scheduled flight was visited
+        lines["direct"];
+        lines["agent"];
+    }
+    else
+    {
+        for (size_t row = 0; row < table.size(); ++row)
+            if (!booked[row])
+                ++lines[groupOf(table.row(row), table, static_cast<long>(row), grouping)].flights;
+    }
+
+    vector<ReportLine> sorted;
+    sorted.reserve(lines.size());
+    for (auto& entry : lines)
+    {
+        entry.second.group = entry.first;
+        sorted.push_back(move(entry.second));
+    }
+    return sorted;
+}
+
+/**
+ * Cents as a plain decimal amount.
+ */
+static string amountOf(int64_t cents)
+{
+    ostringstream amount;
+    amount << (cents < 0 ? "-" : "") << llabs(cents) / 100 << '.'
+           << setw(2) << setfill('0') << llabs(cents) % 100;
+    return amount.str();
+}
+
+/**
+ * Quotes a CSV field if it holds a comma, quote or line break.
+ */
+static string csvField(const string& field)
+{
+    if (field.find_first_of(",\"\r\n") == string::npos)
+        return field;
+
+    string quoted = "\"";
+    for (char c : field)
+    {
+        if (c == '"')
+            quoted += '"';
+        quoted += c;
+    }
+    return quoted + '"';
+}
+
+json ReportEngine::toJson(const vector<ReportLine>& lines, ReportGrouping grouping)
+{
+    json groups = json::array();
+    for (auto const& line : lines)
+    {
+        groups.push_back({ {name(grouping), line.group}, {"flights", line.flights},
+                           {"bookings", line.bookings}, {"revenue", line.revenueCents / 100.0} });
+    }
+    return groups;
+}
+
+/**
+ * The console table sizes its key column to the longest group.
+ */
+void ReportEngine::write(const vector<ReportLine>& lines, ReportGrouping grouping, ReportFormat format,
+                         ostream& out)
+{
+    switch (format)
+    {
+    case ReportFormat::Csv:
+        out << name(grouping) << ",flights,bookings,revenue\n";
+        for (auto const& line : lines)
+        {
+            out << csvField(line.group) << ',' << line.flights << ',' << line.bookings << ','
+                << amountOf(line.revenueCents) << '\n';
+        }
+        break;
+
+    case ReportFormat::Json:
+        out << setw(4) << json{ {"groupBy", name(grouping)}, {"groups", toJson(lines, grouping)} } << '\n';
+        break;
+
+    case ReportFormat::Console:
+    {
+        size_t width = string(name(grouping)).size();
+        for (auto const& line : lines)
+            width = max(width, line.group.size());
+
+        string heading = name(grouping);
+        heading[0] = static_cast<char>(toupper(static_cast<unsigned char>(heading[0])));
+        out << left << setw(static_cast<int>(width) + 2) << heading << right
+            << setw(10) << "Flights" << setw(12) << "Bookings" << setw(16) << "Revenue" << '\n';
+        for (auto const& line : lines)
+        {
+            out << left << setw(static_cast<int>(width) + 2) << line.group << right
+                << setw(10) << line.flights << setw(12) << line.bookings
+                << setw(16) << ("$" + amountOf(line.revenueCents)) << '\n';
+        }
+        break;
+    }
+    }
+}
+
+bool ReportEngine::parseGrouping(const string& text, ReportGrouping& grouping)
+{
+    for (ReportGrouping g : { ReportGrouping::Flight, ReportGrouping::Route, ReportGrouping::Month,
+                              ReportGrouping::AircraftType, ReportGrouping::Channel })
+    {
+        if (text == name(g))
+        {
+            grouping = g;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReportEngine::parseFormat(const string& text, ReportFormat& format)
+{
+    if (text == "console")   format = ReportFormat::Console;
+    else if (text == "csv")  format = ReportFormat::Csv;
+    else if (text == "json") format = ReportFormat::Json;
+    else                     return false;
+    return true;
+}
+
+const char* ReportEngine::name(ReportGrouping grouping)
+{
+    switch (grouping)
+    {
+    case ReportGrouping::Flight:       return "flight";
+    case ReportGrouping::Route:        return "route";
+    case ReportGrouping::Month:        return "month";
+    case ReportGrouping::AircraftType: return "aircraft";
+    case ReportGrouping::Channel:      return "channel";
+    }
+    return "flight";
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
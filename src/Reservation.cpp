@@ -9,6 +9,13 @@
  ******************************************************************************************/
 
 #include "../header/Reservation.hpp"
+#include "../header/SeatInventory.hpp"
+#include "../header/SeatHold.hpp"
+#include "../header/SeatMap.hpp"
+#include "../header/SalesLedger.hpp"
+#include "../header/CardVault.hpp"
+#include "../header/Metrics.hpp"
+#include "../header/MemoryAccounting.hpp"
 #include "../header/json.hpp"
 #include <iostream>
 #include <fstream>
@@ -16,12 +23,250 @@
 #include <algorithm>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cctype>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <ctime>
 
 using namespace std;
 using json = nlohmann::json;
 
+/* Record arena bytes per reservation: the reservation and its flight, each with the
+   control block allocate_shared puts in front of it */
+#define RESERVATION_ARENA_BYTES_PER_RECORD (sizeof(Reservation) + sizeof(Flight) + 64)
+
+/* Digits of a sequence-issued reservation number; longer numbers simply grow */
+#define RESERVATION_ID_DIGITS 6
+
+// Serialises every read-modify-write of the reservation files, including the compactor
+static mutex reservationFileMutex;
+
+// Reservation numbers of the block claimed from the sequence file: [next, limit)
+static mutex    sequenceMutex;
+static uint64_t sequenceNext  = 0;
+static uint64_t sequenceLimit = 0;
+
+// Background compactor state: paths waiting to be compacted and the worker draining them
+static mutex            compactionMutex;
+static set<string>      pendingCompactions;
+static thread           compactionThread;
+static atomic<bool>     compactionRunning(false);
+
+/**
+ * Joins the compactor on shutdown so a rewrite is never cut off half-way.
+ */
+struct CompactionJoiner
+{
+    ~CompactionJoiner()
+    {
+        Reservation::waitForCompaction();
+    }
+};
+static CompactionJoiner compactionJoiner;
+
+/**
+ * Returns true if the stored reservation record has been tombstoned by a cancellation.
+ */
+template <typename Json>
+static bool isTombstoned(const Json& rj)
+{
+    return rj.contains("isCanceled") && rj.at("isCanceled").template get<bool>();
+}
+
+/**
+ * Reads a reservation file into a JSON object; leaves it empty if the file is missing.
+ */
+static bool readReservationFile(const string& path, json& out)
+{
+    ifstream inFile(path);
+    if (!inFile.is_open())
+        return false;
+
+    if (Metrics::enabled())
+    {
+        inFile.seekg(0, ios::end);
+        METRIC_BYTES_READ(static_cast<uint64_t>(inFile.tellg()));
+        inFile.seekg(0);
+    }
+
+    MEMORY_TAG(Json);
+    inFile >> out;
+    return true;
+}
+
+/**
+ * Writes a reservation file through a temporary file so readers never see a partial rewrite.
+ */
+static bool writeReservationFile(const string& path, const json& allRes)
+{
+    MEMORY_TAG(Json);
+    string tmpPath = path + ".tmp";
+    {
+        ofstream outFile(tmpPath);
+        if (!outFile.is_open())
+            return false;
+        outFile << setw(4) << allRes << endl;
+        METRIC_BYTES_WRITTEN(static_cast<uint64_t>(outFile.tellp()));
+    }
+    return rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * Marks the given reservations as canceled inside one file, collecting each canceled
+ * record, and reports the file's tombstone ratio.
+ */
+static bool tombstoneInFile(const string& path, const unordered_set<string>& reservationIDs,
+                            double& deadRatio, vector<json>& cancelled, bool onlyIfUnpaid)
+{
+    json allRes;
+    deadRatio = 0.0;
+    if (!readReservationFile(path, allRes))
+        return false;
+
+    bool   found = false;
+    size_t total = 0, dead = 0;
+    for (auto& user : allRes.items())
+    {
+        for (auto& rj : user.value())
+        {
+            if (!isTombstoned(rj) && reservationIDs.count(rj.value("reservationID", "")) &&
+                !(onlyIfUnpaid && rj.value("isPaid", false)))
+            {
+                rj["isCanceled"] = true;
+                cancelled.push_back(rj);
+                found = true;
+            }
+            ++total;
+            if (isTombstoned(rj))
+                ++dead;
+        }
+    }
+
+    if (found && !writeReservationFile(path, allRes))
+    {
+        cerr << "Error: Unable to record cancellation in " << path << ".\n";
+        cancelled.clear();
+        return false;
+    }
+
+    if (total > 0)
+        deadRatio = static_cast<double>(dead) / static_cast<double>(total);
+    return found;
+}
+
+/**
+ * Marks the given unpaid reservations as paid inside one file, optionally only those of
+ * one payment method, collecting each settled record as it stood before; returns how
+ * many changed.
+ */
+static size_t markPaidInFile(const string& path, const unordered_set<string>& reservationIDs,
+                             const string& paymentMethod, vector<json>* settledRecords = nullptr)
+{
+    json allRes;
+    if (!readReservationFile(path, allRes))
+        return 0;
+
+    size_t settled = 0;
+    for (auto& user : allRes.items())
+    {
+        for (auto& rj : user.value())
+        {
+            if (!isTombstoned(rj) && !rj.value("isPaid", false) &&
+                reservationIDs.count(rj.value("reservationID", "")) &&
+                (paymentMethod.empty() || rj.value("paymentMethod", "") == paymentMethod))
+            {
+                if (settledRecords)
+                    settledRecords->push_back(rj);
+                rj["isPaid"] = true;
+                rj.erase("holdExpiresAt");
+                ++settled;
+            }
+        }
+    }
+
+    if (settled > 0 && !writeReservationFile(path, allRes))
+    {
+        cerr << "Error: Unable to record payment in " << path << ".\n";
+        if (settledRecords)
+            settledRecords->clear();
+        return 0;
+    }
+    return settled;
+}
+
+/**
+ * Drops tombstoned records (and users left without reservations) from one file.
+ */
+static void compactFile(const string& path)
+{
+    lock_guard<mutex> lock(reservationFileMutex);
+
+    json allRes;
+    if (!readReservationFile(path, allRes))
+        return;
+
+    json compacted = json::object();
+    for (auto const& user : allRes.items())
+    {
+        json live = json::array();
+        for (auto const& rj : user.value())
+            if (!isTombstoned(rj))
+                live.push_back(rj);
+
+        if (!live.empty())
+            compacted[user.key()] = live;
+    }
+
+    if (!writeReservationFile(path, compacted))
+        cerr << "Error: Unable to compact " << path << ".\n";
+}
+
+/**
+ * Queues a file for compaction and starts the background worker if it is idle.
+ */
+static void scheduleCompaction(const string& path)
+{
+    lock_guard<mutex> lock(compactionMutex);
+    pendingCompactions.insert(path);
+
+    if (compactionRunning)
+        return;
+
+    if (compactionThread.joinable())
+        compactionThread.join();
+
+    compactionRunning = true;
+    compactionThread  = thread([]()
+    {
+        for (;;)
+        {
+            string path;
+            {
+                lock_guard<mutex> lock(compactionMutex);
+                if (pendingCompactions.empty())
+                {
+                    compactionRunning = false;
+                    return;
+                }
+                path = *pendingCompactions.begin();
+                pendingCompactions.erase(pendingCompactions.begin());
+            }
+            compactFile(path);
+        }
+    });
+}
+
 /**
- * Constructor: Initializes a Reservation with full details (unpaid by default).
+ * Constructor: Initializes a Reservation with full details (unpaid by default). The
+ * arguments are taken by value and moved in, so temporaries are never copied.
  */
 Reservation::Reservation(string reservationID,
                          string passengerName,
@@ -29,13 +274,15 @@ Reservation::Reservation(string reservationID,
                          string seatNumber,
                          string paymentMethod,
                          string paymentDetails)
-    : reservationID(reservationID),
-      passengerName(passengerName),
-      flight(flight),
-      seatNumber(seatNumber),
-      paymentMethod(paymentMethod),
-      paymentDetails(paymentDetails),
-      isPaid(false)
+    : reservationID(move(reservationID)),
+      passengerName(move(passengerName)),
+      flight(move(flight)),
+      seatNumber(move(seatNumber)),
+      paymentMethod(move(paymentMethod)),
+      paymentDetails(move(paymentDetails)),
+      isPaid(false),
+      holdExpiresAt(0),
+      fareClass("")
 {}
 
 /**
@@ -48,13 +295,36 @@ Reservation::Reservation(void)
       seatNumber(""),
       paymentMethod(""),
       paymentDetails(""),
-      isPaid(false)
+      isPaid(false),
+      holdExpiresAt(0),
+      fareClass("")
 {}
 
+/**
+ * Assigns into the existing strings, so a buffer large enough already is reused.
+ */
+void Reservation::assign(const string& reservationID,
+                         const string& passengerName,
+                         shared_ptr<Flight> flight,
+                         const string& seatNumber,
+                         const string& paymentMethod,
+                         const string& paymentDetails)
+{
+    this->reservationID  = reservationID;
+    this->passengerName  = passengerName;
+    this->flight         = move(flight);
+    this->seatNumber     = seatNumber;
+    this->paymentMethod  = paymentMethod;
+    this->paymentDetails = paymentDetails;
+    isPaid               = false;
+    holdExpiresAt        = 0;
+    fareClass.clear();
+}
+
 /**
  * Getter: Returns the reservation ID.
  */
-string Reservation::getReservationID(void) const
+const string& Reservation::getReservationID(void) const
 {
     return reservationID;
 }
@@ -62,7 +332,7 @@ string Reservation::getReservationID(void) const
 /**
  * Getter: Returns the passenger name.
  */
-string Reservation::getPassengerName(void) const
+const string& Reservation::getPassengerName(void) const
 {
     return passengerName;
 }
@@ -70,7 +340,7 @@ string Reservation::getPassengerName(void) const
 /**
  * Getter: Returns the associated Flight pointer.
  */
-shared_ptr<Flight> Reservation::getFlight(void) const
+const shared_ptr<Flight>& Reservation::getFlight(void) const
 {
     return flight;
 }
@@ -78,7 +348,7 @@ shared_ptr<Flight> Reservation::getFlight(void) const
 /**
  * Getter: Returns the seat number.
  */
-string Reservation::getSeatNumber(void) const
+const string& Reservation::getSeatNumber(void) const
 {
     return seatNumber;
 }
@@ -86,7 +356,7 @@ string Reservation::getSeatNumber(void) const
 /**
  * Getter: Returns the payment method.
  */
-string Reservation::getPaymentMethod(void) const
+const string& Reservation::getPaymentMethod(void) const
 {
     return paymentMethod;
 }
@@ -94,7 +364,7 @@ string Reservation::getPaymentMethod(void) const
 /**
  * Getter: Returns the payment details.
  */
-string Reservation::getPaymentDetails(void) const
+const string& Reservation::getPaymentDetails(void) const
 {
     return paymentDetails;
 }
@@ -104,7 +374,7 @@ string Reservation::getPaymentDetails(void) const
  */
 json Reservation::toJson(void) const
 {
-    return json{
+    json j{
         {"reservationID",   reservationID},
         {"passengerName",   passengerName},
         {"flight",          flight->toJson()},
@@ -113,29 +383,56 @@ json Reservation::toJson(void) const
         {"paymentDetails",  paymentDetails},
         {"isPaid",          isPaid}
     };
+    if (holdExpiresAt > 0)
+        j["holdExpiresAt"] = holdExpiresAt;
+    if (!fareClass.empty())
+        j["fareClass"] = fareClass;
+    return j;
 }
 
 /**
  * Deserializes a JSON object into a Reservation.
  */
-Reservation Reservation::fromJson(const json& j)
+template <typename Json>
+Reservation Reservation::fromJsonOf(const Json& j, shared_ptr<Flight> flight)
 {
-    auto flightPtr = make_shared<Flight>(Flight::fromJson(j.at("flight")));
     Reservation res(
-        j.at("reservationID").get<string>(),
-        j.at("passengerName").get<string>(),
-        flightPtr,
-        j.at("seatNumber").get<string>(),
-        j.at("paymentMethod").get<string>(),
-        j.at("paymentDetails").get<string>()
+        j.at("reservationID").template get<string>(),
+        j.at("passengerName").template get<string>(),
+        move(flight),
+        j.at("seatNumber").template get<string>(),
+        j.at("paymentMethod").template get<string>(),
+        j.at("paymentDetails").template get<string>()
     );
 
+    // Older card payments stored the full card number and CVV here; keep the masked number
+    if (!res.paymentMethod.empty() &&
+        all_of(res.paymentMethod.begin(), res.paymentMethod.end(), ::isdigit))
+    {
+        res.paymentDetails = CardVault::maskCardNumber(res.paymentMethod);
+        res.paymentMethod  = "Card";
+    }
+
     if (j.contains("isPaid"))
-        res.setIsPaid(j.at("isPaid").get<bool>());
+        res.setIsPaid(j.at("isPaid").template get<bool>());
+    if (j.contains("holdExpiresAt"))
+        res.setHoldExpiresAt(j.at("holdExpiresAt").template get<int64_t>());
+    if (j.contains("fareClass"))
+        res.setFareClass(j.at("fareClass").template get<string>());
 
     return res;
 }
 
+Reservation Reservation::fromJson(const json& j)
+{
+    return fromJsonOf(j, make_shared<Flight>(Flight::fromJson(j.at("flight"))));
+}
+
+Reservation Reservation::fromJson(const ArenaJson& j, const SharedArenaAllocator<Flight>& allocator)
+{
+    return fromJsonOf(j, allocate_shared<Flight>(allocator, Flight::fromJson(j.at("flight"))));
+}
+
 /**
  * Displays reservation details.
  */
@@ -145,8 +442,12 @@ void Reservation::displayReservation(void) const
          << "Reservation ID : " << reservationID << '\n'
          << "Passenger Name : " << passengerName << '\n'
          << "Seat Number    : " << seatNumber   << '\n'
-         << "Payment Method : " << paymentMethod << '\n'
-         << "Flight Details :\n";
+         << "Payment Method : " << paymentMethod << '\n';
+    if (!fareClass.empty())
+        cout << "Fare Class     : " << fareClass << '\n';
+    if (isPaymentPending())
+        cout << "Payment Status : Pending\n";
+    cout << "Flight Details :\n";
     flight->displayFlightInfo();
 }
 
@@ -160,8 +461,13 @@ void Reservation::displayHoldingReservation(void) const
          << "Passenger Name : " << passengerName << '\n'
          << "Seat Number    : " << seatNumber   << '\n'
          << "Payment Method : " << paymentMethod << '\n'
-         << "Payment on hold. Please complete payment at airport.\n"
-         << "Flight Details :\n";
+         << "Payment on hold. Please complete payment at airport.\n";
+    if (holdExpiresAt > 0)
+    {
+        time_t expiry = static_cast<time_t>(holdExpiresAt);
+        cout << "Hold Expires   : " << put_time(localtime(&expiry), "%Y-%m-%d %H:%M") << '\n';
+    }
+    cout << "Flight Details :\n";
     flight->displayFlightInfo();
 }
 
@@ -187,10 +493,8 @@ void Reservation::printBoardingPass(void) const
  */
 void Reservation::addReservation(const Reservation& newReservation)
 {
-    auto resList = loadReservations();
-    resList.push_back(make_shared<Reservation>(newReservation));
-    saveReservations(resList);
-    cout << "Reservation added successfully!\n";
+    if (saveReservations({ make_shared<Reservation>(newReservation) }))
+        cout << "Reservation added successfully!\n";
 }
 
 /**
@@ -198,167 +502,556 @@ void Reservation::addReservation(const Reservation& newReservation)
  */
 void Reservation::addBookingAgentReservation(const Reservation& newReservation)
 {
-    auto resList = loadBookingAgentReservations();
-    resList.push_back(make_shared<Reservation>(newReservation));
-    saveBookingAgentReservations(resList);
-    cout << "Reservation added successfully!\n";
+    if (saveBookingAgentReservations({ make_shared<Reservation>(newReservation) }))
+        cout << "Reservation added successfully!\n";
 }
 
 /**
- * Removes a reservation by ID and saves updated list.
+ * Cancels a reservation by ID and reports the outcome.
  */
 void Reservation::removeReservation(const string& reservationID)
 {
-    auto resList = loadReservations();
-    auto it = find_if(resList.begin(), resList.end(),
-                      [&](auto const& r){ return r->getReservationID() == reservationID; });
-
-    if (it != resList.end())
-    {
-        resList.erase(it);
-        saveReservations(resList);
+    if (cancelReservation(reservationID))
         cout << "Reservation " << reservationID << " removed successfully!\n";
-    }
     else
-    {
         cout << "Reservation ID " << reservationID << " not found!\n";
-    }
 }
 
 /**
- * Saves a list of reservations to the main file, avoiding duplicates.
+ * Tombstones a reservation in the main and booking agent files. Loads skip tombstoned
+ * records, so the seat is free again as soon as this returns; the compactor reclaims
+ * the space later once enough of a file is dead.
  */
-void Reservation::saveReservations(const vector<shared_ptr<Reservation>>& reservations)
+bool Reservation::cancelReservation(const string& reservationID)
 {
-    json allRes;
-    ifstream inFile(PATH_OF_RESERVATION_DATA_BASE);
-    if (inFile.is_open())
+    return cancelInFiles({ reservationID }, false) > 0;
+}
+
+/**
+ * Cancels a lapsed cash hold unless it was paid in the meantime.
+ */
+bool Reservation::expireHold(const string& reservationID)
+{
+    return cancelInFiles({ reservationID }, true) > 0;
+}
+
+/**
+ * Cancels a batch of unpaid reservations with one rewrite per file.
+ */
+size_t Reservation::expireHolds(const vector<string>& reservationIDs)
+{
+    return cancelInFiles(reservationIDs, true);
+}
+
+/**
+ * Settles the batch with one rewrite per file; the main file holds every booking, so
+ * its count is the one reported.
+ */
+size_t Reservation::confirmPayments(const vector<string>& reservationIDs, const string& paymentMethod,
+                                    vector<string>* settledIDs)
+{
+    METRIC_SCOPE("Reservation::confirmPayments");
+    SalesLedger::load();
+    unordered_set<string> ids(reservationIDs.begin(), reservationIDs.end());
+    size_t       settled = 0;
+    vector<json> unpaid;
     {
-        inFile >> allRes;
-        inFile.close();
+        lock_guard<mutex> lock(reservationFileMutex);
+        settled = markPaidInFile(PATH_OF_RESERVATION_DATA_BASE, ids, paymentMethod, &unpaid);
+        markPaidInFile(PATH_OF_BOOKING_AGENT_RESERVATION_DATA_BASE, ids, paymentMethod);
     }
 
-    for (auto const& res : reservations)
+    vector<shared_ptr<Reservation>> before, after;
+    for (auto const& rj : unpaid)
     {
-        auto& userArr = allRes[res->getPassengerName()];
-        bool exists = false;
-        for (auto const& e : userArr)
+        before.push_back(make_shared<Reservation>(Reservation::fromJson(rj)));
+        after.push_back(make_shared<Reservation>(*before.back()));
+        after.back()->setIsPaid(true);
+        if (settledIDs)
+            settledIDs->push_back(before.back()->getReservationID());
+    }
+    SalesLedger::recordChanges(before, after);
+
+    for (auto const& id : reservationIDs)
+        SeatHold::clearHold(id);
+    return settled;
+}
+
+/**
+ * Highest number of a sequence-issued ID in either file, tombstones included; seeds the
+ * sequence when its file is missing. IDs of the old letter-and-digits format are shorter
+ * than any sequence ID, so they can never be mistaken for one.
+ */
+static uint64_t highestIssuedNumber(void)
+{
+    uint64_t highest = 0;
+    for (const char* path : { PATH_OF_RESERVATION_DATA_BASE, PATH_OF_BOOKING_AGENT_RESERVATION_DATA_BASE })
+    {
+        json allRes;
+        if (!readReservationFile(path, allRes))
+            continue;
+        for (auto const& user : allRes.items())
         {
-            if (e["reservationID"] == res->getReservationID())
+            for (auto const& rj : user.value())
             {
-                exists = true;
-                break;
+                const string id = rj.value("reservationID", "");
+                if (id.size() >= RESERVATION_ID_DIGITS + 1 && id[0] == 'R' &&
+                    all_of(id.begin() + 1, id.end(), ::isdigit))
+                    highest = max<uint64_t>(highest, strtoull(id.c_str() + 1, nullptr, 10));
             }
         }
-        if (!exists)
-            userArr.push_back(res->toJson());
     }
+    return highest;
+}
 
-    ofstream outFile(PATH_OF_RESERVATION_DATA_BASE);
-    if (!outFile.is_open())
+/**
+ * Numbers are handed out from a block already recorded as used in the sequence file, so
+ * a crash can skip numbers but never reissue one.
+ */
+string Reservation::nextReservationID(void)
+{
+    lock_guard<mutex> lock(sequenceMutex);
+    if (sequenceNext == sequenceLimit)
     {
-        cerr << "Error: Unable to save reservations.\n";
-        return;
+        uint64_t next = max<uint64_t>(sequenceNext, 1);
+        ifstream inFile(PATH_OF_RESERVATION_SEQUENCE_DATA_BASE);
+        json     stored = inFile.is_open() ? json::parse(inFile, nullptr, false) : json();
+        if (stored.is_object() && stored.contains("next") && stored.at("next").is_number_unsigned())
+        {
+            next = max(next, stored.at("next").get<uint64_t>());
+        }
+        else
+        {
+            lock_guard<mutex> fileLock(reservationFileMutex);
+            next = max(next, highestIssuedNumber() + 1);
+        }
+
+        if (!writeReservationFile(PATH_OF_RESERVATION_SEQUENCE_DATA_BASE,
+                                  json{ {"next", next + RESERVATION_ID_BLOCK} }))
+        {
+            cerr << "Error: Unable to advance the reservation sequence.\n";
+            return "";
+        }
+        sequenceNext  = next;
+        sequenceLimit = next + RESERVATION_ID_BLOCK;
+    }
+
+    char id[32];
+    snprintf(id, sizeof(id), "R%0*llu", RESERVATION_ID_DIGITS,
+             static_cast<unsigned long long>(sequenceNext++));
+    return id;
+}
+
+/**
+ * Shared body of cancelReservation, expireHold and expireHolds.
+ */
+size_t Reservation::cancelInFiles(const vector<string>& reservationIDs, bool onlyIfUnpaid)
+{
+    METRIC_SCOPE("Reservation::cancelInFiles");
+    SalesLedger::load();
+    unordered_set<string> ids(reservationIDs.begin(), reservationIDs.end());
+    bool         found = false;
+    double       mainRatio = 0.0, agentRatio = 0.0;
+    vector<json> inMainFile, inAgentFile;
+    {
+        lock_guard<mutex> lock(reservationFileMutex);
+        found |= tombstoneInFile(PATH_OF_RESERVATION_DATA_BASE, ids, mainRatio,
+                                 inMainFile, onlyIfUnpaid);
+        found |= tombstoneInFile(PATH_OF_BOOKING_AGENT_RESERVATION_DATA_BASE, ids,
+                                 agentRatio, inAgentFile, onlyIfUnpaid);
     }
-    outFile << setw(4) << allRes << endl;
+
+    if (found)
+    {
+        for (auto const& id : reservationIDs)
+            SeatHold::clearHold(id);
+    }
+
+    // The main file holds every booking, so only a cancellation there frees a seat
+    vector<shared_ptr<Reservation>> cancelledReservations;
+    for (auto const& cancelled : inMainFile)
+    {
+        const string flightNumber = cancelled.at("flight").at("flightNumber").get<string>();
+        SeatInventory::releaseSeat(flightNumber, cancelled.value("fareClass", string()));
+        SeatMap::releaseSeat(flightNumber, cancelled.at("seatNumber").get<string>());
+        cancelledReservations.push_back(make_shared<Reservation>(Reservation::fromJson(cancelled)));
+    }
+    SalesLedger::recordChanges(cancelledReservations, {});
+
+    if (mainRatio > RESERVATION_COMPACTION_THRESHOLD)
+        scheduleCompaction(PATH_OF_RESERVATION_DATA_BASE);
+    if (agentRatio > RESERVATION_COMPACTION_THRESHOLD)
+        scheduleCompaction(PATH_OF_BOOKING_AGENT_RESERVATION_DATA_BASE);
+
+    return max(inMainFile.size(), inAgentFile.size());
 }
 
 /**
- * Saves a list of reservations to the booking agent file, avoiding duplicates.
+ * Synchronously compacts both reservation files.
  */
-void Reservation::saveBookingAgentReservations(const vector<shared_ptr<Reservation>>& reservations)
+void Reservation::compactReservations(void)
 {
+    METRIC_SCOPE("Reservation::compactReservations");
+    compactFile(PATH_OF_RESERVATION_DATA_BASE);
+    compactFile(PATH_OF_BOOKING_AGENT_RESERVATION_DATA_BASE);
+}
+
+/**
+ * Waits for the background compactor to drain its queue.
+ */
+void Reservation::waitForCompaction(void)
+{
+    thread worker;
+    {
+        lock_guard<mutex> lock(compactionMutex);
+        worker = move(compactionThread);
+    }
+    if (worker.joinable())
+        worker.join();
+}
+
+/**
+ * Upserts reservations into a file by ID: new records are appended and live records
+ * updated in place. Every ID in the file is indexed first, tombstones included, and the
+ * whole write is refused if any record would take an ID that was canceled or belongs to
+ * another passenger, so a canceled record is never resurrected or shadowed. An update
+ * never takes back a payment the file already records; callers hold copies loaded
+ * before a settlement may have landed. If asked, records that changed are collected:
+ * their old versions in removed, their new versions (and new records) in added.
+ */
+static bool mergeIntoFile(const string& path, const vector<shared_ptr<Reservation>>& reservations,
+                          vector<shared_ptr<Reservation>>* removed = nullptr,
+                          vector<shared_ptr<Reservation>>* added = nullptr)
+{
+    lock_guard<mutex> lock(reservationFileMutex);
+
     json allRes;
-    ifstream inFile(PATH_OF_BOOKING_AGENT_RESERVATION_DATA_BASE);
-    if (inFile.is_open())
+    readReservationFile(path, allRes);
+    if (!allRes.is_object())
+        allRes = json::object();
+
+    // ID -> (passenger, position in that passenger's array)
+    unordered_map<string, pair<string, size_t>> positions;
+    for (auto const& user : allRes.items())
+        for (size_t i = 0; i < user.value().size(); ++i)
+            positions[user.value()[i].value("reservationID", "")] = { user.key(), i };
+
+    for (auto const& res : reservations)
     {
-        inFile >> allRes;
-        inFile.close();
+        auto it = positions.find(res->getReservationID());
+        if (it == positions.end())
+            continue;
+        if (it->second.first != res->getPassengerName() ||
+            isTombstoned(allRes[it->second.first][it->second.second]))
+        {
+            cerr << "Error: Reservation ID " << res->getReservationID()
+                 << " is already taken in " << path << ".\n";
+            return false;
+        }
     }
 
+    vector<shared_ptr<Reservation>> oldVersions, newVersions;
     for (auto const& res : reservations)
     {
         auto& userArr = allRes[res->getPassengerName()];
-        bool exists = false;
-        for (auto const& e : userArr)
+        auto  it      = positions.find(res->getReservationID());
+        if (it == positions.end())
         {
-            if (e["reservationID"] == res->getReservationID())
-            {
-                exists = true;
-                break;
-            }
-        }
-        if (!exists)
+            positions.emplace(res->getReservationID(),
+                              make_pair(res->getPassengerName(), userArr.size()));
             userArr.push_back(res->toJson());
+            newVersions.push_back(res);
+            continue;
+        }
+
+        json& stored  = userArr[it->second.second];
+        json  updated = res->toJson();
+        if (stored.value("isPaid", false) && !updated.value("isPaid", false))
+        {
+            updated["isPaid"] = true;
+            updated.erase("holdExpiresAt");
+        }
+        if (stored == updated)
+            continue;
+
+        if (removed && added)
+        {
+            oldVersions.push_back(make_shared<Reservation>(Reservation::fromJson(stored)));
+            newVersions.push_back(make_shared<Reservation>(Reservation::fromJson(updated)));
+        }
+        stored = move(updated);
     }
 
-    ofstream outFile(PATH_OF_BOOKING_AGENT_RESERVATION_DATA_BASE);
-    if (!outFile.is_open())
+    if (!writeReservationFile(path, allRes))
+        return false;
+
+    if (removed && added)
     {
-        cerr << "Error: Unable to save booking agent reservations.\n";
-        return;
+        *removed = move(oldVersions);
+        *added   = move(newVersions);
     }
-    outFile << setw(4) << allRes << endl;
+    return true;
 }
 
 /**
- * Loads all reservations from the main file into a vector.
+ * Upserts reservations into the main file and applies the change to the sales ledger.
  */
-vector<shared_ptr<Reservation>> Reservation::loadReservations(void)
+bool Reservation::saveReservations(const vector<shared_ptr<Reservation>>& reservations)
 {
-    vector<shared_ptr<Reservation>> list;
-    ifstream file(PATH_OF_RESERVATION_DATA_BASE);
-    if (!file.is_open())
+    METRIC_SCOPE("Reservation::saveReservations");
+    SalesLedger::load();
+    vector<shared_ptr<Reservation>> removed, added;
+    if (!mergeIntoFile(PATH_OF_RESERVATION_DATA_BASE, reservations, &removed, &added))
     {
-        cerr << "No reservation data found. Starting fresh.\n";
-        return list;
+        cerr << "Error: Unable to save reservations.\n";
+        return false;
     }
+    SalesLedger::recordChanges(removed, added);
+    return true;
+}
+
+/**
+ * Upserts reservations into the booking agent file.
+ */
+bool Reservation::saveBookingAgentReservations(const vector<shared_ptr<Reservation>>& reservations)
+{
+    METRIC_SCOPE("Reservation::saveBookingAgentReservations");
+    if (mergeIntoFile(PATH_OF_BOOKING_AGENT_RESERVATION_DATA_BASE, reservations))
+        return true;
 
-    json j; file >> j; file.close();
+    cerr << "Error: Unable to save booking agent reservations.\n";
+    return false;
+}
 
-    for (auto const& user : j.items())
+/**
+ * Counts the records of a parsed file (or part of one), tombstones included.
+ */
+static size_t recordCount(const ArenaJson& j)
+{
+    size_t records = 0;
+    for (auto const& user : j)
+        records += user.size();
+    return records;
+}
+
+/**
+ * Appends the live reservations of one user to a list, building them and their flights
+ * in the record arena, which is released with the last reservation built in it.
+ */
+static void appendReservations(const ArenaJson& user, const shared_ptr<LoadArena>& recordArena,
+                               vector<shared_ptr<Reservation>>& list)
+{
+    SharedArenaAllocator<Reservation> allocator(recordArena);
+    SharedArenaAllocator<Flight>      flightAllocator(recordArena);
+    for (auto const& rj : user)
     {
-        for (auto const& rj : user.value())
+        if (isTombstoned(rj))
+            continue;
+
+        list.push_back(allocate_shared<Reservation>(allocator, Reservation::fromJson(rj, flightAllocator)));
+    }
+}
+
+/**
+ * Loads the live reservations of one file. The file text and its parse tree live in an
+ * arena dropped on return.
+ */
+static vector<shared_ptr<Reservation>> loadReservationFile(const string& path, const char* missingMessage)
+{
+    vector<shared_ptr<Reservation>> list;
+    auto parseArena = LoadArena::forFile(path);
+    LoadArenaScope scope(*parseArena);
+    ArenaJson j;
+    {
+        lock_guard<mutex> lock(reservationFileMutex);
+        string_view text;
+        if (!parseArena->readFile(path, text))
         {
-            auto res = make_shared<Reservation>(fromJson(rj));
-            if (rj.contains("isPaid"))
-                res->setIsPaid(rj["isPaid"].get<bool>());
-            list.push_back(res);
+            cerr << missingMessage;
+            return list;
         }
+        METRIC_BYTES_READ(text.size());
+        j = ArenaJson::parse(text.begin(), text.end());
     }
 
+    size_t records     = recordCount(j);
+    auto   recordArena = make_shared<LoadArena>(records * RESERVATION_ARENA_BYTES_PER_RECORD);
+    list.reserve(records);
+    for (auto const& user : j)
+        appendReservations(user, recordArena, list);
+
+    METRIC_RECORDS(list.size());
     return list;
 }
 
 /**
- * Loads all reservations from the booking agent file into a vector.
+ * Cuts the members of a top-level JSON object into about `parts` runs of whole members,
+ * of similar size, at the commas between users. Strings are skipped so braces and commas
+ * inside them do not count. Returns false if the text is not a complete object.
  */
-vector<shared_ptr<Reservation>> Reservation::loadBookingAgentReservations(void)
+static bool splitUsers(string_view text, size_t parts, vector<string_view>& chunks)
 {
-    vector<shared_ptr<Reservation>> list;
-    ifstream file(PATH_OF_BOOKING_AGENT_RESERVATION_DATA_BASE);
-    if (!file.is_open())
+    size_t open = text.find_first_not_of(" \t\r\n");
+    if (open == string_view::npos || text[open] != '{')
+        return false;
+
+    vector<size_t> commas;
+    size_t close    = string_view::npos;
+    int    depth    = 0;
+    bool   inString = false, escaped = false;
+    for (size_t i = open; i < text.size() && close == string_view::npos; ++i)
+    {
+        char c = text[i];
+        if (inString)
+        {
+            if (escaped)
+                escaped = false;
+            else if (c == '\\')
+                escaped = true;
+            else if (c == '"')
+                inString = false;
+            continue;
+        }
+
+        switch (c)
+        {
+        case '"':
+            inString = true;
+            break;
+        case '{':
+        case '[':
+            ++depth;
+            break;
+        case '}':
+        case ']':
+            if (--depth == 0)
+                close = i;
+            break;
+        case ',':
+            if (depth == 1)
+                commas.push_back(i);
+            break;
+        }
+    }
+    if (close == string_view::npos)
+        return false;
+
+    size_t begin = open + 1, span = close - begin, next = 0;
+    for (size_t k = 1; k < parts; ++k)
     {
-        cerr << "No booking agent reservation data found. Starting fresh.\n";
-        return list;
+        size_t target = open + 1 + span * k / parts;
+        while (next < commas.size() && commas[next] < target)
+            ++next;
+        if (next == commas.size())
+            break;
+        chunks.push_back(text.substr(begin, commas[next] - begin));
+        begin = commas[next++] + 1;
     }
+    chunks.push_back(text.substr(begin, close - begin));
+    return true;
+}
 
-    json j; file >> j; file.close();
+/**
+ * Loads all reservations from the main file into a vector.
+ */
+vector<shared_ptr<Reservation>> Reservation::loadReservations(void)
+{
+    METRIC_SCOPE("Reservation::loadReservations");
+    MEMORY_TAG(Reservations);
+    return loadReservationFile(PATH_OF_RESERVATION_DATA_BASE, "No reservation data found. Starting fresh.\n");
+}
 
-    for (auto const& user : j.items())
+/**
+ * Each worker parses its run of users as an object of its own, in its own arenas, and
+ * keeps the users apart; the users are then put back in key order, which is the order
+ * the serial load walks them in. A file that cannot be split is loaded serially.
+ */
+vector<shared_ptr<Reservation>> Reservation::loadReservations(ThreadPool& pool)
+{
+    METRIC_SCOPE("Reservation::loadReservationsParallel");
+    MEMORY_TAG(Reservations);
+
+    auto textArena = LoadArena::forFile(PATH_OF_RESERVATION_DATA_BASE);
+    string_view text;
     {
-        for (auto const& rj : user.value())
+        lock_guard<mutex> lock(reservationFileMutex);
+        if (!textArena->readFile(PATH_OF_RESERVATION_DATA_BASE, text))
         {
-            auto res = make_shared<Reservation>(fromJson(rj));
-            if (rj.contains("isPaid"))
-                res->setIsPaid(rj["isPaid"].get<bool>());
-            list.push_back(res);
+            cerr << "No reservation data found. Starting fresh.\n";
+            return {};
         }
     }
+    METRIC_BYTES_READ(text.size());
+
+    vector<string_view> chunks;
+    if (pool.size() < 2 || !splitUsers(text, pool.size(), chunks) || chunks.size() < 2)
+        return loadReservationFile(PATH_OF_RESERVATION_DATA_BASE, "No reservation data found. Starting fresh.\n");
+
+    using UserReservations = pair<string, vector<shared_ptr<Reservation>>>;
+    vector<vector<UserReservations>> parts(chunks.size());
+    vector<function<void()>> tasks;
+    for (size_t c = 0; c < chunks.size(); ++c)
+    {
+        tasks.push_back([&chunks, &parts, c]()
+        {
+            MEMORY_TAG(Reservations);
+            LoadArena parseArena(chunks[c].size() * LOAD_ARENA_BYTES_PER_FILE_BYTE);
+            LoadArenaScope scope(parseArena);
+
+            // The run, braced back into an object, in arena memory
+            size_t size  = chunks[c].size() + 2;
+            char*  whole = static_cast<char*>(parseArena.resource()->allocate(size, 1));
+            whole[0] = '{';
+            memcpy(whole + 1, chunks[c].data(), chunks[c].size());
+            whole[size - 1] = '}';
 
+            ArenaJson j = ArenaJson::parse(whole, whole + size);
+            auto recordArena = make_shared<LoadArena>(recordCount(j) * RESERVATION_ARENA_BYTES_PER_RECORD);
+            for (auto const& user : j.items())
+            {
+                parts[c].emplace_back(user.key(), vector<shared_ptr<Reservation>>());
+                appendReservations(user.value(), recordArena, parts[c].back().second);
+            }
+        });
+    }
+    pool.runAll(move(tasks));
+
+    vector<UserReservations*> users;
+    size_t records = 0;
+    for (auto& part : parts)
+    {
+        for (auto& user : part)
+        {
+            users.push_back(&user);
+            records += user.second.size();
+        }
+    }
+    stable_sort(users.begin(), users.end(), [](const UserReservations* a, const UserReservations* b)
+    {
+        return a->first < b->first;
+    });
+
+    vector<shared_ptr<Reservation>> list;
+    list.reserve(records);
+    for (auto* user : users)
+        for (auto& res : user->second)
+            list.push_back(move(res));
+
+    METRIC_RECORDS(list.size());
     return list;
 }
 
+/**
+ * Loads all reservations from the booking agent file into a vector.
+ */
+vector<shared_ptr<Reservation>> Reservation::loadBookingAgentReservations(void)
+{
+    METRIC_SCOPE("Reservation::loadBookingAgentReservations");
+    MEMORY_TAG(Reservations);
+    return loadReservationFile(PATH_OF_BOOKING_AGENT_RESERVATION_DATA_BASE,
+                               "No booking agent reservation data found. Starting fresh.\n");
+}
+
 /**
  * Setter: Updates the payment status.
  */
@@ -367,6 +1060,14 @@ void Reservation::setIsPaid(bool status)
     isPaid = status;
 }
 
+/**
+ * A card payment that the pipeline has not settled yet.
+ */
+bool Reservation::isPaymentPending(void) const
+{
+    return !isPaid && paymentMethod == "Card";
+}
+
 /**
  * Getter: Returns the payment status.
  */
@@ -375,6 +1076,46 @@ bool Reservation::getIsPaid(void) const
     return isPaid;
 }
 
+/**
+ * Setter: Records when the unpaid hold lapses (0 clears it).
+ */
+void Reservation::setHoldExpiresAt(int64_t epochSeconds)
+{
+    holdExpiresAt = epochSeconds;
+}
+
+/**
+ * Getter: Returns the hold expiry in epoch seconds, or 0 if there is none.
+ */
+int64_t Reservation::getHoldExpiresAt(void) const
+{
+    return holdExpiresAt;
+}
+
+/**
+ * Setter: Assigns the seat, e.g. when an overbooked passenger is seated at check-in.
+ */
+void Reservation::setSeatNumber(const string& seat)
+{
+    seatNumber = seat;
+}
+
+/**
+ * Setter: Records the fare bucket the seat was sold in.
+ */
+void Reservation::setFareClass(const string& code)
+{
+    fareClass = code;
+}
+
+/**
+ * Getter: Returns the fare bucket code, empty for legacy bookings.
+ */
+const string& Reservation::getFareClass(void) const
+{
+    return fareClass;
+}
+
 /**
  * Setter: Updates the payment method.
  */
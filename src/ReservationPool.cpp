@@ -0,0 +1,200 @@
+/******************************************************************************************
+ * MODULE NAME    : Reservation Pool Module
+ * FILE           : ReservationPool.cpp
+ * DESCRIPTION    : Implements the idle lists, the control-block allocator and the
+ *                  recycling deleters behind the reservation pool.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/ReservationPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Fixed-capacity stack of idle items; pushing and popping never allocate.
+ */
+template <typename T>
+struct IdleList
+{
+    mutex  lock;
+    T*     items[RESERVATION_POOL_CAPACITY];
+    size_t count = 0;
+
+    T* take(void)
+    {
+        lock_guard<mutex> guard(lock);
+        return count ? items[--count] : nullptr;
+    }
+
+    bool put(T* item)
+    {
+        lock_guard<mutex> guard(lock);
+        if (count == RESERVATION_POOL_CAPACITY)
+            return false;
+        items[count++] = item;
+        return true;
+    }
+
+    size_t size(void)
+    {
+        lock_guard<mutex> guard(lock);
+        return count;
+    }
+};
+
+/**
+ * The lists are never destroyed, so a pooled object released during static destruction
+ * still finds its list; whatever is idle at exit is left to the operating system.
+ */
+static IdleList<Reservation>& idleReservations(void)
+{
+    static auto* list = new IdleList<Reservation>();
+    return *list;
+}
+
+static IdleList<Flight>& idleFlights(void)
+{
+    static auto* list = new IdleList<Flight>();
+    return *list;
+}
+
+static atomic<size_t> poolHits{0};
+static atomic<size_t> poolMisses{0};
+
+/**
+ * Allocator for the shared_ptr control blocks; it is rebound to each control block type,
+ * and every type gets its own list of idle blocks of exactly its size.
+ */
+template <typename T>
+class BlockAllocator
+{
+public:
+    using value_type = T;
+
+    BlockAllocator(void) = default;
+    template <typename U>
+    BlockAllocator(const BlockAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        if (n == 1)
+            if (void* block = idleBlocks().take())
+                return static_cast<T*>(block);
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        if (n == 1 && idleBlocks().put(p))
+            return;
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const BlockAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const BlockAllocator<U>&) const { return false; }
+
+private:
+    static IdleList<void>& idleBlocks(void)
+    {
+        static auto* list = new IdleList<void>();
+        return *list;
+    }
+};
+
+/**
+ * Deleters run when the last reference goes: the object is parked, not destroyed. A
+ * reservation drops its flight (returning it to the pool too) and its passenger and
+ * payment fields, so idle objects hold no customer data.
+ */
+struct RecycleFlight
+{
+    void operator()(Flight* flight) const
+    {
+        if (!idleFlights().put(flight))
+            delete flight;
+    }
+};
+
+struct RecycleReservation
+{
+    void operator()(Reservation* reservation) const
+    {
+        reservation->assign(string(), string(), nullptr, string(), string(), string());
+        if (!idleReservations().put(reservation))
+            delete reservation;
+    }
+};
+
+/**
+ * Takes an idle object or builds a new one, counting which.
+ */
+template <typename T>
+static T* takeOrCreate(IdleList<T>& list)
+{
+    if (T* item = list.take())
+    {
+        poolHits.fetch_add(1, memory_order_relaxed);
+        return item;
+    }
+    poolMisses.fetch_add(1, memory_order_relaxed);
+    return new T();
+}
+
+/**
+ * Copy-assignment reuses the idle flight's string and fare-table buffers.
+ */
+shared_ptr<Flight> ReservationPool::makeFlight(const Flight& source)
+{
+    Flight* flight = takeOrCreate(idleFlights());
+    *flight = source;
+    return shared_ptr<Flight>(flight, RecycleFlight(), BlockAllocator<Flight>());
+}
+
+shared_ptr<Reservation> ReservationPool::makeReservation(const string& reservationID,
+                                                         const string& passengerName,
+                                                         shared_ptr<Flight> flight,
+                                                         const string& seatNumber,
+                                                         const string& paymentMethod,
+                                                         const string& paymentDetails)
+{
+    Reservation* reservation = takeOrCreate(idleReservations());
+    reservation->assign(reservationID, passengerName, move(flight), seatNumber, paymentMethod,
+                        paymentDetails);
+    return shared_ptr<Reservation>(reservation, RecycleReservation(), BlockAllocator<Reservation>());
+}
+
+/**
+ * Builds the objects and drops them at once, which leaves both them and their control
+ * blocks on the idle lists.
+ */
+void ReservationPool::reserve(size_t bookings)
+{
+    bookings = min<size_t>(bookings, RESERVATION_POOL_CAPACITY);
+    vector<shared_ptr<Reservation>> warm;
+    warm.reserve(bookings);
+    Flight empty;
+    for (size_t i = 0; i < bookings; ++i)
+        warm.push_back(makeReservation("", "", makeFlight(empty), "", "", ""));
+}
+
+ReservationPoolStats ReservationPool::stats(void)
+{
+    ReservationPoolStats s;
+    s.hits             = poolHits.load(memory_order_relaxed);
+    s.misses           = poolMisses.load(memory_order_relaxed);
+    s.idleReservations = idleReservations().size();
+    s.idleFlights      = idleFlights().size();
+    return s;
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
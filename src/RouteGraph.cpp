@@ -0,0 +1,276 @@
+/******************************************************************************************
+ * MODULE NAME    : Route Graph Module
+ * FILE           : RouteGraph.cpp
+ * DESCRIPTION    : Implements the RouteGraph connection storage and the round-based
+ *                  Connection Scan Algorithm used for multi-leg searches.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/RouteGraph.hpp"
+#include <algorithm>
+#include <climits>
+#include <mutex>
+
+using namespace std;
+
+static const int32_t  UNREACHED = INT32_MAX;
+static const uint32_t NO_PARENT = UINT32_MAX;
+
+/**
+ * Returns true if a table row describes a leg passengers can still travel on.
+ */
+static bool isBookableLeg(const FlightTable& table, size_t row)
+{
+    int32_t dep = table.getDepartureMinute(row);
+    int32_t arr = table.getArrivalMinute(row);
+    return table.getStatus(row) != FlightStatus::Canceled && dep >= 0 && arr > dep;
+}
+
+/**
+ * Rebuilds the graph from every row of the table with a single sort.
+ */
+void RouteGraph::build(const FlightTable& table)
+{
+    unique_lock<shared_mutex> lock(mutex);
+    connections.clear();
+    legNumbers.clear();
+    freeLegIDs.clear();
+    legOf.clear();
+
+    connections.reserve(table.size());
+    for (size_t row = 0; row < table.size(); ++row)
+    {
+        if (!isBookableLeg(table, row) || legOf.count(table.getFlightNumber(row)))
+            continue;
+
+        uint32_t legID = static_cast<uint32_t>(legNumbers.size());
+        legNumbers.push_back(table.getFlightNumber(row));
+        legOf.emplace(table.getFlightNumber(row), legID);
+        connections.push_back({ table.getOriginID(row), table.getDestinationID(row),
+                                table.getDepartureMinute(row), table.getArrivalMinute(row), legID });
+    }
+
+    stable_sort(connections.begin(), connections.end(),
+                [](const Connection& a, const Connection& b) { return a.departureMinute < b.departureMinute; });
+}
+
+/**
+ * Inserts one row's leg at its departure-ordered position.
+ */
+void RouteGraph::addLeg(const FlightTable& table, size_t row)
+{
+    unique_lock<shared_mutex> lock(mutex);
+    eraseLeg(table.getFlightNumber(row));
+
+    if (!isBookableLeg(table, row))
+        return;
+
+    int32_t dep = table.getDepartureMinute(row);
+    int32_t arr = table.getArrivalMinute(row);
+
+    uint32_t legID;
+    if (!freeLegIDs.empty())
+    {
+        legID = freeLegIDs.back();
+        freeLegIDs.pop_back();
+        legNumbers[legID] = table.getFlightNumber(row);
+    }
+    else
+    {
+        legID = static_cast<uint32_t>(legNumbers.size());
+        legNumbers.push_back(table.getFlightNumber(row));
+    }
+    legOf[table.getFlightNumber(row)] = legID;
+
+    insertConnection({ table.getOriginID(row), table.getDestinationID(row), dep, arr, legID });
+}
+
+/**
+ * Removes a flight's leg from the graph.
+ */
+void RouteGraph::removeLeg(const string& flightNumber)
+{
+    unique_lock<shared_mutex> lock(mutex);
+    eraseLeg(flightNumber);
+}
+
+/**
+ * Returns the number of bookable legs.
+ */
+size_t RouteGraph::legCount(void) const
+{
+    shared_lock<shared_mutex> lock(mutex);
+    return connections.size();
+}
+
+/**
+ * Keeps the connection array sorted by departure time.
+ */
+void RouteGraph::insertConnection(const Connection& connection)
+{
+    auto pos = upper_bound(connections.begin(), connections.end(), connection.departureMinute,
+                           [](int32_t minute, const Connection& c) { return minute < c.departureMinute; });
+    connections.insert(pos, connection);
+}
+
+/**
+ * Drops a leg and recycles its ID; caller holds the exclusive lock.
+ */
+void RouteGraph::eraseLeg(const string& flightNumber)
+{
+    auto it = legOf.find(flightNumber);
+    if (it == legOf.end())
+        return;
+
+    uint32_t legID = it->second;
+    connections.erase(remove_if(connections.begin(), connections.end(),
+                                [&](const Connection& c) { return c.legID == legID; }),
+                      connections.end());
+    legNumbers[legID].clear();
+    freeLegIDs.push_back(legID);
+    legOf.erase(it);
+}
+
+/**
+ * Labels of one query, flattened as [legs * stops + stop]. Each thread keeps its own and
+ * reuses them: a query only writes the labels it reaches, lists them in touched, and
+ * sets them back to UNREACHED before it returns, so the next query starts clean without
+ * clearing (maxLegs + 1) x stops entries.
+ */
+struct ScanLabels
+{
+    vector<int32_t>  arrival;
+    vector<uint32_t> parent;
+    vector<uint32_t> touched;
+};
+
+/**
+ * Sets a query's labels back to UNREACHED when it ends, however it ends.
+ */
+struct ScanLabelsReset
+{
+    ScanLabels& scan;
+    ~ScanLabelsReset(void)
+    {
+        for (uint32_t at : scan.touched)
+            scan.arrival[at] = UNREACHED;
+        scan.touched.clear();
+    }
+};
+
+static thread_local ScanLabels scanLabels;
+
+/**
+ * Round-based CSA. arrival[k][s] is the earliest arrival at stop s using exactly k legs.
+ * Connections are scanned once in departure order from the first one at or after
+ * earliestDeparture; a connection extends a (k-1)-leg journey if it leaves at least
+ * minConnectMinutes after that journey reached its departure stop. The filter is asked
+ * last, only about connections that could otherwise be used.
+ *
+ * bound[k] is the best arrival at the destination with k legs or fewer: a k-leg journey
+ * is only worth finding if it arrives before that, and whatever a connection leaving
+ * at or after it starts arrives later, so round k skips it. Bounds only shrink as k
+ * grows, so the scan stops once departures reach bound[1], past every round's bound.
+ */
+vector<Itinerary> RouteGraph::findItineraries(SymbolTable::Symbol originID,
+                                              SymbolTable::Symbol destinationID,
+                                              int32_t earliestDeparture,
+                                              const LegFilter& usable,
+                                              int maxConnections,
+                                              int32_t minConnectMinutes) const
+{
+    vector<Itinerary> results;
+    if (originID == SymbolTable::INVALID_SYMBOL || destinationID == SymbolTable::INVALID_SYMBOL ||
+        originID == destinationID || maxConnections < 0)
+    {
+        return results;
+    }
+
+    shared_lock<shared_mutex> lock(mutex);
+
+    const size_t stops   = SymbolTable::size();
+    const int    maxLegs = maxConnections + 1;
+    const size_t labels  = static_cast<size_t>(maxLegs + 1) * stops;
+
+    ScanLabels& scan = scanLabels;
+    if (scan.arrival.size() < labels)
+    {
+        scan.arrival.assign(labels, UNREACHED);
+        scan.parent.assign(labels, NO_PARENT);
+    }
+    ScanLabelsReset reset{scan};
+    int32_t*  arrival = scan.arrival.data();
+    uint32_t* parent  = scan.parent.data();
+    auto label = [stops](int k, SymbolTable::Symbol stop) { return static_cast<size_t>(k) * stops + stop; };
+
+    vector<int32_t> bound(maxLegs + 1, UNREACHED);
+
+    auto first = lower_bound(connections.begin(), connections.end(), earliestDeparture,
+                             [](const Connection& c, int32_t minute) { return c.departureMinute < minute; });
+
+    for (auto it = first; it != connections.end(); ++it)
+    {
+        const Connection& c = *it;
+        if (c.departureMinute >= bound[1])
+            break;
+        if (c.arrivalStop == originID || c.departureStop >= stops || c.arrivalStop >= stops)
+            continue;
+        if (usable && !usable(legNumbers[c.legID]))
+            continue;
+
+        const uint32_t index = static_cast<uint32_t>(it - connections.begin());
+        for (int k = 1; k <= maxLegs && c.departureMinute < bound[k]; ++k)
+        {
+            bool reachable;
+            if (k == 1)
+                reachable = (c.departureStop == originID);
+            else
+            {
+                int32_t before = arrival[label(k - 1, c.departureStop)];
+                reachable = before != UNREACHED &&
+                            static_cast<int64_t>(before) + minConnectMinutes <= c.departureMinute;
+            }
+
+            const size_t at = label(k, c.arrivalStop);
+            if (reachable && c.arrivalMinute < arrival[at])
+            {
+                if (arrival[at] == UNREACHED)
+                    scan.touched.push_back(static_cast<uint32_t>(at));
+                arrival[at] = c.arrivalMinute;
+                parent[at]  = index;
+                if (c.arrivalStop == destinationID)
+                    for (int j = k; j <= maxLegs; ++j)
+                        bound[j] = min(bound[j], c.arrivalMinute);
+            }
+        }
+    }
+
+    int32_t bestSoFar = UNREACHED;
+    for (int k = 1; k <= maxLegs; ++k)
+    {
+        if (arrival[label(k, destinationID)] >= bestSoFar)
+            continue;
+        bestSoFar = arrival[label(k, destinationID)];
+
+        Itinerary itinerary;
+        itinerary.arrivalMinute = bestSoFar;
+
+        SymbolTable::Symbol stop = destinationID;
+        for (int legs = k; legs >= 1; --legs)
+        {
+            const Connection& leg = connections[parent[label(legs, stop)]];
+            itinerary.flightNumbers.push_back(legNumbers[leg.legID]);
+            itinerary.departureMinute = leg.departureMinute;
+            stop = leg.departureStop;
+        }
+        reverse(itinerary.flightNumbers.begin(), itinerary.flightNumbers.end());
+        results.push_back(itinerary);
+    }
+
+    return results;
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
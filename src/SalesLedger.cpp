@@ -0,0 +1,459 @@
+/******************************************************************************************
+ * MODULE NAME    : Sales Ledger Module
+ * FILE           : SalesLedger.cpp
+ * DESCRIPTION    : Implements the incrementally maintained booking counts, their
+ *                  persistence, their valuation against the schedule, and their check
+ *                  against the reservations.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/SalesLedger.hpp"
+#include "../header/FlightRegistry.hpp"
+#include "../header/FlightTable.hpp"
+#include "../header/Metrics.hpp"
+#include "../header/json.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * Booked and paid reservations of one flight and fare class.
+ */
+struct BookingCounts
+{
+    int64_t bookings     = 0;
+    int64_t paidBookings = 0;
+
+    bool operator==(const BookingCounts& other) const
+    {
+        return bookings == other.bookings && paidBookings == other.paidBookings;
+    }
+};
+
+/**
+ * One reservation's share of the counts, signed.
+ */
+struct SalesEntry
+{
+    string        flightNumber;
+    string        fareClass;
+    BookingCounts delta;
+};
+
+// Fare class codes are kept as booked; they are matched to buckets when valued
+using FareClassCounts = map<string, BookingCounts>;
+using FlightCountsMap = unordered_map<string, FareClassCounts>;
+
+static mutex           ledgerMutex;
+static once_flag       ledgerLoadOnce;
+static bool            ledgerLoaded = false;
+static FlightCountsMap flightCounts;
+static uint64_t        logSequence = 0;   // Last change line written, or folded into the snapshot
+static size_t          logLines    = 0;   // Lines in the log since the last compaction
+
+bool SalesCounters::operator==(const SalesCounters& other) const
+{
+    return bookings == other.bookings && revenueCents == other.revenueCents &&
+           paidBookings == other.paidBookings && paidRevenueCents == other.paidRevenueCents;
+}
+
+bool FlightSales::operator==(const FlightSales& other) const
+{
+    return route == other.route && month == other.month && total == other.total &&
+           fareClasses == other.fareClasses;
+}
+
+static void addTo(SalesCounters& counters, const SalesCounters& delta)
+{
+    counters.bookings         += delta.bookings;
+    counters.revenueCents     += delta.revenueCents;
+    counters.paidBookings     += delta.paidBookings;
+    counters.paidRevenueCents += delta.paidRevenueCents;
+}
+
+static SalesEntry entryOf(const Reservation& res, int64_t sign)
+{
+    SalesEntry entry;
+    entry.flightNumber       = res.getFlight()->getFlightNumber();
+    entry.fareClass          = res.getFareClass();
+    entry.delta.bookings     = sign;
+    entry.delta.paidBookings = res.getIsPaid() ? sign : 0;
+    return entry;
+}
+
+/**
+ * Applies one entry, dropping counts that fall back to zero so that incremental and
+ * rebuilt counts compare equal.
+ */
+static void applyEntry(FlightCountsMap& flights, const SalesEntry& entry)
+{
+    FareClassCounts& fareClasses = flights[entry.flightNumber];
+    BookingCounts&   counts      = fareClasses[entry.fareClass];
+    counts.bookings     += entry.delta.bookings;
+    counts.paidBookings += entry.delta.paidBookings;
+    if (counts == BookingCounts())
+        fareClasses.erase(entry.fareClass);
+    if (fareClasses.empty())
+        flights.erase(entry.flightNumber);
+}
+
+/**
+ * Counts of a list of reservations, computed from scratch; one hash update each.
+ */
+static FlightCountsMap computeFrom(const vector<shared_ptr<Reservation>>& reservations)
+{
+    FlightCountsMap flights;
+    for (auto const& res : reservations)
+        applyEntry(flights, entryOf(*res, 1));
+    return flights;
+}
+
+/**
+ * Values a scheduled flight's counts the way ReportEngine::group does: a booked class
+ * falls in the bucket with its code (the first if none has it) and counts at that
+ * bucket's current fare.
+ */
+static FlightSales salesOf(const FlightTable& table, size_t row, const FareClassCounts& counts)
+{
+    FlightSales sales;
+    Flight      flight = table.row(row);
+    sales.route = flight.getOrigin() + "-" + flight.getDestination();
+    sales.month = flight.getDepartureTime().size() >= 7 ? flight.getDepartureTime().substr(0, 7) : "unknown";
+
+    auto const& buckets = table.getFareBuckets(row);
+    for (auto const& fareClass : counts)
+    {
+        size_t b = table.fareBucketIndex(row, fareClass.first);
+        if (b >= buckets.size())
+            continue;
+
+        int64_t       fare = table.getFareCents(row, b);
+        SalesCounters value;
+        value.bookings         = fareClass.second.bookings;
+        value.revenueCents     = fareClass.second.bookings * fare;
+        value.paidBookings     = fareClass.second.paidBookings;
+        value.paidRevenueCents = fareClass.second.paidBookings * fare;
+        addTo(sales.total, value);
+        addTo(sales.fareClasses[buckets[b].code], value);
+    }
+    return sales;
+}
+
+/**
+ * Sums every scheduled flight with bookings into its route or month group.
+ */
+static map<string, SalesCounters> groupTotals(bool byRoute)
+{
+    auto table = FlightRegistry::table();
+    map<string, SalesCounters> groups;
+
+    lock_guard<mutex> lock(ledgerMutex);
+    for (size_t row = 0; row < table->size(); ++row)
+    {
+        auto it = flightCounts.find(table->getFlightNumber(row));
+        if (it == flightCounts.end())
+            continue;
+        FlightSales sales = salesOf(*table, row, it->second);
+        addTo(groups[byRoute ? sales.route : sales.month], sales.total);
+    }
+    return groups;
+}
+
+static json countsToJson(const FareClassCounts& counts)
+{
+    json fareClasses = json::object();
+    for (auto const& fareClass : counts)
+        fareClasses[fareClass.first] = { {"bookings", fareClass.second.bookings},
+                                         {"paidBookings", fareClass.second.paidBookings} };
+    return { {"fareClasses", fareClasses} };
+}
+
+static FareClassCounts countsFromJson(const json& j)
+{
+    FareClassCounts counts;
+    json            fareClasses = j.value("fareClasses", json::object());
+    for (auto const& fareClass : fareClasses.items())
+    {
+        BookingCounts& entry = counts[fareClass.key()];
+        entry.bookings     = fareClass.value().value("bookings", int64_t(0));
+        entry.paidBookings = fareClass.value().value("paidBookings", int64_t(0));
+    }
+    return counts;
+}
+
+/**
+ * Rewrites the snapshot through a temporary file, then empties the log; JSON objects
+ * keep their keys sorted, so flights come out in number order. The log is kept if the
+ * snapshot could not be written.
+ * Caller holds ledgerMutex.
+ */
+static void compactLedger(void)
+{
+    json flights = json::object();
+    for (auto const& entry : flightCounts)
+        flights[entry.first] = countsToJson(entry.second);
+
+    string tmpPath = string(PATH_OF_SALES_LEDGER_DATA_BASE) + ".tmp";
+    {
+        ofstream out(tmpPath, ios::trunc);
+        if (!out.is_open())
+        {
+            cerr << "Error: Unable to save the sales ledger.\n";
+            return;
+        }
+        out << setw(4) << json{ {"flights", flights}, {"logSequence", logSequence} } << endl;
+        METRIC_BYTES_WRITTEN(static_cast<uint64_t>(out.tellp()));
+    }
+    if (rename(tmpPath.c_str(), PATH_OF_SALES_LEDGER_DATA_BASE) != 0)
+    {
+        cerr << "Error: Unable to save the sales ledger.\n";
+        return;
+    }
+
+    ofstream log(PATH_OF_SALES_LEDGER_LOG_DATA_BASE, ios::trunc);
+    logLines = 0;
+}
+
+/**
+ * Appends one change as a single line of net per-class deltas, and compacts once the
+ * log holds SALES_LEDGER_COMPACTION_LINES of them.
+ * Caller holds ledgerMutex.
+ */
+static void appendChange(const FlightCountsMap& deltas)
+{
+    json changes = json::array();
+    for (auto const& flight : deltas)
+        for (auto const& fareClass : flight.second)
+            changes.push_back({ {"flight", flight.first}, {"fareClass", fareClass.first},
+                                {"bookings", fareClass.second.bookings},
+                                {"paidBookings", fareClass.second.paidBookings} });
+    if (changes.empty())
+        return;
+
+    ofstream log(PATH_OF_SALES_LEDGER_LOG_DATA_BASE, ios::app);
+    if (!log.is_open())
+    {
+        cerr << "Error: Unable to record a change to the sales ledger.\n";
+        return;
+    }
+    log << json{ {"seq", ++logSequence}, {"changes", changes} }.dump() << '\n';
+    METRIC_BYTES_WRITTEN(static_cast<uint64_t>(log.tellp()));
+    log.close();
+
+    if (++logLines >= SALES_LEDGER_COMPACTION_LINES)
+        compactLedger();
+}
+
+/**
+ * Applies the log lines numbered after the snapshot, moving sequence to the last one;
+ * malformed lines (a write cut short) are skipped.
+ * Returns the number of lines applied.
+ */
+static size_t replayLog(FlightCountsMap& flights, uint64_t& sequence)
+{
+    ifstream log(PATH_OF_SALES_LEDGER_LOG_DATA_BASE);
+    string   line;
+    size_t   applied = 0;
+    while (getline(log, line))
+    {
+        json record = json::parse(line, nullptr, false);
+        if (record.is_discarded() || !record.is_object() ||
+            !record.contains("changes") || !record.at("changes").is_array())
+            continue;
+
+        uint64_t seq = record.value("seq", uint64_t(0));
+        if (seq <= sequence)
+            continue;
+        try
+        {
+            for (auto const& change : record.at("changes"))
+            {
+                SalesEntry entry;
+                entry.flightNumber       = change.value("flight", string());
+                entry.fareClass          = change.value("fareClass", string());
+                entry.delta.bookings     = change.value("bookings", int64_t(0));
+                entry.delta.paidBookings = change.value("paidBookings", int64_t(0));
+                applyEntry(flights, entry);
+            }
+        }
+        catch (const json::exception&)
+        {
+            continue;
+        }
+        sequence = seq;
+        ++applied;
+    }
+    return applied;
+}
+
+/**
+ * Reads the snapshot and the number of the last log line folded into it.
+ * Returns false if the file is missing or unreadable.
+ */
+static bool readLedger(FlightCountsMap& flights, uint64_t& sequence)
+{
+    ifstream in(PATH_OF_SALES_LEDGER_DATA_BASE);
+    if (!in.is_open())
+        return false;
+
+    json j = json::parse(in, nullptr, false);
+    if (j.is_discarded() || !j.contains("flights") || !j.at("flights").is_object())
+        return false;
+
+    try
+    {
+        for (auto const& entry : j.at("flights").items())
+            flights.emplace(entry.key(), countsFromJson(entry.value()));
+        sequence = j.value("logSequence", uint64_t(0));
+    }
+    catch (const json::exception&)
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Loads the ledger once per process: the snapshot plus the log after it. With
+ * reservations to check against, the stored counts are kept only if they match the
+ * counts of that list; without, they are trusted and the reservation file is read only
+ * when there are none. A rebuild or a replayed log is compacted straight away.
+ */
+static void loadLedger(const vector<shared_ptr<Reservation>>* loaded = nullptr)
+{
+    call_once(ledgerLoadOnce, [loaded]()
+    {
+        METRIC_SCOPE("SalesLedger::load");
+        FlightCountsMap stored;
+        uint64_t        sequence   = 0;
+        bool            haveStored = readLedger(stored, sequence);
+        size_t          replayed   = haveStored ? replayLog(stored, sequence) : 0;
+        bool            rebuilt    = false;
+
+        if (loaded)
+        {
+            FlightCountsMap computed = computeFrom(*loaded);
+            if (!haveStored || computed != stored)
+            {
+                if (haveStored)
+                    cerr << "Note: The sales ledger did not match the reservations and was rebuilt.\n";
+                stored  = move(computed);
+                rebuilt = true;
+            }
+        }
+        else if (!haveStored)
+        {
+            stored  = computeFrom(Reservation::loadReservations());
+            rebuilt = true;
+        }
+
+        lock_guard<mutex> lock(ledgerMutex);
+        flightCounts = move(stored);
+        logSequence  = sequence;
+        if (rebuilt || replayed > 0)
+            compactLedger();
+        ledgerLoaded = true;
+    });
+}
+
+void SalesLedger::seed(const vector<shared_ptr<Reservation>>& reservations)
+{
+    loadLedger(&reservations);
+}
+
+void SalesLedger::load(void)
+{
+    loadLedger();
+}
+
+/**
+ * Entries are netted per flight and class before the lock is taken, so a payment
+ * settled (one record uncounted unpaid, counted paid) logs a single delta and a no-op
+ * rewrite logs nothing. Writers load the ledger before they touch the reservation file,
+ * and that load waits for a startup seed in progress, so it is loaded by now. A writer
+ * that skipped it would lose the change; rather than drop it, the ledger is then loaded
+ * checked against the file, which already holds the change.
+ */
+void SalesLedger::recordChanges(const vector<shared_ptr<Reservation>>& removed,
+                                const vector<shared_ptr<Reservation>>& added)
+{
+    if (removed.empty() && added.empty())
+        return;
+
+    FlightCountsMap deltas;
+    for (auto const& res : removed)
+        applyEntry(deltas, entryOf(*res, -1));
+    for (auto const& res : added)
+        applyEntry(deltas, entryOf(*res, 1));
+
+    unique_lock<mutex> lock(ledgerMutex);
+    if (!ledgerLoaded)
+    {
+        lock.unlock();
+        cerr << "Warning: A sales change was recorded before the ledger was loaded; "
+             << "checking the ledger against the reservations.\n";
+        auto current = Reservation::loadReservations();
+        loadLedger(&current);
+        return;
+    }
+
+    for (auto const& flight : deltas)
+        for (auto const& fareClass : flight.second)
+            applyEntry(flightCounts, { flight.first, fareClass.first, fareClass.second });
+    appendChange(deltas);
+}
+
+bool SalesLedger::flightSales(const string& flightNumber, FlightSales& sales)
+{
+    loadLedger();
+    auto table = FlightRegistry::table();
+    long row   = table->findRow(flightNumber);
+    if (row < 0)
+        return false;
+
+    lock_guard<mutex> lock(ledgerMutex);
+    auto it = flightCounts.find(flightNumber);
+    if (it == flightCounts.end())
+        return false;
+    sales = salesOf(*table, static_cast<size_t>(row), it->second);
+    return true;
+}
+
+SalesCounters SalesLedger::routeSales(const string& route)
+{
+    loadLedger();
+    auto groups = groupTotals(true);
+    auto it     = groups.find(route);
+    return it != groups.end() ? it->second : SalesCounters();
+}
+
+SalesCounters SalesLedger::monthSales(const string& month)
+{
+    loadLedger();
+    auto groups = groupTotals(false);
+    auto it     = groups.find(month);
+    return it != groups.end() ? it->second : SalesCounters();
+}
+
+map<string, SalesCounters> SalesLedger::routes(void)
+{
+    loadLedger();
+    return groupTotals(true);
+}
+
+map<string, SalesCounters> SalesLedger::months(void)
+{
+    loadLedger();
+    return groupTotals(false);
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
@@ -0,0 +1,252 @@
+/******************************************************************************************
+ * MODULE NAME    : Search Cache Module
+ * FILE           : SearchCache.cpp
+ * DESCRIPTION    : Implements the LRU SearchCache and its flight/route invalidation indexes.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/SearchCache.hpp"
+#include "../header/FlightTable.hpp"
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+
+/**
+ * One cached query with everything needed to unlink it from the indexes.
+ */
+struct CacheEntry
+{
+    string               key;
+    string               route;
+    int32_t              fromMinute;
+    int32_t              toMinute;
+    SearchCache::Results results;
+    size_t               bytes;
+};
+
+static mutex                                                 cacheMutex;
+static list<CacheEntry>                                      lruList;    // Front = most recent
+static unordered_map<string, list<CacheEntry>::iterator>     entryOf;
+static unordered_map<string, unordered_set<string>>          keysByFlight;
+static unordered_map<string, unordered_set<string>>          keysByRoute;
+static uint64_t cacheGeneration = 0;
+static uint64_t cacheHits = 0, cacheMisses = 0, cacheEvictions = 0, cacheInvalidations = 0;
+static size_t   cacheBytes = 0;
+
+/**
+ * Trims leading and trailing whitespace.
+ */
+static string trimmed(const string& text)
+{
+    const char* ws = " \t\r\n";
+    size_t begin = text.find_first_not_of(ws);
+    if (begin == string::npos)
+        return "";
+    size_t end = text.find_last_not_of(ws);
+    return text.substr(begin, end - begin + 1);
+}
+
+/**
+ * Joins origin and destination into the route index key.
+ */
+static string routeKey(const string& origin, const string& destination)
+{
+    return origin + '\x1f' + destination;
+}
+
+/**
+ * Trims the route names so equivalent queries share one key.
+ */
+void SearchQuery::normalize(void)
+{
+    origin      = trimmed(origin);
+    destination = trimmed(destination);
+}
+
+/**
+ * Builds the cache key of a query.
+ */
+string SearchQuery::key(void) const
+{
+    return routeKey(origin, destination) + '\x1f' + to_string(fromMinute) + '\x1f' + to_string(toMinute);
+}
+
+/**
+ * Approximates the heap footprint of a cached entry.
+ */
+static size_t entryBytes(const CacheEntry& entry)
+{
+    size_t bytes = sizeof(CacheEntry) + entry.key.capacity() + entry.route.capacity();
+    if (entry.results)
+    {
+        bytes += sizeof(vector<Flight>) + entry.results->capacity() * sizeof(Flight);
+        for (auto const& fl : *entry.results)
+            bytes += fl.getFlightNumber().capacity() + fl.getDepartureTime().capacity() +
+                     fl.getArrivalTime().capacity() + fl.getflightPrice().capacity();
+    }
+    return bytes;
+}
+
+/**
+ * Unlinks an entry from the LRU list and both indexes; caller holds cacheMutex.
+ */
+static void eraseEntry(list<CacheEntry>::iterator it)
+{
+    for (auto const& fl : *it->results)
+    {
+        auto byFlight = keysByFlight.find(fl.getFlightNumber());
+        if (byFlight != keysByFlight.end())
+        {
+            byFlight->second.erase(it->key);
+            if (byFlight->second.empty())
+                keysByFlight.erase(byFlight);
+        }
+    }
+
+    auto byRoute = keysByRoute.find(it->route);
+    if (byRoute != keysByRoute.end())
+    {
+        byRoute->second.erase(it->key);
+        if (byRoute->second.empty())
+            keysByRoute.erase(byRoute);
+    }
+
+    cacheBytes -= it->bytes;
+    entryOf.erase(it->key);
+    lruList.erase(it);
+}
+
+/**
+ * Returns cached results and marks the entry most recently used.
+ */
+SearchCache::Results SearchCache::lookup(const SearchQuery& query)
+{
+    string key = query.key();
+    lock_guard<mutex> lock(cacheMutex);
+
+    auto it = entryOf.find(key);
+    if (it == entryOf.end())
+    {
+        ++cacheMisses;
+        return nullptr;
+    }
+
+    ++cacheHits;
+    lruList.splice(lruList.begin(), lruList, it->second);
+    return it->second->results;
+}
+
+/**
+ * Returns the current invalidation generation.
+ */
+uint64_t SearchCache::generation(void)
+{
+    lock_guard<mutex> lock(cacheMutex);
+    return cacheGeneration;
+}
+
+/**
+ * Inserts a result, evicting the least recently used entries beyond capacity.
+ */
+void SearchCache::store(const SearchQuery& query, Results results, uint64_t computedAt)
+{
+    if (!results)
+        return;
+
+    CacheEntry entry{ query.key(), routeKey(query.origin, query.destination),
+                      query.fromMinute, query.toMinute, move(results), 0 };
+    entry.bytes = entryBytes(entry);
+
+    lock_guard<mutex> lock(cacheMutex);
+    if (computedAt != cacheGeneration)
+        return;
+
+    auto existing = entryOf.find(entry.key);
+    if (existing != entryOf.end())
+        eraseEntry(existing->second);
+
+    lruList.push_front(move(entry));
+    auto it = lruList.begin();
+    entryOf[it->key] = it;
+    keysByRoute[it->route].insert(it->key);
+    for (auto const& fl : *it->results)
+        keysByFlight[fl.getFlightNumber()].insert(it->key);
+    cacheBytes += it->bytes;
+
+    while (lruList.size() > SEARCH_CACHE_CAPACITY)
+    {
+        eraseEntry(prev(lruList.end()));
+        ++cacheEvictions;
+    }
+}
+
+/**
+ * Drops the queries whose result lists this flight, plus the queries on its route whose
+ * departure window contains it (a new or moved flight would now appear in them).
+ */
+void SearchCache::invalidateFlight(const Flight& flight)
+{
+    int32_t departure = FlightTable::parseDateTime(flight.getDepartureTime());
+    string  route     = routeKey(flight.getOrigin(), flight.getDestination());
+
+    lock_guard<mutex> lock(cacheMutex);
+    ++cacheGeneration;
+
+    vector<string> victims;
+    auto byFlight = keysByFlight.find(flight.getFlightNumber());
+    if (byFlight != keysByFlight.end())
+        victims.insert(victims.end(), byFlight->second.begin(), byFlight->second.end());
+
+    auto byRoute = keysByRoute.find(route);
+    if (byRoute != keysByRoute.end())
+    {
+        for (auto const& key : byRoute->second)
+        {
+            auto const& entry = *entryOf.at(key);
+            if (departure >= entry.fromMinute && departure <= entry.toMinute)
+                victims.push_back(key);
+        }
+    }
+
+    for (auto const& key : victims)
+    {
+        auto it = entryOf.find(key);
+        if (it != entryOf.end())
+        {
+            eraseEntry(it->second);
+            ++cacheInvalidations;
+        }
+    }
+}
+
+/**
+ * Removes every entry.
+ */
+void SearchCache::clear(void)
+{
+    lock_guard<mutex> lock(cacheMutex);
+    ++cacheGeneration;
+    lruList.clear();
+    entryOf.clear();
+    keysByFlight.clear();
+    keysByRoute.clear();
+    cacheBytes = 0;
+}
+
+/**
+ * Copies the counters under the lock.
+ */
+SearchCacheStats SearchCache::stats(void)
+{
+    lock_guard<mutex> lock(cacheMutex);
+    return SearchCacheStats{ cacheHits, cacheMisses, cacheEvictions, cacheInvalidations,
+                             lruList.size(), cacheBytes };
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
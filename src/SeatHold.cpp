@@ -0,0 +1,288 @@
+/******************************************************************************************
+ * MODULE NAME    : Seat Hold Module
+ * FILE           : SeatHold.cpp
+ * DESCRIPTION    : Implements the hierarchical hold-expiry timing wheel and its
+ *                  background ticker.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/SeatHold.hpp"
+#include "../header/Reservation.hpp"
+#include "../header/Tracer.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * One pending hold.
+ */
+struct HoldEntry
+{
+    string  reservationID;
+    int64_t expiresAt;
+};
+
+using Slot  = list<HoldEntry>;
+using Level = array<Slot, SEAT_HOLD_WHEEL_SLOTS>;
+
+/**
+ * Where a hold is linked, so it can be unlinked in O(1).
+ */
+struct HoldPosition
+{
+    size_t         level;
+    size_t         slot;
+    Slot::iterator entry;
+};
+
+static array<Level, SEAT_HOLD_WHEEL_LEVELS>                      wheel;
+static unordered_map<string, HoldPosition>                       holdIndex;
+static mutex                                                     wheelMutex;
+static condition_variable                                        tickerWake;
+static thread                                                    tickerThread;
+static bool                                                      tickerStopping = false;
+static int64_t                                                   lastTick = 0;
+static once_flag                                                 holdStartOnce;
+
+/* A slot of a level spans 2^LEVEL_SHIFT(level) seconds; WHEEL_SPAN is the whole wheel */
+#define LEVEL_SHIFT(level) (static_cast<int64_t>(level) * SEAT_HOLD_WHEEL_BITS)
+#define WHEEL_SPAN         (int64_t(1) << LEVEL_SHIFT(SEAT_HOLD_WHEEL_LEVELS))
+
+/**
+ * Joins the ticker at exit if main did not stop it.
+ */
+struct TickerJoiner
+{
+    ~TickerJoiner() { SeatHold::stop(); }
+};
+static TickerJoiner tickerJoiner;
+
+/**
+ * Current wall-clock time in epoch seconds.
+ */
+static int64_t nowSeconds(void)
+{
+    return static_cast<int64_t>(time(nullptr));
+}
+
+/**
+ * Links a hold into the finest level whose current turn contains its due second, which
+ * is its expiry but no earlier than earliest; caller holds wheelMutex. A hold beyond the
+ * whole wheel waits in the top level and is relinked when its slot comes round.
+ */
+static void linkHold(const string& reservationID, int64_t expiresAt, int64_t earliest)
+{
+    int64_t due   = max(expiresAt, earliest);
+    size_t  level = 0;
+    while (level + 1 < SEAT_HOLD_WHEEL_LEVELS &&
+           (due >> LEVEL_SHIFT(level + 1)) != (lastTick >> LEVEL_SHIFT(level + 1)))
+        ++level;
+
+    size_t slot = static_cast<size_t>((due >> LEVEL_SHIFT(level)) & (SEAT_HOLD_WHEEL_SLOTS - 1));
+    Slot&  bucket = wheel[level][slot];
+    bucket.push_back(HoldEntry{ reservationID, expiresAt });
+    holdIndex[reservationID] = HoldPosition{ level, slot, prev(bucket.end()) };
+}
+
+/**
+ * Links a new hold; one already lapsed is due on the coming tick.
+ */
+static void insertHold(const string& reservationID, int64_t expiresAt)
+{
+    linkHold(reservationID, expiresAt, lastTick + 1);
+}
+
+/**
+ * Relinks every hold of a slot from the current tick on, which moves the holds of a
+ * coarse slot down to finer levels; caller holds wheelMutex.
+ */
+static void cascade(size_t level, size_t slot, int64_t earliest)
+{
+    Slot pending;
+    pending.splice(pending.end(), wheel[level][slot]);
+    for (auto const& hold : pending)
+        linkHold(hold.reservationID, hold.expiresAt, earliest);
+}
+
+/**
+ * Advances the wheel one second at a time up to now and returns the holds that lapsed;
+ * caller holds wheelMutex. A second visits one slot of the finest level, and a coarser
+ * slot only when the level below wraps, so each hold is moved at most once per level.
+ * After a stall longer than the whole wheel, every hold is relinked from now instead.
+ */
+static vector<string> advanceWheel(int64_t now)
+{
+    vector<string> lapsed;
+    if (now - lastTick > WHEEL_SPAN)
+    {
+        lastTick = now - 1;
+        for (size_t level = 0; level < SEAT_HOLD_WHEEL_LEVELS; ++level)
+            for (size_t slot = 0; slot < SEAT_HOLD_WHEEL_SLOTS; ++slot)
+                cascade(level, slot, now);
+    }
+
+    while (lastTick < now)
+    {
+        ++lastTick;
+        for (size_t level = SEAT_HOLD_WHEEL_LEVELS - 1; level > 0; --level)
+        {
+            if ((lastTick & ((int64_t(1) << LEVEL_SHIFT(level)) - 1)) == 0)
+                cascade(level, static_cast<size_t>((lastTick >> LEVEL_SHIFT(level)) &
+                                                   (SEAT_HOLD_WHEEL_SLOTS - 1)), lastTick);
+        }
+
+        Slot& slot = wheel[0][static_cast<size_t>(lastTick & (SEAT_HOLD_WHEEL_SLOTS - 1))];
+        for (auto const& hold : slot)
+        {
+            lapsed.push_back(hold.reservationID);
+            holdIndex.erase(hold.reservationID);
+        }
+        slot.clear();
+    }
+    return lapsed;
+}
+
+/**
+ * Ticker body: one tick per second until stop() is called.
+ */
+static void runTicker(void)
+{
+    unique_lock<mutex> lock(wheelMutex);
+    while (!tickerStopping)
+    {
+        tickerWake.wait_for(lock, chrono::seconds(1));
+        if (tickerStopping)
+            break;
+
+        vector<string> lapsed = advanceWheel(nowSeconds());
+        if (lapsed.empty())
+            continue;
+
+        // Cancel outside the lock, all in one pass over the files; a payment confirmed
+        // meanwhile wins over the expiry
+        lock.unlock();
+        Reservation::expireHolds(lapsed);
+        lock.lock();
+    }
+}
+
+/**
+ * Seeds the wheel from the unpaid reservations and launches the ticker; runs once.
+ */
+static void startFrom(const vector<shared_ptr<Reservation>>& reservations)
+{
+    lock_guard<mutex> lock(wheelMutex);
+    lastTick = nowSeconds();
+    for (auto const& res : reservations)
+    {
+        if (res->getIsPaid())
+            continue;
+        int64_t expiresAt = res->getHoldExpiresAt();
+        insertHold(res->getReservationID(), expiresAt > 0 ? expiresAt : SeatHold::expiryFromNow());
+    }
+    tickerThread = thread(runTicker);
+}
+
+/**
+ * Loads the reservations on file and starts from them, once.
+ */
+void SeatHold::start(void)
+{
+    call_once(holdStartOnce, []
+    {
+        startFrom(Reservation::loadReservations());
+    });
+}
+
+void SeatHold::start(const vector<shared_ptr<Reservation>>& reservations)
+{
+    call_once(holdStartOnce, [&reservations]
+    {
+        startFrom(reservations);
+    });
+}
+
+/**
+ * Signals the ticker and joins it outside the lock.
+ */
+void SeatHold::stop(void)
+{
+    thread finished;
+    {
+        lock_guard<mutex> lock(wheelMutex);
+        tickerStopping = true;
+        finished = move(tickerThread);
+    }
+    tickerWake.notify_all();
+    if (finished.joinable())
+        finished.join();
+}
+
+/**
+ * Now plus the configured TTL.
+ */
+int64_t SeatHold::expiryFromNow(void)
+{
+    return nowSeconds() + SEAT_HOLD_TTL_SECONDS;
+}
+
+bool SeatHold::hasLapsed(int64_t expiresAt)
+{
+    return expiresAt > 0 && expiresAt <= nowSeconds();
+}
+
+/**
+ * Arms (or re-arms) the expiry of a reservation.
+ */
+void SeatHold::placeHold(const string& reservationID, int64_t expiresAt)
+{
+    TRACE_SPAN("SeatHold::placeHold");
+    start();
+    lock_guard<mutex> lock(wheelMutex);
+    auto existing = holdIndex.find(reservationID);
+    if (existing != holdIndex.end())
+    {
+        auto const& at = existing->second;
+        wheel[at.level][at.slot].erase(at.entry);
+        holdIndex.erase(existing);
+    }
+    insertHold(reservationID, expiresAt);
+}
+
+/**
+ * Unlinks a hold in O(1) through the index.
+ */
+bool SeatHold::clearHold(const string& reservationID)
+{
+    lock_guard<mutex> lock(wheelMutex);
+    auto it = holdIndex.find(reservationID);
+    if (it == holdIndex.end())
+        return false;
+
+    wheel[it->second.level][it->second.slot].erase(it->second.entry);
+    holdIndex.erase(it);
+    return true;
+}
+
+/**
+ * Size of the index, which mirrors the wheel.
+ */
+size_t SeatHold::pendingHolds(void)
+{
+    lock_guard<mutex> lock(wheelMutex);
+    return holdIndex.size();
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
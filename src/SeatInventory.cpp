@@ -0,0 +1,325 @@
+/******************************************************************************************
+ * MODULE NAME    : Seat Inventory Module
+ * FILE           : SeatInventory.cpp
+ * DESCRIPTION    : Implements the per-flight, per-fare-bucket seat counters of
+ *                  SeatInventory.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/SeatInventory.hpp"
+#include "../header/FlightRegistry.hpp"
+#include "../header/Reservation.hpp"
+#include "../header/Tracer.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * Inventory of one flight. Counters are heap-allocated so their address survives
+ * rehashing. Sales go through the per-flight lock because a nested check reads
+ * several buckets; the two summary counts are atomics so displays never lock.
+ */
+struct SeatCounter
+{
+    mutex                            lock;
+    int                              totalSeats = 0;
+    size_t                           bucketCount = 0;
+    array<string, MAX_FARE_BUCKETS>  codes;
+    array<int, MAX_FARE_BUCKETS>     limits{};     // Nested limits; limits[0] is the authorised capacity
+    array<int, MAX_FARE_BUCKETS>     sold{};
+    atomic<int>                      seatsLeft{0}; // totalSeats - seats sold
+    atomic<int>                      bookable{0};  // Availability of the first bucket
+};
+
+static unordered_map<string, unique_ptr<SeatCounter>> counters;
+static shared_mutex                                    countersMutex;
+static atomic<bool>                                    inventorySeeded(false);
+static once_flag                                       inventorySeedOnce;
+
+/**
+ * Maps a fare class code to its bucket; empty or unknown codes fall back to the first.
+ */
+static size_t bucketOf(const SeatCounter& counter, const string& fareClass)
+{
+    for (size_t b = 0; b < counter.bucketCount; ++b)
+        if (counter.codes[b] == fareClass)
+            return b;
+    return 0;
+}
+
+/**
+ * Nested availability of bucket b: each bucket j at or above b caps the seats sold in
+ * j and everything cheaper. At most MAX_FARE_BUCKETS steps; caller holds counter.lock.
+ */
+static int availabilityOf(const SeatCounter& counter, size_t b)
+{
+    array<int, MAX_FARE_BUCKETS> soldFrom{};
+    int running = 0;
+    for (size_t j = counter.bucketCount; j-- > 0; )
+    {
+        running    += counter.sold[j];
+        soldFrom[j] = running;
+    }
+
+    int available = INT_MAX;
+    for (size_t j = 0; j <= b && j < counter.bucketCount; ++j)
+        available = min(available, counter.limits[j] - soldFrom[j]);
+    return max(0, available);
+}
+
+/**
+ * Republishes the lock-free summary counts; caller holds counter.lock.
+ */
+static void publish(SeatCounter& counter)
+{
+    int total = 0;
+    for (size_t b = 0; b < counter.bucketCount; ++b)
+        total += counter.sold[b];
+    counter.seatsLeft = counter.totalSeats - total;
+    counter.bookable  = availabilityOf(counter, 0);
+}
+
+/**
+ * Loads capacity and fare limits from a flight, carrying seats already sold over by
+ * fare code (sales in a bucket that no longer exists move to the first bucket).
+ */
+static void configure(SeatCounter& counter, const Flight& flight)
+{
+    auto const& buckets = flight.getFareBuckets();
+    int authorized      = flight.getAuthorizedCapacity();
+
+    array<int, MAX_FARE_BUCKETS> carried{};
+    for (size_t b = 0; b < counter.bucketCount; ++b)
+    {
+        size_t target = 0;
+        for (size_t n = 0; n < buckets.size(); ++n)
+            if (buckets[n].code == counter.codes[b])
+                target = n;
+        carried[target] += counter.sold[b];
+    }
+
+    counter.totalSeats  = flight.getTotalSeats();
+    counter.bucketCount = min(buckets.size(), static_cast<size_t>(MAX_FARE_BUCKETS));
+    for (size_t b = 0; b < counter.bucketCount; ++b)
+    {
+        counter.codes[b]  = buckets[b].code;
+        counter.limits[b] = b == 0 ? authorized : min(buckets[b].bookingLimit, authorized);
+    }
+    counter.sold = carried;
+    publish(counter);
+}
+
+/**
+ * Builds the counters from the schedule, then counts the live reservations per bucket;
+ * they are loaded here unless the caller already has them.
+ */
+static void seedInventory(const vector<shared_ptr<Reservation>>* loaded = nullptr)
+{
+    call_once(inventorySeedOnce, [loaded]() mutable
+    {
+        auto table = FlightRegistry::table();
+        unordered_map<string, unique_ptr<SeatCounter>> seeded;
+        seeded.reserve(table->size());
+        for (size_t row = 0; row < table->size(); ++row)
+        {
+            auto counter = make_unique<SeatCounter>();
+            configure(*counter, table->row(row));
+            seeded.emplace(table->getFlightNumber(row), move(counter));
+        }
+
+        // Agent bookings are mirrored in the main file, so it alone holds every seat taken
+        vector<shared_ptr<Reservation>> reservations;
+        if (!loaded)
+        {
+            reservations = Reservation::loadReservations();
+            loaded       = &reservations;
+        }
+        for (auto const& res : *loaded)
+        {
+            auto it = seeded.find(res->getFlight()->getFlightNumber());
+            if (it != seeded.end())
+                ++it->second->sold[bucketOf(*it->second, res->getFareClass())];
+        }
+        for (auto& entry : seeded)
+            publish(*entry.second);
+
+        unique_lock<shared_mutex> lock(countersMutex);
+        counters = move(seeded);
+        inventorySeeded = true;
+    });
+}
+
+/**
+ * Returns the counter of a flight, or nullptr; caller holds countersMutex.
+ */
+static SeatCounter* counterOf(const string& flightNumber)
+{
+    auto it = counters.find(flightNumber);
+    return it == counters.end() ? nullptr : it->second.get();
+}
+
+/**
+ * Reads the physical seats left without taking any lock but the map's.
+ */
+int SeatInventory::seatsAvailable(const string& flightNumber)
+{
+    seedInventory();
+    shared_lock<shared_mutex> lock(countersMutex);
+    SeatCounter* counter = counterOf(flightNumber);
+    return counter ? max(0, counter->seatsLeft.load()) : -1;
+}
+
+/**
+ * Nested availability of one bucket.
+ */
+int SeatInventory::fareAvailability(const string& flightNumber, const string& fareClass)
+{
+    seedInventory();
+    shared_lock<shared_mutex> lock(countersMutex);
+    SeatCounter* counter = counterOf(flightNumber);
+    if (!counter)
+        return 0;
+
+    lock_guard<mutex> guard(counter->lock);
+    return availabilityOf(*counter, bucketOf(*counter, fareClass));
+}
+
+/**
+ * Checks and takes the seats under the flight's lock; O(MAX_FARE_BUCKETS).
+ */
+bool SeatInventory::reserveSeat(const string& flightNumber, const string& fareClass, int count)
+{
+    TRACE_SPAN("SeatInventory::reserveSeat");
+    seedInventory();
+    shared_lock<shared_mutex> lock(countersMutex);
+    SeatCounter* counter = counterOf(flightNumber);
+    if (!counter)
+        return false;
+
+    lock_guard<mutex> guard(counter->lock);
+    size_t bucket = bucketOf(*counter, fareClass);
+    if (count < 1 || availabilityOf(*counter, bucket) < count)
+        return false;
+
+    counter->sold[bucket] += count;
+    publish(*counter);
+    return true;
+}
+
+/**
+ * Returns seats to their bucket. Before seeding this is a no-op, so nothing may release
+ * seats until the seed is published: a lazy seed reads the files, which already reflect
+ * the release, but a seed from reservations loaded earlier does not; StartupLoader
+ * starts the hold ticker only after seeding for that reason.
+ */
+void SeatInventory::releaseSeat(const string& flightNumber, const string& fareClass, int count)
+{
+    if (!inventorySeeded)
+        return;
+
+    shared_lock<shared_mutex> lock(countersMutex);
+    SeatCounter* counter = counterOf(flightNumber);
+    if (!counter)
+        return;
+
+    lock_guard<mutex> guard(counter->lock);
+    size_t bucket = bucketOf(*counter, fareClass);
+    counter->sold[bucket] -= min(counter->sold[bucket], max(count, 0));
+    publish(*counter);
+}
+
+/**
+ * Filters and orders search results using only the summary counters.
+ */
+void SeatInventory::rankByAvailability(vector<Flight>& flights, int minSeats)
+{
+    seedInventory();
+
+    vector<pair<int, Flight>> ranked;
+    ranked.reserve(flights.size());
+    {
+        shared_lock<shared_mutex> lock(countersMutex);
+        for (auto& fl : flights)
+        {
+            SeatCounter* counter = counterOf(fl.getFlightNumber());
+            int bookable = counter ? counter->bookable.load() : 0;
+            if (bookable >= minSeats)
+                ranked.emplace_back(bookable, move(fl));
+        }
+    }
+
+    stable_sort(ranked.begin(), ranked.end(),
+                [](auto const& a, auto const& b) { return a.first > b.first; });
+
+    flights.clear();
+    for (auto& entry : ranked)
+        flights.push_back(move(entry.second));
+}
+
+bool SeatInventory::isBookable(const string& flightNumber, int minSeats)
+{
+    seedInventory();
+    shared_lock<shared_mutex> lock(countersMutex);
+    SeatCounter* counter = counterOf(flightNumber);
+    return counter && counter->bookable.load() >= minSeats;
+}
+
+/**
+ * Opens an empty inventory for a new flight.
+ */
+void SeatInventory::onFlightAdded(const Flight& flight)
+{
+    if (!inventorySeeded)
+        return;
+
+    auto counter = make_unique<SeatCounter>();
+    configure(*counter, flight);
+    unique_lock<shared_mutex> lock(countersMutex);
+    counters[flight.getFlightNumber()] = move(counter);
+}
+
+/**
+ * Forgets a removed flight.
+ */
+void SeatInventory::onFlightRemoved(const Flight& flight)
+{
+    if (!inventorySeeded)
+        return;
+
+    unique_lock<shared_mutex> lock(countersMutex);
+    counters.erase(flight.getFlightNumber());
+}
+
+/**
+ * Re-reads limits from the edited flight. Shrinking below the seats already sold
+ * closes the flight rather than cancelling anyone.
+ */
+void SeatInventory::onFlightUpdated(const Flight&, const Flight& after)
+{
+    if (!inventorySeeded)
+        return;
+
+    shared_lock<shared_mutex> lock(countersMutex);
+    if (SeatCounter* counter = counterOf(after.getFlightNumber()))
+    {
+        lock_guard<mutex> guard(counter->lock);
+        configure(*counter, after);
+    }
+}
+
+void SeatInventory::seed(const vector<shared_ptr<Reservation>>& reservations)
+{
+    seedInventory(&reservations);
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
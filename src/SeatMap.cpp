@@ -0,0 +1,463 @@
+/******************************************************************************************
+ * MODULE NAME    : Seat Map Module
+ * FILE           : SeatMap.cpp
+ * DESCRIPTION    : Implements per-flight seat occupancy bitsets and the adjacent-seat and
+ *                  window-seat searches over them.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/SeatMap.hpp"
+#include "../header/Aircraft.hpp"
+#include "../header/CabinLayout.hpp"
+#include "../header/FlightRegistry.hpp"
+#include "../header/Reservation.hpp"
+#include "../header/Tracer.hpp"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * Occupancy of one flight: bit c of occupied[r] is set when seat (r, c) is taken. A
+ * retired map has been dropped; its seats were handed on and it takes no more claims.
+ */
+struct FlightSeats
+{
+    mutex            lock;
+    CabinLayout      layout;
+    vector<uint64_t> occupied;
+    bool             retired = false;
+};
+
+// Locks are taken flight first, then seatMapsMutex, never the other way round
+static unordered_map<string, shared_ptr<FlightSeats>> seatMaps;
+static unordered_map<string, vector<string>>          carriedSeats;   // Taken in a dropped map
+static shared_mutex                                    seatMapsMutex;
+
+/**
+ * An empty map of a flight: its aircraft's layout cut to the flight's seat count. The
+ * layout comes from the given aircraft records, or from the file without them.
+ */
+static shared_ptr<FlightSeats> emptySeats(const Flight& flight, const map<string, Aircraft>* fleet)
+{
+    auto seats = make_shared<FlightSeats>();
+    bool found = fleet ? Aircraft::findCabinLayout(*fleet, flight.getAircraftType(), seats->layout)
+                       : Aircraft::findCabinLayout(flight.getAircraftType(), seats->layout);
+    if (found)
+        seats->layout.limitSeats(flight.getTotalSeats());
+    else
+        seats->layout = CabinLayout::standard(flight.getTotalSeats());
+    seats->occupied.assign(seats->layout.rowCount(), 0);
+    return seats;
+}
+
+/**
+ * Marks a seat taken; seats the layout does not have are ignored.
+ */
+static void markTaken(FlightSeats& seats, const string& seatLabel)
+{
+    int row, column;
+    if (seats.layout.parseSeat(seatLabel, row, column))
+        seats.occupied[row] |= uint64_t(1) << column;
+}
+
+/**
+ * Builds a flight's map, with the seats of live reservations marked taken.
+ */
+static shared_ptr<FlightSeats> buildSeats(const Flight& flight)
+{
+    auto seats = emptySeats(flight, nullptr);
+    for (auto const& res : Reservation::loadReservations())
+        if (res->getFlight()->getFlightNumber() == flight.getFlightNumber())
+            markTaken(*seats, res->getSeatNumber());
+    return seats;
+}
+
+/**
+ * Publishes a freshly built map unless one was published meanwhile, first marking the
+ * seats a dropped map of the flight held: claims not on file yet survive the rebuild.
+ * Caller holds seatMapsMutex exclusively.
+ */
+static shared_ptr<FlightSeats>& publish(const string& flightNumber, shared_ptr<FlightSeats>& built)
+{
+    auto& slot = seatMaps[flightNumber];
+    if (slot)
+        return slot;
+
+    auto carried = carriedSeats.find(flightNumber);
+    if (carried != carriedSeats.end())
+    {
+        for (auto const& label : carried->second)
+            markTaken(*built, label);
+        carriedSeats.erase(carried);
+    }
+    slot = move(built);
+    return slot;
+}
+
+/**
+ * Returns the flight's map, building it on first use. Callers hold a reference, so an
+ * invalidate() meanwhile only detaches the map rather than freeing it under them.
+ */
+static shared_ptr<FlightSeats> seatsOf(const Flight& flight)
+{
+    {
+        shared_lock<shared_mutex> lock(seatMapsMutex);
+        auto it = seatMaps.find(flight.getFlightNumber());
+        if (it != seatMaps.end())
+            return it->second;
+    }
+
+    auto built = buildSeats(flight);
+    unique_lock<shared_mutex> lock(seatMapsMutex);
+    return publish(flight.getFlightNumber(), built);
+}
+
+/**
+ * Returns the flight's map with its lock held, retrying if the map was retired between
+ * the lookup and the lock.
+ */
+static shared_ptr<FlightSeats> lockSeatsOf(const Flight& flight, unique_lock<mutex>& guard)
+{
+    for (;;)
+    {
+        auto held = seatsOf(flight);
+        guard = unique_lock<mutex>(held->lock);
+        if (!held->retired)
+            return held;
+        guard.unlock();
+    }
+}
+
+/**
+ * Finds the first row holding `count` adjacent free seats. A free bit survives
+ * `free & (free >> 1) & ... & (free >> count-1)` only if the next count-1 columns are free
+ * too, so the lowest surviving bit starts the block. Caller holds seats.lock.
+ */
+static bool findRun(const FlightSeats& seats, int count, int& row, int& column)
+{
+    if (count < 1 || count > MAX_ROW_COLUMNS)
+        return false;
+
+    for (int r = 0; r < seats.layout.rowCount(); ++r)
+    {
+        uint64_t free = seats.layout.seatMask(r) & ~seats.occupied[r];
+        uint64_t run  = free;
+        for (int k = 1; k < count && run; ++k)
+            run &= free >> k;
+
+        if (run)
+        {
+            row    = r;
+            column = __builtin_ctzll(run);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * First row with a free window bit; caller holds seats.lock.
+ */
+static bool findWindow(const FlightSeats& seats, int& row, int& column)
+{
+    for (int r = 0; r < seats.layout.rowCount(); ++r)
+    {
+        uint64_t free = seats.layout.windowMask(r) & ~seats.occupied[r];
+        if (free)
+        {
+            row    = r;
+            column = __builtin_ctzll(free);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Resolves the request to a seat and sets its bit if it is free.
+ */
+bool SeatMap::claimSeat(const Flight& flight, const string& request, string& seatLabel)
+{
+    TRACE_SPAN("SeatMap::claimSeat");
+    unique_lock<mutex> guard;
+    auto held = lockSeatsOf(flight, guard);
+    FlightSeats& seats = *held;
+
+    int row, column;
+    if (request == WINDOW_SEAT_REQUEST)
+    {
+        if (!findWindow(seats, row, column))
+        {
+            cout << "No window seats left on flight " << flight.getFlightNumber() << ".\n";
+            return false;
+        }
+    }
+    else if (!seats.layout.parseSeat(request, row, column))
+    {
+        cout << "Invalid seat " << request << " for flight " << flight.getFlightNumber()
+             << " (" << seats.layout.rowCount() << " rows).\n";
+        return false;
+    }
+
+    uint64_t bit = uint64_t(1) << column;
+    if (seats.occupied[row] & bit)
+    {
+        cout << "Seat " << seats.layout.seatLabel(row, column)
+             << " already reserved. Choose another.\n";
+        return false;
+    }
+
+    seats.occupied[row] |= bit;
+    seatLabel = seats.layout.seatLabel(row, column);
+    return true;
+}
+
+/**
+ * Finds and claims a block atomically under the flight's lock.
+ */
+bool SeatMap::claimAdjacentSeats(const Flight& flight, int count, vector<string>& seatLabels)
+{
+    TRACE_SPAN("SeatMap::claimAdjacentSeats");
+    unique_lock<mutex> guard;
+    auto held = lockSeatsOf(flight, guard);
+    FlightSeats& seats = *held;
+
+    int row, column;
+    if (!findRun(seats, count, row, column))
+        return false;
+
+    seatLabels.clear();
+    for (int k = 0; k < count; ++k)
+    {
+        seats.occupied[row] |= uint64_t(1) << (column + k);
+        seatLabels.push_back(seats.layout.seatLabel(row, column + k));
+    }
+    return true;
+}
+
+/**
+ * Greedy block seating under one hold of the flight's lock: take the widest run that
+ * still fits the rest of the party, narrowing only when no row has one. Every bit set
+ * is recorded so a shortfall can be rolled back before the lock is dropped.
+ */
+bool SeatMap::claimGroupSeats(const Flight& flight, int count, vector<string>& seatLabels)
+{
+    TRACE_SPAN("SeatMap::claimGroupSeats");
+    if (count < 1)
+        return false;
+
+    unique_lock<mutex> guard;
+    auto held = lockSeatsOf(flight, guard);
+    FlightSeats& seats = *held;
+
+    vector<pair<int, int>> taken;
+    int width = min(count, MAX_ROW_COLUMNS);
+    while (count - static_cast<int>(taken.size()) > 0 && width > 0)
+    {
+        int row, column;
+        if (!findRun(seats, width, row, column))
+        {
+            --width;
+            continue;
+        }
+
+        for (int k = 0; k < width; ++k)
+        {
+            seats.occupied[row] |= uint64_t(1) << (column + k);
+            taken.emplace_back(row, column + k);
+        }
+        width = min(width, count - static_cast<int>(taken.size()));
+    }
+
+    if (static_cast<int>(taken.size()) < count)
+    {
+        for (auto const& seat : taken)
+            seats.occupied[seat.first] &= ~(uint64_t(1) << seat.second);
+        return false;
+    }
+
+    seatLabels.clear();
+    for (auto const& seat : taken)
+        seatLabels.push_back(seats.layout.seatLabel(seat.first, seat.second));
+    return true;
+}
+
+/**
+ * Clears the bit of a seat on a flight whose map is loaded. Without a map the seat is
+ * only dropped from those carried over from a dropped map; the files already show the
+ * release to the next build.
+ */
+void SeatMap::releaseSeat(const string& flightNumber, const string& seatLabel)
+{
+    for (;;)
+    {
+        shared_ptr<FlightSeats> held;
+        {
+            shared_lock<shared_mutex> lock(seatMapsMutex);
+            auto it = seatMaps.find(flightNumber);
+            if (it != seatMaps.end())
+                held = it->second;
+        }
+
+        if (!held)
+        {
+            unique_lock<shared_mutex> lock(seatMapsMutex);
+            if (seatMaps.count(flightNumber))
+                continue;
+            auto carried = carriedSeats.find(flightNumber);
+            if (carried != carriedSeats.end())
+            {
+                auto& labels = carried->second;
+                labels.erase(remove(labels.begin(), labels.end(), seatLabel), labels.end());
+            }
+            return;
+        }
+
+        lock_guard<mutex> guard(held->lock);
+        if (held->retired)
+            continue;
+        int row, column;
+        if (held->layout.parseSeat(seatLabel, row, column))
+            held->occupied[row] &= ~(uint64_t(1) << column);
+        return;
+    }
+}
+
+/**
+ * Read-only variant of claimAdjacentSeats.
+ */
+bool SeatMap::findAdjacentSeats(const Flight& flight, int count, vector<string>& seatLabels)
+{
+    unique_lock<mutex> guard;
+    auto held = lockSeatsOf(flight, guard);
+    FlightSeats& seats = *held;
+
+    int row, column;
+    if (!findRun(seats, count, row, column))
+        return false;
+
+    seatLabels.clear();
+    for (int k = 0; k < count; ++k)
+        seatLabels.push_back(seats.layout.seatLabel(row, column + k));
+    return true;
+}
+
+/**
+ * Read-only window seat lookup.
+ */
+bool SeatMap::firstFreeWindowSeat(const Flight& flight, string& seatLabel)
+{
+    unique_lock<mutex> guard;
+    auto held = lockSeatsOf(flight, guard);
+    FlightSeats& seats = *held;
+
+    int row, column;
+    if (!findWindow(seats, row, column))
+        return false;
+    seatLabel = seats.layout.seatLabel(row, column);
+    return true;
+}
+
+/**
+ * Retires one flight's map under its lock and keeps the labels of every seat it held,
+ * claimed-but-unsaved ones included, for the rebuild to mark again; seats the files
+ * also show are simply marked twice.
+ */
+void SeatMap::invalidate(const string& flightNumber)
+{
+    shared_ptr<FlightSeats> held;
+    {
+        shared_lock<shared_mutex> lock(seatMapsMutex);
+        auto it = seatMaps.find(flightNumber);
+        if (it == seatMaps.end())
+            return;
+        held = it->second;
+    }
+
+    lock_guard<mutex> guard(held->lock);
+    if (held->retired)
+        return;
+
+    vector<string> labels;
+    for (int r = 0; r < held->layout.rowCount(); ++r)
+        for (uint64_t bits = held->occupied[r]; bits; bits &= bits - 1)
+            labels.push_back(held->layout.seatLabel(r, __builtin_ctzll(bits)));
+    held->retired = true;
+
+    unique_lock<shared_mutex> lock(seatMapsMutex);
+    auto it = seatMaps.find(flightNumber);
+    if (it != seatMaps.end() && it->second == held)
+        seatMaps.erase(it);
+    auto& carried = carriedSeats[flightNumber];
+    carried.insert(carried.end(), labels.begin(), labels.end());
+}
+
+/**
+ * Drops every map, one flight at a time so each keeps its seats.
+ */
+void SeatMap::reset(void)
+{
+    vector<string> flights;
+    {
+        shared_lock<shared_mutex> lock(seatMapsMutex);
+        for (auto const& entry : seatMaps)
+            flights.push_back(entry.first);
+    }
+    for (auto const& flightNumber : flights)
+        invalidate(flightNumber);
+}
+
+/**
+ * Reservations are grouped by flight; each worker then builds a contiguous range of the
+ * schedule's rows. The maps are published under one exclusive lock at the end.
+ */
+void SeatMap::prebuild(const vector<shared_ptr<Reservation>>& reservations,
+                       const map<string, Aircraft>& fleet, ThreadPool& pool)
+{
+    TRACE_SPAN("SeatMap::prebuild");
+    auto   table = FlightRegistry::table();
+    size_t rows  = table->size();
+    if (rows == 0)
+        return;
+
+    unordered_map<string, vector<const Reservation*>> byFlight;
+    for (auto const& res : reservations)
+        byFlight[res->getFlight()->getFlightNumber()].push_back(res.get());
+
+    vector<shared_ptr<FlightSeats>> built(rows);
+    vector<function<void()>>        tasks;
+    size_t parts = min(pool.size(), rows);
+    for (size_t p = 0; p < parts; ++p)
+    {
+        size_t first = rows * p / parts, last = rows * (p + 1) / parts;
+        tasks.push_back([&table, &fleet, &byFlight, &built, first, last]()
+        {
+            for (size_t r = first; r < last; ++r)
+            {
+                Flight flight = table->row(r);
+                auto   seats  = emptySeats(flight, &fleet);
+                auto   it     = byFlight.find(flight.getFlightNumber());
+                if (it != byFlight.end())
+                    for (const Reservation* res : it->second)
+                        markTaken(*seats, res->getSeatNumber());
+                built[r] = move(seats);
+            }
+        });
+    }
+    pool.runAll(move(tasks));
+
+    unique_lock<shared_mutex> lock(seatMapsMutex);
+    for (size_t r = 0; r < rows; ++r)
+        publish(table->getFlightNumber(r), built[r]);
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
@@ -0,0 +1,89 @@
+/******************************************************************************************
+ * MODULE NAME    : Startup Loader Module
+ * FILE           : StartupLoader.cpp
+ * DESCRIPTION    : Implements the two-phase parallel load of the data files and the
+ *                  indexes built from them.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/StartupLoader.hpp"
+#include "../header/Aircraft.hpp"
+#include "../header/FlightRegistry.hpp"
+#include "../header/Metrics.hpp"
+#include "../header/SalesLedger.hpp"
+#include "../header/SeatHold.hpp"
+#include "../header/SeatInventory.hpp"
+#include "../header/SeatMap.hpp"
+#include "../header/ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <thread>
+
+using namespace std;
+
+/**
+ * Milliseconds since a start point.
+ */
+static int64_t millisecondsSince(chrono::steady_clock::time_point started)
+{
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - started).count();
+}
+
+/**
+ * The small files are queued first and the reservation split is queued behind them, so
+ * workers that finish a small file move straight on to a slice of reservations; the
+ * calling thread only waits. The pool is drained between the phases because the indexes
+ * read what the first phase loaded, and again before the hold ticker starts because
+ * the inventory, the ledger and the seat maps drop releases made before they are seeded.
+ */
+StartupData StartupLoader::run(size_t workers)
+{
+    METRIC_SCOPE("StartupLoader::run");
+    if (workers == 0)
+        workers = max<size_t>(thread::hardware_concurrency(), 1);
+
+    StartupData           data;
+    map<string, Aircraft> fleet;
+    ThreadPool            pool(workers);
+    data.workers = pool.size();
+
+    auto started = chrono::steady_clock::now();
+    pool.submit([]()
+    {
+        METRIC_SCOPE("StartupLoader::flights");
+        FlightRegistry::table();
+        FlightRegistry::routes();
+    });
+    pool.submit([&fleet]()
+    {
+        METRIC_SCOPE("StartupLoader::aircraft");
+        Aircraft::loadAircraftData(PATH_OF_AIR_CRAFT_DATA_BASE, fleet);
+    });
+    data.reservations = Reservation::loadReservations(pool);
+    pool.wait();
+    data.loadMs = millisecondsSince(started);
+
+    started = chrono::steady_clock::now();
+    pool.submit([&data]()
+    {
+        SeatInventory::seed(data.reservations);
+    });
+    pool.submit([&data]()
+    {
+        SalesLedger::seed(data.reservations);
+    });
+    SeatMap::prebuild(data.reservations, fleet, pool);
+    pool.wait();
+
+    // The ticker releases lapsed holds into the indexes, so it starts after they exist
+    SeatHold::start(data.reservations);
+    data.indexMs = millisecondsSince(started);
+
+    return data;
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
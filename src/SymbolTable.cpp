@@ -0,0 +1,94 @@
+/******************************************************************************************
+ * MODULE NAME    : Symbol Table Module
+ * FILE           : SymbolTable.cpp
+ * DESCRIPTION    : Implements the SymbolTable string interner.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/SymbolTable.hpp"
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+
+using namespace std;
+
+/**
+ * Interned strings live in a deque so growth never moves them; the index keys view into it.
+ */
+struct SymbolStore
+{
+    deque<string>                                  names;
+    unordered_map<string_view, SymbolTable::Symbol> index;
+    shared_mutex                                   mutex;
+};
+
+/**
+ * Returns the table's storage, constructed on first use so interning from other
+ * translation units' static initialisers is safe.
+ */
+static SymbolStore& store(void)
+{
+    static SymbolStore instance;
+    return instance;
+}
+
+/**
+ * Returns the ID for text, adding it to the table if it is new.
+ */
+SymbolTable::Symbol SymbolTable::intern(string_view text)
+{
+    SymbolStore& st = store();
+    {
+        shared_lock<shared_mutex> lock(st.mutex);
+        auto it = st.index.find(text);
+        if (it != st.index.end())
+            return it->second;
+    }
+
+    unique_lock<shared_mutex> lock(st.mutex);
+    auto it = st.index.find(text);
+    if (it != st.index.end())
+        return it->second;
+
+    Symbol id = static_cast<Symbol>(st.names.size());
+    st.names.emplace_back(text);
+    st.index.emplace(st.names.back(), id);
+    return id;
+}
+
+/**
+ * Looks up an ID without interning.
+ */
+SymbolTable::Symbol SymbolTable::find(string_view text)
+{
+    SymbolStore& st = store();
+    shared_lock<shared_mutex> lock(st.mutex);
+    auto it = st.index.find(text);
+    return it != st.index.end() ? it->second : INVALID_SYMBOL;
+}
+
+/**
+ * Returns the interned string for an ID.
+ */
+const string& SymbolTable::name(Symbol id)
+{
+    SymbolStore& st = store();
+    shared_lock<shared_mutex> lock(st.mutex);
+    return st.names.at(id);
+}
+
+/**
+ * Returns the number of interned strings.
+ */
+size_t SymbolTable::size(void)
+{
+    SymbolStore& st = store();
+    shared_lock<shared_mutex> lock(st.mutex);
+    return st.names.size();
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
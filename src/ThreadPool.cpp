@@ -0,0 +1,170 @@
+/******************************************************************************************
+ * MODULE NAME    : Thread Pool Module
+ * FILE           : ThreadPool.cpp
+ * DESCRIPTION    : Implements the fixed-size worker pool.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/ThreadPool.hpp"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+/**
+ * Constructor: Spawns the workers.
+ */
+ThreadPool::ThreadPool(size_t workerCount)
+    : running(0), stopping(false)
+{
+    size_t count = max<size_t>(workerCount, 1);
+    workers.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+/**
+ * Destructor: Stops accepting work, lets the queue drain and joins.
+ */
+ThreadPool::~ThreadPool(void)
+{
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+/**
+ * Appends a task and wakes one worker.
+ */
+bool ThreadPool::submit(function<void()> task)
+{
+    {
+        lock_guard<mutex> lock(queueMutex);
+        if (stopping)
+            return false;
+        tasks.push_back(move(task));
+    }
+    taskReady.notify_one();
+    return true;
+}
+
+/**
+ * Waits for the pool to go idle.
+ */
+void ThreadPool::wait(void)
+{
+    unique_lock<mutex> lock(queueMutex);
+    allIdle.wait(lock, [this] { return tasks.empty() && running == 0; });
+}
+
+/**
+ * Each task is wrapped to count itself off a shared latch and keep the first error; a
+ * task the pool no longer accepts runs on the calling thread instead.
+ */
+void ThreadPool::runAll(vector<function<void()>> batch)
+{
+    struct Latch
+    {
+        mutex              latchMutex;
+        condition_variable finished;
+        size_t             remaining = 0;
+        exception_ptr      error;
+    };
+    auto latch = make_shared<Latch>();
+    latch->remaining = batch.size();
+
+    for (auto& task : batch)
+    {
+        function<void()> job = [latch, task = move(task)]()
+        {
+            exception_ptr error;
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                error = current_exception();
+            }
+
+            lock_guard<mutex> lock(latch->latchMutex);
+            if (error && !latch->error)
+                latch->error = error;
+            if (--latch->remaining == 0)
+                latch->finished.notify_all();
+        };
+        if (!submit(job))
+            job();
+    }
+
+    unique_lock<mutex> lock(latch->latchMutex);
+    latch->finished.wait(lock, [&latch] { return latch->remaining == 0; });
+    if (latch->error)
+        rethrow_exception(latch->error);
+}
+
+/**
+ * Getter: worker count.
+ */
+size_t ThreadPool::size(void) const
+{
+    return workers.size();
+}
+
+/**
+ * Getter: queued plus running tasks.
+ */
+size_t ThreadPool::pending(void) const
+{
+    lock_guard<mutex> lock(queueMutex);
+    return tasks.size() + running;
+}
+
+/**
+ * Runs each task outside the lock; exits only once stopping and the queue is empty.
+ * A task that throws is reported and does not take its worker down.
+ */
+void ThreadPool::workerLoop(void)
+{
+    while (true)
+    {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            taskReady.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+                return;
+
+            task = move(tasks.front());
+            tasks.pop_front();
+            ++running;
+        }
+
+        try
+        {
+            task();
+        }
+        catch (const exception& e)
+        {
+            cerr << "Error: Background task failed: " << e.what() << '\n';
+        }
+
+        {
+            lock_guard<mutex> lock(queueMutex);
+            --running;
+            if (tasks.empty() && running == 0)
+                allIdle.notify_all();
+        }
+    }
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
@@ -0,0 +1,150 @@
+/******************************************************************************************
+ * MODULE NAME    : Tracer Module
+ * FILE           : Tracer.cpp
+ * DESCRIPTION    : Implements the per-thread span rings and the Chrome trace writer.
+ * AUTHOR         : Hassan Darwish
+ * DATE CREATED   : May 2025
+ ******************************************************************************************/
+
+#include "../header/Tracer.hpp"
+#include "../header/json.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+using json = nlohmann::json;
+
+/**
+ * One thread's spans. Only the owning thread writes; `written` is published with release
+ * ordering so a flush sees every slot up to it.
+ */
+struct TraceRing
+{
+    TraceEvent       events[TRACE_RING_CAPACITY];
+    atomic<uint64_t> written{0};
+    uint32_t         threadID = 0;
+};
+
+atomic<bool> Tracer::recording{false};
+
+static const chrono::steady_clock::time_point traceEpoch = chrono::steady_clock::now();
+static vector<unique_ptr<TraceRing>>          traceRings;   // Kept until exit
+static mutex                                  ringsMutex;
+static thread_local TraceRing*                threadRing = nullptr;
+
+/**
+ * Flushes to the configured path when the process exits.
+ */
+struct TraceFlusher
+{
+    string path;
+    ~TraceFlusher() { if (!path.empty()) Tracer::flush(path); }
+};
+static TraceFlusher traceFlusher;
+
+/**
+ * Registers the calling thread's ring on its first span; the only locked step.
+ */
+static TraceRing& ringOfThisThread(void)
+{
+    if (!threadRing)
+    {
+        lock_guard<mutex> lock(ringsMutex);
+        traceRings.push_back(make_unique<TraceRing>());
+        threadRing           = traceRings.back().get();
+        threadRing->threadID = static_cast<uint32_t>(traceRings.size());
+    }
+    return *threadRing;
+}
+
+/**
+ * Flips the run-time switch.
+ */
+void Tracer::setEnabled(bool on)
+{
+    recording.store(on, memory_order_relaxed);
+}
+
+/**
+ * Offset by one so a span start is never 0, which TraceSpan uses for "not recording".
+ */
+uint64_t Tracer::now(void)
+{
+    auto since = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - traceEpoch);
+    return static_cast<uint64_t>(since.count()) + 1;
+}
+
+/**
+ * Overwrites the oldest slot once the ring is full.
+ */
+void Tracer::record(const char* name, uint64_t startNs, uint64_t durationNs)
+{
+    TraceRing& ring = ringOfThisThread();
+    uint64_t   slot = ring.written.load(memory_order_relaxed);
+    ring.events[slot % TRACE_RING_CAPACITY] = { name, startNs, durationNs };
+    ring.written.store(slot + 1, memory_order_release);
+}
+
+/**
+ * Writes the JSON object format, one event per line, with timestamps in microseconds
+ * as the format expects; each ring becomes one thread row in the viewer.
+ */
+bool Tracer::flush(const string& path)
+{
+    ofstream out(path);
+    if (!out.is_open())
+    {
+        cerr << "Error: Unable to write trace to " << path << ".\n";
+        return false;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto emit = [&](const json& event) {
+        out << (first ? "" : ",\n") << event.dump();
+        first = false;
+    };
+
+    lock_guard<mutex> lock(ringsMutex);
+    for (auto const& ring : traceRings)
+    {
+        emit({ {"ph", "M"}, {"name", "thread_name"}, {"pid", 1}, {"tid", ring->threadID},
+               {"args", { {"name", ring->threadID == 1 ? "main" : "thread " + to_string(ring->threadID)} }} });
+
+        uint64_t written = ring->written.load(memory_order_acquire);
+        uint64_t oldest  = written > TRACE_RING_CAPACITY ? written - TRACE_RING_CAPACITY : 0;
+        for (uint64_t i = oldest; i < written; ++i)
+        {
+            const TraceEvent& e = ring->events[i % TRACE_RING_CAPACITY];
+            emit({ {"ph", "X"}, {"name", e.name}, {"cat", "airline"}, {"pid", 1},
+                   {"tid", ring->threadID}, {"ts", e.startNs / 1000.0}, {"dur", e.durationNs / 1000.0} });
+        }
+    }
+
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+/**
+ * Reads the environment once at startup; called from main, whose ring is registered
+ * first so it shows up as the "main" row.
+ */
+void Tracer::configureFromEnvironment(void)
+{
+    const char* path = getenv(TRACE_ENVIRONMENT_VARIABLE);
+    if (!path || !*path)
+        return;
+
+    ringOfThisThread();
+    traceFlusher.path = path;
+    setEnabled(true);
+}
+
+/******************************************************************************************
+ * END OF FILE
+ ******************************************************************************************/
@@ -18,16 +18,16 @@
 User::User(std::string username,
            std::string password,
            std::string role)
-    : username(username),
-      password(password),
-      role(role)
+    : username(std::move(username)),
+      password(std::move(password)),
+      role(std::move(role))
 {}
 
 /**
  * Getter: Returns the username.
  * @return Stored username.
  */
-std::string User::getUsername(void) const
+const std::string& User::getUsername(void) const
 {
     return username;
 }
@@ -36,7 +36,7 @@ std::string User::getUsername(void) const
  * Getter: Returns the user role.
  * @return Stored role.
  */
-std::string User::getRole(void) const
+const std::string& User::getRole(void) const
 {
     return role;
 }
@@ -11,12 +11,20 @@
 #include <iostream>        // Console I/O
 #include <fstream>         // File streams for JSON persistence
 #include <iomanip>         // setw for JSON formatting
-#include <cstdlib>         // srand, rand
-#include <ctime>           // time
+#include <cstdlib>         // strtoul
 #include "../header/json.hpp"
 #include "../header/Administrator.hpp"
 #include "../header/Passenger.hpp"
 #include "../header/BookingAgent.hpp"
+#include "../header/SeatHold.hpp"
+#include "../header/StartupLoader.hpp"
+#include "../header/PaymentPipeline.hpp"
+#include "../header/CommandRunner.hpp"
+#include "../header/ReportEngine.hpp"
+#include "../header/Metrics.hpp"
+#include "../header/Tracer.hpp"
+#include "../header/MemoryAccounting.hpp"
+#include "../header/PaymentStress.hpp"
 
 using namespace std;
 using json = nlohmann::json;
@@ -99,14 +107,91 @@ string getMaskedPassword(void)
     return password;
 }
 
+/**
+ * Settles the queued card charges and stops the hold ticker; every exit taken after
+ * the startup load goes through here.
+ */
+static void stopBackgroundWork()
+{
+    PaymentPipeline::stop();
+    SeatHold::stop();
+}
+
 /**
  * Main function: prompts role selection, handles login/registration,
- * and dispatches to the appropriate user menu.
+ * and dispatches to the appropriate user menu. With --exec <file> it
+ * runs the file's JSON-line commands instead and exits with their status;
+ * with --report <grouping> [format] it prints a grouped sales report;
+ * with --memory-report it prints the memory cost of each data set;
+ * with --stress-payments it checks that retried payments settle once.
  */
-int main(void)
+int main(int argc, char* argv[])
 {
-    srand(static_cast<unsigned>(time(nullptr)));
+    // AIRLINE_METRICS=<file> turns on latency instrumentation and dumps it at exit
+    Metrics::configureFromEnvironment();
+
+    // AIRLINE_TRACE=<file> records spans and writes them as a Chrome trace at exit
+    Tracer::configureFromEnvironment();
+
+    // Reports what each data set costs in memory once loaded (needs MEMORY_ACCOUNTING=1)
+    if (argc > 1 && string(argv[1]) == "--memory-report")
+    {
+        cout << setw(4) << MemoryAccounting::profileLoads() << endl;
+        return 0;
+    }
+
+    // Races retried confirmations and charges on a scratch copy of the data files
+    if (argc > 1 && string(argv[1]) == "--stress-payments")
+    {
+        size_t sizes[3] = { PAYMENT_STRESS_RESERVATIONS, PAYMENT_STRESS_THREADS, PAYMENT_STRESS_RETRIES };
+        for (int i = 2; i < argc && i < 5; ++i)
+            sizes[i - 2] = strtoul(argv[i], nullptr, 10);
+        json report = PaymentStress::run(sizes[0], sizes[1], sizes[2]);
+        cout << setw(4) << report << endl;
+        return report.value("passed", false) ? COMMAND_EXIT_OK : COMMAND_EXIT_FAILURES;
+    }
+
+    // Prints bookings and revenue grouped by flight, route, month, aircraft or channel
+    if (argc > 1 && string(argv[1]) == "--report")
+    {
+        ReportGrouping grouping;
+        ReportFormat   format = ReportFormat::Console;
+        if (argc < 3 || argc > 4 || !ReportEngine::parseGrouping(argv[2], grouping) ||
+            (argc == 4 && !ReportEngine::parseFormat(argv[3], format)))
+        {
+            cerr << "Usage: " << argv[0]
+                 << " --report <flight|route|month|aircraft|channel> [console|csv|json]\n";
+            return COMMAND_EXIT_BAD_INPUT;
+        }
+        ReportEngine::write(ReportEngine::group(ReportEngine::aggregate(), grouping), grouping, format, cout);
+        return 0;
+    }
+
+    const bool execMode = argc > 1 && string(argv[1]) == "--exec";
+    if (execMode && argc != 3)
+    {
+        cerr << "Usage: " << argv[0] << " --exec <commands.jsonl | ->\n";
+        return COMMAND_EXIT_BAD_INPUT;
+    }
+
+    // Load the data files and build the indexes in parallel; this also starts the
+    // background expiry of lapsed cash holds for the whole session
+    StartupData startup = StartupLoader::run();
+
+    // Card charges are settled by background workers so bookings never wait on them;
+    // AIRLINE_GATEWAY_SEED=<n> picks which charges the mock gateway declines
+    PaymentPipeline::start(make_shared<MockPaymentGateway>(MOCK_GATEWAY_LATENCY_MS,
+                                                           MOCK_GATEWAY_DECLINE_RATE,
+                                                           PaymentPipeline::mockGatewaySeed()));
+
+    if (execMode)
+    {
+        int status = CommandRunner::runFile(argv[2], &startup);
+        stopBackgroundWork();
+        return status;
+    }
 
+    // The passenger and agent menus start from the reservations loaded above
     cout << "\t\t\t  Welcome to Airline Reservation and Management System\n\n"
          << "Please select your role:\n"
          << "1. Administrator\n"
@@ -124,6 +209,7 @@ int main(void)
         case 3: role = "Passenger";      break;
         default:
             cout << "Invalid choice.\n";
+            stopBackgroundWork();
             return 0;
     }
 
@@ -149,11 +235,11 @@ int main(void)
                 admin.displayMenu();
             }
             else if (role == "Passenger") {
-                Passenger passenger(username, password);
+                Passenger passenger(username, password, move(startup.reservations));
                 passenger.displayMenu();
             }
             else {  // Booking Agent
-                BookingAgent agent(username, password);
+                BookingAgent agent(username, password, move(startup.reservations));
                 agent.displayMenu();
             }
         }
@@ -175,15 +261,18 @@ int main(void)
             admin.displayMenu();
         }
         else if (role == "Passenger") {
-            Passenger passenger(username, password);
+            Passenger passenger(username, password, move(startup.reservations));
             passenger.displayMenu();
         }
         else {  // Booking Agent
-            BookingAgent agent(username, password);
+            BookingAgent agent(username, password, move(startup.reservations));
             agent.displayMenu();
         }
     }
 
+    // Settle queued charges while holds can still be cleared, then report how they went
+    stopBackgroundWork();
+    Payment::printNotices();
     return 0;
 }
 